@@ -0,0 +1,159 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/*!
+ * \brief Coroutine returning \p T, resumed on the executor it was spawned on.
+ * \details Request handlers are coroutines of this type. Inside one, a game operation, a database
+ * call or a timer is awaited with `co_await` and the I/O thread serves other connections meanwhile:
+ *   - AwaitOn() runs a function on another executor (a game shard, the database pool) and
+ *     resumes the coroutine with its result or exception;
+ *   - AwaitCallback() waits for a one-shot callback with a timeout;
+ *   - timers are awaited directly: `co_await timer.async_wait(boost::asio::use_awaitable)`.
+ */
+template <typename T = void>
+using Task = boost::asio::awaitable<T>;
+
+namespace async_detail {
+
+/*! \brief Completion signature of an AwaitOn() operation producing \p Result. */
+template <typename Result>
+struct Completion {
+    using Signature = void(std::exception_ptr, Result);
+};
+
+template <>
+struct Completion<void> {
+    using Signature = void(std::exception_ptr);
+};
+
+}
+
+/*!
+ * \brief Runs \p fn elsewhere and resumes the awaiting coroutine with its result.
+ * \details \p schedule receives a nullary callable and must arrange for it to run once, on any
+ * thread. The coroutine is resumed on its own executor; an exception thrown by \p fn is rethrown
+ * from `co_await`.
+ * \param schedule Callable taking `std::function<void()>`, e.g. a post to a thread pool or a shard.
+ * \param fn Function producing the result; a non-void result must be default-constructible.
+ * \return Result of \p fn.
+ */
+template <typename Result, typename Schedule, typename F>
+Task<Result> AwaitOn(Schedule schedule, F fn) {
+    using Signature = typename async_detail::Completion<Result>::Signature;
+
+    auto initiation = [](auto handler, Schedule schedule, F fn) {
+        // отслеживаемый executor не даёт io_context остановиться, пока fn выполняется где-то ещё
+        auto executor = boost::asio::prefer(boost::asio::get_associated_executor(handler),
+                                            boost::asio::execution::outstanding_work.tracked);
+        auto shared = std::make_shared<decltype(handler)>(std::move(handler));
+
+        schedule(std::function<void()>([shared, executor, fn = std::move(fn)]() mutable {
+            std::exception_ptr error;
+            if constexpr (std::is_void_v<Result>) {
+                try {
+                    fn();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                boost::asio::post(executor, [shared, error]() { (*shared)(error); });
+            } else {
+                Result result{};
+                try {
+                    result = fn();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                boost::asio::post(executor, [shared, error, result = std::move(result)]() mutable {
+                    (*shared)(error, std::move(result));
+                });
+            }
+        }));
+    };
+
+    if constexpr (std::is_void_v<Result>) {
+        co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, Signature>(
+            initiation, boost::asio::use_awaitable, std::move(schedule), std::move(fn));
+    } else {
+        co_return co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, Signature>(
+            initiation, boost::asio::use_awaitable, std::move(schedule), std::move(fn));
+    }
+}
+
+/*!
+ * \brief Runs a blocking function on a thread pool and resumes the awaiting coroutine with its result.
+ * \param pool Pool the function runs on.
+ * \param fn Function producing the result.
+ */
+template <typename F>
+Task<std::invoke_result_t<F&>> RunBlocking(boost::asio::thread_pool& pool, F fn) {
+    return AwaitOn<std::invoke_result_t<F&>>(
+        [&pool](std::function<void()> work) { boost::asio::post(pool, std::move(work)); }, std::move(fn));
+}
+
+/*!
+ * \brief Waits for a one-shot callback, giving up after \p timeout.
+ * \details \p start is called immediately with a `deliver` function that may be called from any
+ * thread, any number of times; only the first call, or the timeout, resumes the coroutine.
+ * \param timeout Maximum time to wait.
+ * \param start Callable taking `std::function<void(T)>` that registers the callback.
+ * \return The delivered value, or std::nullopt on timeout.
+ */
+template <typename T, typename Start>
+Task<std::optional<T>> AwaitCallback(std::chrono::milliseconds timeout, Start start) {
+    auto initiation = [](auto handler, std::chrono::milliseconds timeout, Start start) {
+        using Handler = decltype(handler);
+
+        /*! \brief State shared by the callback and the timer. */
+        struct State {
+            explicit State(boost::asio::strand<boost::asio::any_io_executor> strand) : timer(strand) {}
+
+            std::atomic<bool> done{false};                    ///< Set by whichever completes first.
+            std::optional<Handler> handler;                   ///< Resumes the coroutine.
+            boost::asio::steady_timer timer;                  ///< Timeout; touched on its strand only.
+        };
+
+        auto executor = boost::asio::get_associated_executor(handler);
+        auto state = std::make_shared<State>(boost::asio::make_strand(executor));
+        state->handler.emplace(std::move(handler));
+
+        auto finish = [state, executor](std::optional<T> value) {
+            if (state->done.exchange(true)) {
+                return;
+            }
+            boost::asio::post(state->timer.get_executor(), [state]() { state->timer.cancel(); });
+            boost::asio::post(executor, [handler = std::move(*state->handler), value = std::move(value)]() mutable {
+                handler(std::move(value));
+            });
+        };
+
+        boost::asio::post(state->timer.get_executor(), [state, timeout, finish]() {
+            if (state->done.load()) {
+                return;
+            }
+            state->timer.expires_after(timeout);
+            state->timer.async_wait([finish](const boost::system::error_code& ec) {
+                if (!ec) {
+                    finish(std::nullopt);
+                }
+            });
+        });
+
+        start(std::function<void(T)>([finish](T value) { finish(std::move(value)); }));
+    };
+
+    co_return co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<>&, void(std::optional<T>)>(
+        initiation, boost::asio::use_awaitable, timeout, std::move(start));
+}
@@ -0,0 +1,253 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Engine_Benchmarks.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Empty_Cell.h"
+#include "Game_Arena.h"
+#include "Manager.h"
+#include "Rook_Cell.h"
+#include "Table.h"
+
+namespace {
+
+constexpr int kOpeningPlies = 8;          ///< The opening set holds plies 0..7 of every game.
+constexpr int kMiddlegameFirst = 20;      ///< First ply of the middlegame set.
+constexpr int kMiddlegameLast = 40;       ///< Last ply of the middlegame set.
+constexpr int kMiddlegameStep = 4;        ///< Plies between two middlegame positions of a game.
+constexpr std::uint32_t kGames = 8;       ///< Seeded games the positions are taken from.
+constexpr std::size_t kDoTurnBatch = 256; ///< Boards prepared for DoTurn per timing pause.
+
+struct Move {
+    std::size_t position;   ///< Index of the position in its set.
+    Coord from;             ///< Start square.
+    Coord to;               ///< Target square.
+};
+
+struct PositionSet {
+    std::string name;               ///< "opening" or "middlegame".
+    std::vector<Table> positions;   ///< Boards, each with the side to move set.
+};
+
+/*! \brief Text of a square in the notation of Manager::ConvertToCoord(). */
+std::string SquareName(Coord coord) {
+    return {static_cast<char>('a' + coord.col), static_cast<char>('0' + 8 - coord.row)};
+}
+
+/*!
+ * \brief Collects the moves reserved by the pieces of the side to move.
+ * \param legal_only Keep only moves CheckTurn() accepts.
+ * \details Moves are sorted, so the result does not depend on the order of std::unordered_set.
+ */
+std::vector<Move> CandidateMoves(const Table& table, std::size_t position, bool legal_only) {
+    std::vector<Move> moves;
+    const auto& board = table.getBoard();
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const auto& cell = board[row][col];
+            if (cell->Name() == EmptyName || cell->getColour() != table.GetCurrentTurn()) {
+                continue;
+            }
+            for (Coord to : cell->getReservedSteps()) {
+                if (!legal_only || table.CheckTurn({row, col}, to) == Table::TurnVerdict::correct) {
+                    moves.push_back({position, {row, col}, to});
+                }
+            }
+        }
+    }
+    std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+        return std::tie(a.from.row, a.from.col, a.to.row, a.to.col) <
+               std::tie(b.from.row, b.from.col, b.to.row, b.to.col);
+    });
+    return moves;
+}
+
+/*! \brief Collects candidate moves of every position of a set. */
+std::vector<Move> CandidateMoves(const PositionSet& set, bool legal_only) {
+    std::vector<Move> moves;
+    for (std::size_t i = 0; i < set.positions.size(); ++i) {
+        auto position_moves = CandidateMoves(set.positions[i], i, legal_only);
+        moves.insert(moves.end(), position_moves.begin(), position_moves.end());
+    }
+    return moves;
+}
+
+/*!
+ * \brief Plays seeded random games and samples positions from them.
+ * \details std::mt19937 gives the same sequence everywhere; moves are picked by its raw output
+ * rather than by a distribution, whose algorithm differs between standard libraries.
+ */
+std::vector<PositionSet> MakePositionSets() {
+    PositionSet opening{"opening", {}};
+    PositionSet middlegame{"middlegame", {}};
+    for (std::uint32_t seed = 1; seed <= kGames; ++seed) {
+        std::mt19937 random(seed);
+        Table table;
+        for (int ply = 0; ply <= kMiddlegameLast; ++ply) {
+            if (ply < kOpeningPlies) {
+                opening.positions.push_back(table);
+            } else if (ply >= kMiddlegameFirst && (ply - kMiddlegameFirst) % kMiddlegameStep == 0) {
+                middlegame.positions.push_back(table);
+            }
+            auto moves = CandidateMoves(table, 0, true);
+            if (moves.empty()) {
+                break;
+            }
+            const Move& move = moves[random() % moves.size()];
+            table.DoTurn(move.from, move.to);
+        }
+    }
+    return {std::move(opening), std::move(middlegame)};
+}
+
+/*! \brief Advances a cyclic index over a non-empty list. */
+std::size_t Next(std::size_t index, std::size_t size) {
+    return index + 1 == size ? 0 : index + 1;
+}
+
+void RegisterConstruction(BenchmarkRunner& runner) {
+    runner.Register("Table::Table/default resource", [](BenchmarkState& state) {
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            Table table;
+            DoNotOptimize(table);
+        }
+    });
+    runner.Register("Table::Table/GameArena", [](BenchmarkState& state) {
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            GameArena arena;
+            Table table(&arena);
+            DoNotOptimize(table);
+        }
+    });
+}
+
+void RegisterTableBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const PositionSet> set) {
+    // все ходы, зарезервированные фигурами: CheckTurn отвергает часть из них, как и на сервере
+    auto candidates = std::make_shared<std::vector<Move>>(CandidateMoves(*set, false));
+    runner.Register("Table::CheckTurn/" + set->name, [set, candidates](BenchmarkState& state) {
+        std::size_t next = 0;
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            const Move& move = (*candidates)[next];
+            DoNotOptimize(set->positions[move.position].CheckTurn(move.from, move.to));
+            next = Next(next, candidates->size());
+        }
+    });
+
+    auto legal = std::make_shared<std::vector<Move>>(CandidateMoves(*set, true));
+    runner.Register("Table::DoTurn/" + set->name, [set, legal](BenchmarkState& state) {
+        // DoTurn меняет доску, поэтому копии готовятся пачками вне замера
+        std::vector<Table> boards;
+        boards.reserve(kDoTurnBatch);
+        std::size_t next = 0;
+        for (std::uint64_t done = 0; done < state.Iterations();) {
+            std::size_t batch = std::min<std::uint64_t>(kDoTurnBatch, state.Iterations() - done);
+            state.PauseTiming();
+            boards.clear();
+            std::vector<const Move*> moves;
+            for (std::size_t k = 0; k < batch; ++k) {
+                moves.push_back(&(*legal)[next]);
+                boards.push_back(set->positions[moves.back()->position]);
+                next = Next(next, legal->size());
+            }
+            state.ResumeTiming();
+            for (std::size_t k = 0; k < batch; ++k) {
+                boards[k].DoTurn(moves[k]->from, moves[k]->to);
+            }
+            DoNotOptimize(boards);
+            done += batch;
+        }
+        state.PauseTiming();
+        boards.clear();
+    });
+
+    runner.Register("Table::GenerateBoardState/" + set->name, [set](BenchmarkState& state) {
+        std::size_t next = 0;
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(set->positions[next].GenerateBoardState());
+            next = Next(next, set->positions.size());
+        }
+    });
+
+    auto texts = std::make_shared<std::vector<std::string>>();
+    for (const Move& move : *legal) {
+        texts->push_back(SquareName(move.from) + " " + SquareName(move.to));
+    }
+    runner.Register("Manager::WordToCoord/" + set->name, [set, legal, texts](BenchmarkState& state) {
+        Manager manager;
+        std::size_t next = 0;
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            const auto& board = set->positions[(*legal)[next].position].getBoard();
+            DoNotOptimize(manager.WordToCoord(board, (*texts)[next]));
+            next = Next(next, texts->size());
+        }
+    });
+}
+
+void RegisterCellBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const PositionSet> set) {
+    struct King {
+        const Board* board;
+        const KingCell* king;
+    };
+    auto kings = std::make_shared<std::vector<King>>();
+    for (const Table& table : set->positions) {
+        for (const auto& line : table.getBoard()) {
+            for (const auto& cell : line) {
+                if (cell->Name() == KingName) {
+                    kings->push_back({&table.getBoard(), static_cast<const KingCell*>(cell.get())});
+                }
+            }
+        }
+    }
+    runner.Register("KingCell::IsCellUnderAttack/" + set->name, [kings](BenchmarkState& state) {
+        std::size_t next = 0;
+        for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+            const King& king = (*kings)[next];
+            DoNotOptimize(king.king->IsCellUnderAttack(*king.board));
+            next = Next(next, kings->size());
+        }
+    });
+
+    for (std::string_view name : {PawnName, KnightName, BishopName, RookName, QueenName, KingName, EmptyName}) {
+        // ячейки принадлежат доскам набора, который живёт в замыкании
+        auto cells = std::make_shared<std::vector<const Cell*>>();
+        for (const Table& table : set->positions) {
+            for (const auto& line : table.getBoard()) {
+                for (const auto& cell : line) {
+                    if (cell->Name() == name) {
+                        cells->push_back(cell.get());
+                    }
+                }
+            }
+        }
+        if (cells->empty()) {
+            continue;
+        }
+        std::string benchmark = std::string(name) + "Cell::getReservedSteps/" + set->name;
+        runner.Register(benchmark, [set, cells](BenchmarkState& state) {
+            std::size_t next = 0;
+            for (std::uint64_t i = 0; i < state.Iterations(); ++i) {
+                DoNotOptimize((*cells)[next]->getReservedSteps());
+                next = Next(next, cells->size());
+            }
+        });
+    }
+}
+
+}
+
+void RegisterEngineBenchmarks(BenchmarkRunner& runner) {
+    RegisterConstruction(runner);
+    for (auto& set : MakePositionSets()) {
+        auto shared = std::make_shared<const PositionSet>(std::move(set));
+        RegisterTableBenchmarks(runner, shared);
+        RegisterCellBenchmarks(runner, shared);
+    }
+}
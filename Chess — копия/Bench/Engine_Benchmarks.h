@@ -0,0 +1,16 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include "Micro_Benchmark.h"
+
+/*!
+ * \brief Registers the benchmarks of the rules engine.
+ * \details Covers Table construction, Table::CheckTurn, Table::DoTurn, Table::GenerateBoardState,
+ * KingCell::IsCellUnderAttack, getReservedSteps of every cell type and Manager::WordToCoord. Each of
+ * them except construction runs over two fixed position sets, "opening" and "middlegame", reached
+ * by seeded random games; the sets are the same on every run and platform.
+ */
+void RegisterEngineBenchmarks(BenchmarkRunner& runner);
@@ -0,0 +1,211 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Micro_Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <thread>
+
+namespace {
+
+constexpr std::uint64_t kMaxIterations = 1'000'000'000;   ///< Upper bound of operations in a run.
+constexpr double kMinTimeMargin = 1.4;                    ///< Aim a bit past the minimum time.
+constexpr double kMaxGrowth = 10;                         ///< Largest step between two runs.
+
+std::atomic<std::uint64_t> allocation_count{0};   ///< Calls of operator new.
+std::atomic<std::uint64_t> allocation_bytes{0};   ///< Bytes requested from operator new.
+
+void CountAllocation(std::size_t bytes) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/*! \brief Appends a JSON string literal; benchmark names need no escapes beyond quotes. */
+void WriteJsonString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+std::string FormatNumber(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", value);
+    return text;
+}
+
+}
+
+// глобальные new/delete бинарника бенчмарков: считают выделения, память берут у malloc.
+// Массивные и nothrow формы по стандарту вызывают эти функции
+void* operator new(std::size_t bytes) {
+    CountAllocation(bytes);
+    if (void* pointer = std::malloc(bytes == 0 ? 1 : bytes)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    CountAllocation(bytes);
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc требует размер, кратный выравниванию
+    std::size_t rounded = (std::max<std::size_t>(bytes, 1) + align - 1) / align * align;
+    if (void* pointer = std::aligned_alloc(align, rounded)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+AllocationCounts AllocationsSoFar() {
+    return {allocation_count.load(std::memory_order_relaxed), allocation_bytes.load(std::memory_order_relaxed)};
+}
+
+void BenchmarkState::PauseTiming() {
+    if (!running_) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    std::clock_t cpu_now = std::clock();
+    AllocationCounts allocations = AllocationsSoFar();
+    elapsed_ += now - started_;
+    cpu_seconds_ += static_cast<double>(cpu_now - cpu_started_) / CLOCKS_PER_SEC;
+    allocations_.count += allocations.count - allocations_started_.count;
+    allocations_.bytes += allocations.bytes - allocations_started_.bytes;
+    running_ = false;
+}
+
+void BenchmarkState::ResumeTiming() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    allocations_started_ = AllocationsSoFar();
+    cpu_started_ = std::clock();
+    started_ = std::chrono::steady_clock::now();
+}
+
+void BenchmarkRunner::Register(std::string name, Function function) {
+    benchmarks_.emplace_back(std::move(name), std::move(function));
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::Run(std::string_view filter, std::chrono::nanoseconds min_time,
+                                                  std::ostream* progress) const {
+    std::vector<BenchmarkResult> results;
+    for (const auto& [name, function] : benchmarks_) {
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (progress != nullptr) {
+            *progress << "… " << name << std::endl;
+        }
+        results.push_back(Measure(name, function, min_time));
+    }
+    return results;
+}
+
+BenchmarkResult BenchmarkRunner::Measure(const std::string& name, const Function& function,
+                                         std::chrono::nanoseconds min_time) {
+    std::uint64_t iterations = 1;
+    while (true) {
+        BenchmarkState state(iterations);
+        state.ResumeTiming();
+        function(state);
+        state.PauseTiming();
+
+        if (state.elapsed_ >= min_time || iterations >= kMaxIterations) {
+            auto ops = static_cast<double>(iterations);
+            BenchmarkResult result;
+            result.name = name;
+            result.iterations = iterations;
+            result.ns_per_op = static_cast<double>(state.elapsed_.count()) / ops;
+            result.cpu_ns_per_op = state.cpu_seconds_ * 1e9 / ops;
+            result.allocs_per_op = static_cast<double>(state.allocations_.count) / ops;
+            result.bytes_per_op = static_cast<double>(state.allocations_.bytes) / ops;
+            return result;
+        }
+
+        // как в Google Benchmark: по короткому прогону сразу прыгаем почти к нужному числу операций
+        double elapsed = std::max<double>(static_cast<double>(state.elapsed_.count()), 1);
+        double ratio = elapsed / static_cast<double>(min_time.count());
+        double growth = ratio > 0.1 ? std::min(kMinTimeMargin / ratio, kMaxGrowth) : kMaxGrowth;
+        auto next = static_cast<std::uint64_t>(static_cast<double>(iterations) * growth);
+        iterations = std::min(std::max(next, iterations + 1), kMaxIterations);
+    }
+}
+
+void BenchmarkRunner::PrintTable(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    std::size_t width = 9;
+    for (const auto& result : results) {
+        width = std::max(width, result.name.size());
+    }
+    out << std::left << std::setw(static_cast<int>(width)) << "benchmark" << std::right
+        << std::setw(13) << "iterations" << std::setw(12) << "ns/op" << std::setw(12) << "cpu ns/op"
+        << std::setw(12) << "allocs/op" << std::setw(12) << "bytes/op" << '\n';
+    out << std::fixed;
+    for (const auto& result : results) {
+        out << std::left << std::setw(static_cast<int>(width)) << result.name << std::right
+            << std::setw(13) << result.iterations << std::setprecision(1) << std::setw(12) << result.ns_per_op
+            << std::setw(12) << result.cpu_ns_per_op << std::setprecision(2) << std::setw(12)
+            << result.allocs_per_op << std::setprecision(1) << std::setw(12) << result.bytes_per_op << '\n';
+    }
+    out << std::defaultfloat;
+}
+
+void BenchmarkRunner::WriteJson(std::ostream& out, const std::vector<BenchmarkResult>& results,
+                                std::string_view executable) {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+#ifdef NDEBUG
+    const char* build_type = "release";
+#else
+    const char* build_type = "debug";
+#endif
+
+    out << "{\n  \"context\": {\n    \"date\": ";
+    WriteJsonString(out, date);
+    out << ",\n    \"executable\": ";
+    WriteJsonString(out, executable);
+    out << ",\n    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n    \"library_build_type\": \""
+        << build_type << "\"\n  },\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n      \"name\": ";
+        WriteJsonString(out, result.name);
+        out << ",\n      \"run_name\": ";
+        WriteJsonString(out, result.name);
+        out << ",\n      \"run_type\": \"iteration\",\n      \"iterations\": " << result.iterations
+            << ",\n      \"real_time\": " << FormatNumber(result.ns_per_op)
+            << ",\n      \"cpu_time\": " << FormatNumber(result.cpu_ns_per_op)
+            << ",\n      \"time_unit\": \"ns\",\n      \"allocs_per_op\": " << FormatNumber(result.allocs_per_op)
+            << ",\n      \"bytes_per_op\": " << FormatNumber(result.bytes_per_op) << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
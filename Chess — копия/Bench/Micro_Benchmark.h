@@ -0,0 +1,128 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*! \brief
+ *   Heap allocations made by the process so far.
+ */
+struct AllocationCounts {
+    std::uint64_t count = 0;   ///< Calls of the global operator new.
+    std::uint64_t bytes = 0;   ///< Bytes requested by these calls.
+};
+
+/*!
+ * \brief Returns the allocations counted by the replaced global operator new of the benchmark binary.
+ */
+AllocationCounts AllocationsSoFar();
+
+/*!
+ * \brief Keeps the compiler from discarding a value computed by a benchmark.
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*!
+ * \class BenchmarkState
+ * \brief Passed to a benchmark: the number of operations to run and the timer.
+ * \details Time and allocations are counted from the start of the benchmark function to its end,
+ * except between PauseTiming() and ResumeTiming(). A pause costs two clock reads, so work that must
+ * be excluded (e.g. preparing boards for DoTurn) should be done in batches of many operations.
+ */
+class BenchmarkState {
+public:
+    explicit BenchmarkState(std::uint64_t iterations) : iterations_(iterations) {}
+
+    /*! \brief Number of operations the benchmark has to run. */
+    std::uint64_t Iterations() const {
+        return iterations_;
+    }
+
+    /*! \brief Stops counting time and allocations. */
+    void PauseTiming();
+
+    /*! \brief Resumes counting after PauseTiming(). */
+    void ResumeTiming();
+
+private:
+    friend class BenchmarkRunner;
+
+    std::uint64_t iterations_;                                ///< Operations to run.
+    bool running_ = false;                                    ///< Timing is on.
+    std::chrono::steady_clock::time_point started_;           ///< Start of the running section.
+    std::clock_t cpu_started_ = 0;                            ///< CPU time at the start of the section.
+    AllocationCounts allocations_started_;                    ///< Allocations at the start of the section.
+    std::chrono::nanoseconds elapsed_{0};                     ///< Wall time of finished sections.
+    double cpu_seconds_ = 0;                                  ///< CPU time of finished sections.
+    AllocationCounts allocations_;                            ///< Allocations of finished sections.
+};
+
+/*! \brief
+ *   Measurements of one benchmark.
+ */
+struct BenchmarkResult {
+    std::string name;               ///< Benchmark name, e.g. "Table::CheckTurn/opening".
+    std::uint64_t iterations = 0;   ///< Operations in the measured run.
+    double ns_per_op = 0;           ///< Wall time per operation.
+    double cpu_ns_per_op = 0;       ///< Process CPU time per operation.
+    double allocs_per_op = 0;       ///< Heap allocations per operation.
+    double bytes_per_op = 0;        ///< Heap bytes requested per operation.
+};
+
+/*!
+ * \class BenchmarkRunner
+ * \brief Registers benchmarks, runs them and reports ns/op and allocations/op.
+ * \details A self-contained subset of Google Benchmark: every benchmark is first run with one
+ * operation, then with geometrically more until a run lasts at least the minimum time; that run is
+ * reported. The JSON report uses the field names of Google Benchmark ("name", "iterations",
+ * "real_time", "cpu_time", "time_unit"), so its comparison tools read it, and adds
+ * "allocs_per_op" and "bytes_per_op".
+ */
+class BenchmarkRunner {
+public:
+    using Function = std::function<void(BenchmarkState&)>;
+
+    /*!
+     * \brief Adds a benchmark.
+     * \param name Unique name; "Subject/position set" by convention.
+     * \param function Runs `state.Iterations()` operations.
+     */
+    void Register(std::string name, Function function);
+
+    /*!
+     * \brief Runs the benchmarks whose names contain \p filter, in the order of registration.
+     * \param min_time Shortest measured run.
+     * \param progress Receives the name of each benchmark before it runs; may be null.
+     */
+    std::vector<BenchmarkResult> Run(std::string_view filter, std::chrono::nanoseconds min_time,
+                                     std::ostream* progress) const;
+
+    /*! \brief Prints results as a table. */
+    static void PrintTable(std::ostream& out, const std::vector<BenchmarkResult>& results);
+
+    /*!
+     * \brief Writes results as JSON.
+     * \param executable Name of the benchmark binary, stored in the context of the report.
+     */
+    static void WriteJson(std::ostream& out, const std::vector<BenchmarkResult>& results,
+                          std::string_view executable);
+
+private:
+    static BenchmarkResult Measure(const std::string& name, const Function& function,
+                                   std::chrono::nanoseconds min_time);
+
+    std::vector<std::pair<std::string, Function>> benchmarks_;   ///< Registered benchmarks.
+};
@@ -0,0 +1,48 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Engine_Benchmarks.h"
+
+int main(int argc, char* argv[]) {
+    // --filter=TEXT: run only benchmarks whose names contain TEXT
+    // --min-time-ms=MS: shortest measured run of a benchmark (200)
+    // --json=FILE: also write the results as JSON, for comparing releases
+    std::string filter;
+    std::string json_path;
+    auto min_time = std::chrono::milliseconds(200);
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.starts_with("--filter=")) {
+                filter = arg.substr(std::string("--filter=").size());
+            } else if (arg.starts_with("--min-time-ms=")) {
+                min_time = std::chrono::milliseconds(std::stol(arg.substr(std::string("--min-time-ms=").size())));
+            } else if (arg.starts_with("--json=")) {
+                json_path = arg.substr(std::string("--json=").size());
+            } else {
+                std::cerr << "❌ Unknown option " << arg << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "❌ Invalid value in " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner;
+    RegisterEngineBenchmarks(runner);
+    auto results = runner.Run(filter, min_time, &std::cerr);
+    BenchmarkRunner::PrintTable(std::cout, results);
+
+    if (!json_path.empty()) {
+        std::ofstream json(json_path);
+        if (!json) {
+            std::cerr << "❌ Cannot open " << json_path << std::endl;
+            return 1;
+        }
+        BenchmarkRunner::WriteJson(json, results, argv[0]);
+    }
+    return 0;
+}
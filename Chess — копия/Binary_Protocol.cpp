@@ -0,0 +1,132 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Binary_Protocol.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+/*!
+ * \brief Converts a square such as "e4" to its index, or -1.
+ */
+int SquareIndex(std::string_view square) {
+    if (square.size() != 2 || square[0] < 'a' || square[0] > 'h' || square[1] < '1' || square[1] > '8') {
+        return -1;
+    }
+    // та же раскладка, что у Manager::ConvertToCoord: строка 0 — восьмая горизонталь
+    int col = square[0] - 'a';
+    int row = 8 - (square[1] - '0');
+    return row * 8 + col;
+}
+
+std::string SquareName(int index) {
+    return {static_cast<char>('a' + index % 8), static_cast<char>('0' + 8 - index / 8)};
+}
+
+std::uint8_t PieceNibble(char symbol) {
+    std::uint8_t colour = std::islower(static_cast<unsigned char>(symbol)) ? 8 : 0;
+    switch (std::toupper(static_cast<unsigned char>(symbol))) {
+        case 'P': return colour | static_cast<std::uint8_t>(BinaryPiece::Pawn);
+        case 'N': return colour | static_cast<std::uint8_t>(BinaryPiece::Knight);
+        case 'B': return colour | static_cast<std::uint8_t>(BinaryPiece::Bishop);
+        case 'R': return colour | static_cast<std::uint8_t>(BinaryPiece::Rook);
+        case 'Q': return colour | static_cast<std::uint8_t>(BinaryPiece::Queen);
+        case 'K': return colour | static_cast<std::uint8_t>(BinaryPiece::King);
+        default: return static_cast<std::uint8_t>(BinaryPiece::Empty);
+    }
+}
+
+}
+
+BinaryFrameWriter::BinaryFrameWriter(BinaryFrameType type, std::uint32_t tag, std::size_t payload_size)
+    : frame_(kBinaryHeaderSize + payload_size, '\0') {
+    for (std::size_t i = 0; i < 4; ++i) {
+        frame_[i] = static_cast<char>(payload_size >> (8 * i));
+        frame_[8 + i] = static_cast<char>(tag >> (8 * i));
+    }
+    frame_[4] = static_cast<char>(type);
+}
+
+// смещения полей отсчитываются от начала полезной нагрузки
+BinaryFrameWriter& BinaryFrameWriter::U8(std::size_t offset, std::uint8_t value) {
+    frame_[kBinaryHeaderSize + offset] = static_cast<char>(value);
+    return *this;
+}
+
+BinaryFrameWriter& BinaryFrameWriter::U16(std::size_t offset, std::uint16_t value) {
+    U8(offset, static_cast<std::uint8_t>(value));
+    U8(offset + 1, static_cast<std::uint8_t>(value >> 8));
+    return *this;
+}
+
+BinaryFrameWriter& BinaryFrameWriter::U32(std::size_t offset, std::uint32_t value) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        U8(offset + i, static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+    return *this;
+}
+
+BinaryFrameWriter& BinaryFrameWriter::Text(std::size_t offset, std::size_t width, std::string_view value) {
+    frame_.replace(kBinaryHeaderSize + offset, std::min(width, value.size()), value.substr(0, width));
+    return *this;
+}
+
+BinaryFrameWriter& BinaryFrameWriter::Position(std::size_t offset, const BinaryPosition& position) {
+    std::memcpy(frame_.data() + kBinaryHeaderSize + offset, position.data(), position.size());
+    return *this;
+}
+
+BinaryHeader DecodeBinaryHeader(const std::uint8_t* data) {
+    BinaryPayloadView view(data, kBinaryHeaderSize);
+    return {view.U32(0), static_cast<BinaryFrameType>(view.U8(4)), view.U32(8)};
+}
+
+std::optional<std::string> DecodeBinaryMove(std::uint16_t code) {
+    switch (static_cast<BinaryMoveKind>(code >> 12)) {
+        case BinaryMoveKind::Normal: return SquareName(code & 0x3F) + " " + SquareName((code >> 6) & 0x3F);
+        case BinaryMoveKind::WhiteShortCastle: return std::string("O-O");
+        case BinaryMoveKind::WhiteLongCastle: return std::string("O-O-O");
+        case BinaryMoveKind::BlackShortCastle: return std::string("o-o");
+        case BinaryMoveKind::BlackLongCastle: return std::string("o-o-o");
+    }
+    return std::nullopt;
+}
+
+std::optional<std::uint16_t> EncodeBinaryMove(std::string_view move) {
+    auto kind = [](BinaryMoveKind k) { return static_cast<std::uint16_t>(static_cast<std::uint16_t>(k) << 12); };
+    if (move == "O-O") return kind(BinaryMoveKind::WhiteShortCastle);
+    if (move == "O-O-O") return kind(BinaryMoveKind::WhiteLongCastle);
+    if (move == "o-o") return kind(BinaryMoveKind::BlackShortCastle);
+    if (move == "o-o-o") return kind(BinaryMoveKind::BlackLongCastle);
+
+    auto space = move.find(' ');
+    if (space == std::string_view::npos) {
+        return std::nullopt;
+    }
+    int from = SquareIndex(move.substr(0, space));
+    int to = SquareIndex(move.substr(space + 1));
+    if (from < 0 || to < 0) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint16_t>(from | to << 6);
+}
+
+BinaryPosition EncodeBinaryPosition(std::string_view board_state) {
+    BinaryPosition position{};
+    std::size_t square = 0;
+    for (char symbol : board_state) {
+        if (square == 64) {
+            break;
+        }
+        if (symbol == ' ' || symbol == '\n') {
+            continue;
+        }
+        std::uint8_t nibble = PieceNibble(symbol);
+        position[square / 2] |= (square % 2 == 0) ? static_cast<std::uint8_t>(nibble << 4) : nibble;
+        ++square;
+    }
+    return position;
+}
@@ -0,0 +1,185 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/*!
+ * \file Binary_Protocol.h
+ * \brief Length-prefixed binary protocol for bot clients.
+ * \details Every frame is a 12-byte header followed by a fixed-size payload; all integers are
+ * little-endian.
+ *
+ *     header:  u32 length (payload bytes) | u8 type | u8[3] reserved | u32 tag
+ *
+ * The tag is chosen by the client and echoed in the reply, so any number of requests for any
+ * number of games can be in flight on one connection. Replies may arrive out of order.
+ *
+ * Payloads (offsets in bytes):
+ *   - Auth (52):          i32 rating @0 | char[32] username @4 | char[16] time_control @36
+ *   - AuthReply (44):     u8 status @0 | u8 colour @1 | i32 player_id @4 | i32 game_id @8 | char[32] token @12
+ *   - Move (40):          i32 player_id @0 | u16 move @4 | char[32] token @8
+ *   - MoveReply (40):     u8 status @0 | i32 ply @4 | position @8
+ *   - Status (36):        i32 player_id @0 | char[32] token @4
+ *   - StatusReply (44):   u8 status @0 | i32 game_id @4 | i32 ply @8 | position @12
+ *   - Subscribe (36):     same as Status
+ *   - SubscribeReply (8): u8 status @0 | i32 game_id @4
+ *   - Event (48):         i32 game_id @0 | i32 ply @4 | u16 move @8 | u32 think_ms @12 | position @16
+ *
+ * Strings are NUL-padded. A move is 16 bits: `from | to << 6 | kind << 12`, where squares are
+ * numbered `row * 8 + col` in the order of the board state (a8 = 0, h1 = 63) and kind is one of
+ * BinaryMoveKind. A position is 32 bytes: one nibble per square in the same order, high nibble
+ * first, holding a BinaryPiece.
+ */
+
+/*! \brief Frame types; replies have the high bit set. */
+enum class BinaryFrameType : std::uint8_t {
+    Auth = 0x01,
+    Move = 0x02,
+    Status = 0x03,
+    Subscribe = 0x04,
+    AuthReply = 0x81,
+    MoveReply = 0x82,
+    StatusReply = 0x83,
+    SubscribeReply = 0x84,
+    Event = 0x90,
+    Error = 0xFF,  ///< Empty payload; sent for an unknown type or a payload of the wrong size.
+};
+
+/*! \brief Result codes carried in the first payload byte of replies. */
+enum class BinaryStatus : std::uint8_t {
+    Ok = 0,
+    InvalidMove = 1,
+    NotAuthenticated = 2,
+    WaitingForOpponent = 3,
+    GameNotFound = 4,
+    NoOpponent = 5,     ///< No opponent within the wait; the ticket was withdrawn, send Auth again.
+    RateLimited = 6,    ///< The player exceeded the rate limit of the request type.
+    Overloaded = 7,     ///< The server shed the request; retry later.
+};
+
+/*! \brief Colour field of AuthReply. */
+enum class BinaryColour : std::uint8_t { None = 0, White = 1, Black = 2 };
+
+/*! \brief Special moves encoded in the kind bits of a move code. */
+enum class BinaryMoveKind : std::uint8_t {
+    Normal = 0,
+    WhiteShortCastle = 1,   ///< "O-O"
+    WhiteLongCastle = 2,    ///< "O-O-O"
+    BlackShortCastle = 3,   ///< "o-o"
+    BlackLongCastle = 4,    ///< "o-o-o"
+};
+
+/*! \brief Nibble values of a position; black pieces have bit 3 set. */
+enum class BinaryPiece : std::uint8_t { Empty = 0, Pawn = 1, Knight = 2, Bishop = 3, Rook = 4, Queen = 5, King = 6 };
+
+constexpr std::size_t kBinaryHeaderSize = 12;      ///< Bytes in a frame header.
+constexpr std::size_t kBinaryMaxPayload = 256;     ///< Larger frames close the connection.
+constexpr std::size_t kBinaryPositionSize = 32;    ///< Bytes in an encoded position.
+constexpr std::size_t kBinaryTokenSize = 32;       ///< Bytes in a session token field.
+
+constexpr std::size_t kBinaryAuthSize = 52;            ///< Payload bytes of Auth.
+constexpr std::size_t kBinaryAuthReplySize = 44;       ///< Payload bytes of AuthReply.
+constexpr std::size_t kBinaryMoveSize = 40;            ///< Payload bytes of Move.
+constexpr std::size_t kBinaryMoveReplySize = 40;       ///< Payload bytes of MoveReply.
+constexpr std::size_t kBinaryStatusSize = 36;          ///< Payload bytes of Status and Subscribe.
+constexpr std::size_t kBinaryStatusReplySize = 44;     ///< Payload bytes of StatusReply.
+constexpr std::size_t kBinarySubscribeReplySize = 8;   ///< Payload bytes of SubscribeReply.
+constexpr std::size_t kBinaryEventSize = 48;           ///< Payload bytes of Event.
+
+using BinaryPosition = std::array<std::uint8_t, kBinaryPositionSize>;
+
+/*!
+ * \brief Decoded frame header.
+ */
+struct BinaryHeader {
+    std::uint32_t length = 0;                        ///< Payload bytes.
+    BinaryFrameType type = BinaryFrameType::Error;   ///< Frame type.
+    std::uint32_t tag = 0;                           ///< Client correlation tag.
+};
+
+/*!
+ * \brief Read-only view of a payload; fields are decoded in place, without copying the frame.
+ */
+class BinaryPayloadView {
+public:
+    BinaryPayloadView(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    std::size_t Size() const { return size_; }
+
+    std::uint8_t U8(std::size_t offset) const { return data_[offset]; }
+
+    std::uint16_t U16(std::size_t offset) const {
+        return static_cast<std::uint16_t>(data_[offset] | data_[offset + 1] << 8);
+    }
+
+    std::uint32_t U32(std::size_t offset) const {
+        return static_cast<std::uint32_t>(data_[offset]) | static_cast<std::uint32_t>(data_[offset + 1]) << 8 |
+               static_cast<std::uint32_t>(data_[offset + 2]) << 16 | static_cast<std::uint32_t>(data_[offset + 3]) << 24;
+    }
+
+    std::int32_t I32(std::size_t offset) const { return static_cast<std::int32_t>(U32(offset)); }
+
+    /*! \brief Returns a NUL-padded string field as a view into the frame. */
+    std::string_view Text(std::size_t offset, std::size_t width) const {
+        const char* begin = reinterpret_cast<const char*>(data_ + offset);
+        return std::string_view(begin, strnlen(begin, width));
+    }
+
+private:
+    const std::uint8_t* data_;  ///< First payload byte.
+    std::size_t size_;          ///< Payload size.
+};
+
+/*!
+ * \brief Builds a frame with a fixed-size payload; fields are written at their offsets.
+ */
+class BinaryFrameWriter {
+public:
+    BinaryFrameWriter(BinaryFrameType type, std::uint32_t tag, std::size_t payload_size);
+
+    BinaryFrameWriter& U8(std::size_t offset, std::uint8_t value);
+    BinaryFrameWriter& U16(std::size_t offset, std::uint16_t value);
+    BinaryFrameWriter& U32(std::size_t offset, std::uint32_t value);
+    BinaryFrameWriter& I32(std::size_t offset, std::int32_t value) { return U32(offset, static_cast<std::uint32_t>(value)); }
+    BinaryFrameWriter& Text(std::size_t offset, std::size_t width, std::string_view value);
+    BinaryFrameWriter& Position(std::size_t offset, const BinaryPosition& position);
+
+    /*! \brief Returns the encoded frame, header included. */
+    std::string Release() { return std::move(frame_); }
+
+private:
+    std::string frame_;  ///< Header and payload.
+};
+
+/*!
+ * \brief Decodes a frame header.
+ * \param data Exactly kBinaryHeaderSize bytes.
+ */
+BinaryHeader DecodeBinaryHeader(const std::uint8_t* data);
+
+/*!
+ * \brief Converts a move code to the text notation accepted by RunningGame ("e2 e4", "O-O", ...).
+ * \return std::nullopt for an unknown kind.
+ */
+std::optional<std::string> DecodeBinaryMove(std::uint16_t code);
+
+/*!
+ * \brief Converts a text move to its 16-bit code.
+ * \return std::nullopt if the text is not a move.
+ */
+std::optional<std::uint16_t> EncodeBinaryMove(std::string_view move);
+
+/*!
+ * \brief Packs a board state produced by Table::GenerateBoardState() into 32 bytes.
+ */
+BinaryPosition EncodeBinaryPosition(std::string_view board_state);
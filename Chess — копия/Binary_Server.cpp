@@ -0,0 +1,175 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Binary_Server.h"
+
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Logger.h"
+
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+constexpr std::size_t kMaxPendingFrames = 4096;  ///< A client this far behind is disconnected.
+
+/*!
+ * \class BinaryConnection
+ * \brief One client connection; all of its coroutines and writes run on its strand.
+ */
+class BinaryConnection : public std::enable_shared_from_this<BinaryConnection> {
+public:
+    BinaryConnection(tcp::socket&& socket, BinaryServer& server)
+        : socket_(std::move(socket)), server_(server), events_(server.Events()) {}
+
+    // может выполниться уже после удаления BinaryServer, когда io_context уничтожает свои обработчики
+    ~BinaryConnection() {
+        for (const auto& [game_id, subscription] : subscriptions_) {
+            events_.Unsubscribe(game_id, subscription);
+        }
+    }
+
+    void Start() {
+        net::co_spawn(socket_.get_executor(), ReadLoop(shared_from_this()), net::detached);
+    }
+
+private:
+    static Task<> ReadLoop(std::shared_ptr<BinaryConnection> self) {
+        try {
+            std::uint8_t header_bytes[kBinaryHeaderSize];
+            while (true) {
+                co_await net::async_read(self->socket_, net::buffer(header_bytes), net::use_awaitable);
+                BinaryHeader header = DecodeBinaryHeader(header_bytes);
+                if (header.length > kBinaryMaxPayload) {
+                    break;
+                }
+
+                // каждый кадр читается в собственный буфер и разбирается на месте, без копий
+                std::vector<std::uint8_t> payload(header.length);
+                co_await net::async_read(self->socket_, net::buffer(payload), net::use_awaitable);
+
+                if (header.type == BinaryFrameType::Subscribe) {
+                    self->HandleSubscribe(header, BinaryPayloadView(payload.data(), payload.size()));
+                } else {
+                    net::co_spawn(self->socket_.get_executor(), HandleRequest(self, header, std::move(payload)),
+                                  net::detached);
+                }
+            }
+        } catch (const std::exception&) {
+            // соединение закрыто клиентом или оборвалось
+        }
+        boost::system::error_code ec;
+        self->socket_.close(ec);
+    }
+
+    static Task<> HandleRequest(std::shared_ptr<BinaryConnection> self, BinaryHeader header,
+                                std::vector<std::uint8_t> payload) {
+        std::string reply;
+        try {
+            reply = co_await self->server_.Handler()(header, BinaryPayloadView(payload.data(), payload.size()));
+        } catch (const std::exception& e) {
+            CHESS_LOG_ERROR("binary request failed", {"type", static_cast<int>(header.type)}, {"error", e.what()});
+            reply = BinaryFrameWriter(BinaryFrameType::Error, header.tag, 0).Release();
+        }
+        self->Push(std::move(reply));
+    }
+
+    void HandleSubscribe(const BinaryHeader& header, BinaryPayloadView payload) {
+        BinaryFrameWriter reply(BinaryFrameType::SubscribeReply, header.tag, 8);
+        if (payload.Size() != kBinaryStatusSize) {
+            Push(BinaryFrameWriter(BinaryFrameType::Error, header.tag, 0).Release());
+            return;
+        }
+
+        std::optional<int> game_id =
+            server_.AuthorizePlayer()(payload.I32(0), payload.Text(4, kBinaryTokenSize));
+        if (!game_id) {
+            Push(reply.U8(0, static_cast<std::uint8_t>(BinaryStatus::NotAuthenticated)).Release());
+            return;
+        }
+
+        std::weak_ptr<BinaryConnection> weak = shared_from_this();
+        int subscription = events_.Subscribe(*game_id, [weak](const GameUpdate& update) {
+            if (auto self = weak.lock()) {
+                self->Push(EncodeEvent(update));
+            }
+        });
+        subscriptions_.emplace_back(*game_id, subscription);
+
+        Push(reply.U8(0, static_cast<std::uint8_t>(BinaryStatus::Ok)).I32(4, *game_id).Release());
+    }
+
+    static std::string EncodeEvent(const GameUpdate& update) {
+        return BinaryFrameWriter(BinaryFrameType::Event, 0, kBinaryEventSize)
+            .I32(0, update.game_id)
+            .I32(4, update.ply)
+            .U16(8, EncodeBinaryMove(update.move).value_or(0))
+            .U32(12, static_cast<std::uint32_t>(update.think_time.count()))
+            .Position(16, EncodeBinaryPosition(update.board_state))
+            .Release();
+    }
+
+    /*! \brief Queues a frame; safe to call from any thread. */
+    void Push(std::string frame) {
+        net::dispatch(socket_.get_executor(), [self = shared_from_this(), frame = std::move(frame)]() mutable {
+            if (self->outbox_.size() >= kMaxPendingFrames) {
+                boost::system::error_code ec;
+                self->socket_.close(ec);
+                return;
+            }
+            self->outbox_.push_back(std::move(frame));
+            if (self->outbox_.size() == 1) {
+                self->DoWrite();
+            }
+        });
+    }
+
+    void DoWrite() {
+        net::async_write(socket_, net::buffer(outbox_.front()),
+                         [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+                             if (ec) {
+                                 return;
+                             }
+                             self->outbox_.pop_front();
+                             if (!self->outbox_.empty()) {
+                                 self->DoWrite();
+                             }
+                         });
+    }
+
+    tcp::socket socket_;                                 ///< Socket bound to the connection strand.
+    BinaryServer& server_;                               ///< Owning server.
+    GameEvents& events_;                                 ///< Source of Event frames; outlives the server.
+    std::deque<std::string> outbox_;                     ///< Frames waiting to be written.
+    std::vector<std::pair<int, int>> subscriptions_;     ///< (game ID, subscription ID) pairs; strand only.
+};
+
+}
+
+BinaryServer::BinaryServer(net::io_context& ioc, unsigned short port, RequestHandler handler, GameEvents& events,
+                           Authorize authorize)
+    : ioc_(ioc)
+    , acceptor_(net::make_strand(ioc), tcp::endpoint(tcp::v4(), port))
+    , handler_(std::move(handler))
+    , events_(events)
+    , authorize_(std::move(authorize)) {
+    DoAccept();
+    std::cout << "✅ Binary protocol at tcp://localhost:" << port << "\n";
+}
+
+void BinaryServer::DoAccept() {
+    acceptor_.async_accept(net::make_strand(ioc_), [this](boost::system::error_code ec, tcp::socket socket) {
+        if (!ec) {
+            socket.set_option(tcp::no_delay(true), ec);
+            std::make_shared<BinaryConnection>(std::move(socket), *this)->Start();
+        }
+        if (acceptor_.is_open()) {
+            DoAccept();
+        }
+    });
+}
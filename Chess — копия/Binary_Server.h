@@ -0,0 +1,66 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Async_Task.h"
+#include "Binary_Protocol.h"
+#include "Game_Events.h"
+
+/*!
+ * \class BinaryServer
+ * \brief Serves the length-prefixed binary protocol described in Binary_Protocol.h over TCP.
+ * \details Runs on an existing I/O context, so it shares the I/O threads of the HTTP server. Each
+ * connection reads frames in a loop and handles every request in its own coroutine, so slow
+ * requests (an Auth waiting for an opponent) never hold up the others on the same connection.
+ * Subscribe frames are handled here: the connection then receives an Event frame for every move
+ * of the subscribed game, for as many games as the client subscribes to.
+ */
+class BinaryServer {
+public:
+    /*!
+     * \brief Handles an Auth, Move or Status request.
+     * \details Receives the frame header and a view of the payload, which is valid until the
+     * returned task completes. Returns the complete reply frame.
+     */
+    using RequestHandler = std::function<Task<std::string>(const BinaryHeader&, BinaryPayloadView)>;
+
+    /*!
+     * \brief Checks a player's credentials for Subscribe and returns the player's game ID.
+     */
+    using Authorize = std::function<std::optional<int>(int player_id, std::string_view token)>;
+
+    /*!
+     * \brief Starts accepting connections on \p ioc.
+     * \param ioc I/O context the connections run on; must outlive the server.
+     * \param port TCP port to listen on.
+     * \param handler Handler of Auth, Move and Status requests.
+     * \param events Source of Event frames; must outlive the server.
+     * \param authorize Credential check for Subscribe.
+     */
+    BinaryServer(boost::asio::io_context& ioc, unsigned short port, RequestHandler handler, GameEvents& events,
+                 Authorize authorize);
+
+    BinaryServer(const BinaryServer&) = delete;
+    BinaryServer& operator=(const BinaryServer&) = delete;
+
+    const RequestHandler& Handler() const { return handler_; }
+    GameEvents& Events() const { return events_; }
+    const Authorize& AuthorizePlayer() const { return authorize_; }
+
+private:
+    void DoAccept();
+
+    boost::asio::io_context& ioc_;                ///< I/O context shared with the HTTP server.
+    boost::asio::ip::tcp::acceptor acceptor_;     ///< Listening socket.
+    RequestHandler handler_;                      ///< Auth, Move and Status handler.
+    GameEvents& events_;                          ///< Source of Event frames.
+    Authorize authorize_;                         ///< Credential check for Subscribe.
+};
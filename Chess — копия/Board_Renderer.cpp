@@ -0,0 +1,359 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Board_Renderer.h"
+
+#include <cctype>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace {
+
+constexpr std::size_t kGlyphCells = 16;  ///< Side of a glyph mask in cells.
+constexpr std::size_t kCellPixels = BoardRenderer::kSquarePixels / kGlyphCells;
+constexpr std::uint8_t kTransparent = 0xFF;  ///< Atlas value of pixels that show the square.
+
+constexpr char kPieces[] = "PNBRQK";  ///< Glyph order; black glyphs follow the white ones.
+
+// силуэты фигур: '#' — заливка, контур достраивается вокруг неё
+constexpr const char* kMasks[6][kGlyphCells] = {
+    {"................",
+     "................",
+     "................",
+     "......####......",
+     ".....######.....",
+     ".....######.....",
+     "......####......",
+     ".....######.....",
+     "......####......",
+     "......####......",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...##########...",
+     "................",
+     "................"},
+    {"................",
+     "................",
+     "......#.#.......",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...###.######...",
+     "..###########...",
+     "..######.####...",
+     "...###..#####...",
+     ".......######...",
+     "......#######...",
+     ".....########...",
+     "....##########..",
+     "....##########..",
+     "................"},
+    {"................",
+     ".......##.......",
+     "......####......",
+     ".....##.###.....",
+     "....###.####....",
+     "....#######.....",
+     "....########....",
+     ".....######.....",
+     "......####......",
+     ".....######.....",
+     "......####......",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...##########...",
+     "................"},
+    {"................",
+     "................",
+     "...##.####.##...",
+     "...##.####.##...",
+     "...##########...",
+     "....########....",
+     ".....######.....",
+     ".....######.....",
+     ".....######.....",
+     ".....######.....",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...##########...",
+     "................",
+     "................"},
+    {"................",
+     "..#...#..#...#..",
+     "..#...#..#...#..",
+     "..##..##.##..##.",
+     "..###.######.##.",
+     "..############..",
+     "...##########...",
+     "...##########...",
+     "....########....",
+     ".....######.....",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...##########...",
+     "................",
+     "................"},
+    {".......##.......",
+     "......####......",
+     ".......##.......",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...##########...",
+     "....########....",
+     ".....######.....",
+     ".....######.....",
+     ".....######.....",
+     "....########....",
+     "...##########...",
+     "...##########...",
+     "................",
+     "................"},
+};
+
+/*! \brief Palette of the PNG; the indices are used by the atlas and the squares. */
+enum PaletteIndex : std::uint8_t { LightSquare, DarkSquare, WhiteFill, BlackFill, Outline };
+
+constexpr std::uint8_t kPalette[][3] = {
+    {0xF0, 0xD9, 0xB5},
+    {0xB5, 0x88, 0x63},
+    {0xFF, 0xFF, 0xFF},
+    {0x3A, 0x3A, 0x3A},
+    {0x00, 0x00, 0x00},
+};
+
+const char* kSvgColours[] = {"#f0d9b5", "#b58863", "#fff", "#3a3a3a", "#000"};
+
+/*!
+ * \brief Returns the palette index of a glyph cell, or kTransparent outside the glyph.
+ */
+std::uint8_t GlyphCell(const char* const* mask, int row, int col, std::uint8_t fill) {
+    auto filled = [&](int r, int c) {
+        return r >= 0 && c >= 0 && r < static_cast<int>(kGlyphCells) && c < static_cast<int>(kGlyphCells) &&
+               mask[r][c] == '#';
+    };
+    if (filled(row, col)) {
+        return fill;
+    }
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if (filled(row + dr, col + dc)) {
+                return Outline;
+            }
+        }
+    }
+    return kTransparent;
+}
+
+/*!
+ * \brief Returns the atlas slot of a piece symbol, or -1 for an empty square.
+ */
+int GlyphIndex(char symbol) {
+    for (int i = 0; i < 6; ++i) {
+        if (kPieces[i] == symbol) {
+            return i;
+        }
+        if (std::tolower(static_cast<unsigned char>(kPieces[i])) == symbol) {
+            return i + 6;
+        }
+    }
+    return -1;
+}
+
+void AppendU32(std::string& out, std::uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out += static_cast<char>(value >> shift);
+    }
+}
+
+void AppendChunk(std::string& png, const char* type, const std::string& data) {
+    AppendU32(png, static_cast<std::uint32_t>(data.size()));
+    std::size_t start = png.size();
+    png.append(type, 4);
+    png += data;
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(png.data() + start), static_cast<uInt>(png.size() - start));
+    AppendU32(png, static_cast<std::uint32_t>(crc));
+}
+
+}
+
+BoardRenderer::BoardRenderer(std::size_t cache_entries) : cache_(cache_entries) {
+    for (std::size_t glyph = 0; glyph < atlas_.size(); ++glyph) {
+        const char* const* mask = kMasks[glyph % 6];
+        std::uint8_t fill = glyph < 6 ? WhiteFill : BlackFill;
+
+        std::vector<std::uint8_t>& tile = atlas_[glyph];
+        tile.resize(kSquarePixels * kSquarePixels);
+        for (std::size_t y = 0; y < kSquarePixels; ++y) {
+            for (std::size_t x = 0; x < kSquarePixels; ++x) {
+                tile[y * kSquarePixels + x] = GlyphCell(mask, y / kCellPixels, x / kCellPixels, fill);
+            }
+        }
+
+        // в SVG каждая строка маски сливается в отрезки одного цвета
+        std::string& symbol = svg_glyphs_[glyph];
+        symbol = "<symbol id=\"g" + std::to_string(glyph) + "\" viewBox=\"0 0 16 16\">";
+        for (int row = 0; row < static_cast<int>(kGlyphCells); ++row) {
+            int col = 0;
+            while (col < static_cast<int>(kGlyphCells)) {
+                std::uint8_t colour = GlyphCell(mask, row, col, fill);
+                int end = col + 1;
+                while (end < static_cast<int>(kGlyphCells) && GlyphCell(mask, row, end, fill) == colour) {
+                    ++end;
+                }
+                if (colour != kTransparent) {
+                    symbol += "<rect x=\"" + std::to_string(col) + "\" y=\"" + std::to_string(row) + "\" width=\"" +
+                              std::to_string(end - col) + "\" height=\"1\" fill=\"" + kSvgColours[colour] + "\"/>";
+                }
+                col = end;
+            }
+        }
+        symbol += "</symbol>";
+    }
+}
+
+std::shared_ptr<const std::string> BoardRenderer::FindCached(std::string_view board_state, BoardFormat format) {
+    Squares squares = ParseSquares(board_state);
+    auto cached = cache_.Find(PositionHash(squares, format));
+    if (!cached || cached->squares != squares) {
+        return nullptr;
+    }
+    return cached->bytes;
+}
+
+std::shared_ptr<const std::string> BoardRenderer::Render(std::string_view board_state, BoardFormat format) {
+    Squares squares = ParseSquares(board_state);
+    std::uint64_t hash = PositionHash(squares, format);
+    if (auto cached = cache_.Find(hash); cached && cached->squares == squares) {
+        return cached->bytes;
+    }
+    return Encode(squares, hash, format);
+}
+
+std::shared_ptr<const std::string> BoardRenderer::RenderAfterMiss(std::string_view board_state, BoardFormat format) {
+    Squares squares = ParseSquares(board_state);
+    return Encode(squares, PositionHash(squares, format), format);
+}
+
+std::shared_ptr<const std::string> BoardRenderer::Encode(const Squares& squares, std::uint64_t hash, BoardFormat format) {
+    auto bytes = std::make_shared<const std::string>(format == BoardFormat::Png ? EncodePng(squares)
+                                                                                : EncodeSvg(squares));
+    cache_.Insert(hash, CachedImage{squares, bytes});
+    return bytes;
+}
+
+const char* BoardRenderer::ContentType(BoardFormat format) {
+    return format == BoardFormat::Png ? "image/png" : "image/svg+xml";
+}
+
+BoardRenderer::Squares BoardRenderer::ParseSquares(std::string_view board_state) {
+    Squares squares;
+    squares.fill('.');
+    std::size_t square = 0;
+    for (char symbol : board_state) {
+        if (square == squares.size()) {
+            break;
+        }
+        if (symbol == ' ' || symbol == '\n') {
+            continue;
+        }
+        squares[square++] = symbol;
+    }
+    return squares;
+}
+
+std::uint64_t BoardRenderer::PositionHash(const Squares& squares, BoardFormat format) {
+    // FNV-1a по клеткам и формату
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](unsigned char byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+    for (char symbol : squares) {
+        mix(static_cast<unsigned char>(symbol));
+    }
+    mix(static_cast<unsigned char>(format));
+    return hash;
+}
+
+std::string BoardRenderer::EncodePng(const Squares& squares) const {
+    // индексированное изображение: перед каждой строкой байт фильтра 0
+    std::vector<std::uint8_t> raw((kBoardPixels + 1) * kBoardPixels);
+    for (std::size_t y = 0; y < kBoardPixels; ++y) {
+        std::uint8_t* line = raw.data() + y * (kBoardPixels + 1);
+        line[0] = 0;
+        for (std::size_t x = 0; x < kBoardPixels; ++x) {
+            std::size_t row = y / kSquarePixels;
+            std::size_t col = x / kSquarePixels;
+            std::uint8_t pixel = (row + col) % 2 == 0 ? LightSquare : DarkSquare;
+            int glyph = GlyphIndex(squares[row * 8 + col]);
+            if (glyph >= 0) {
+                std::uint8_t value = atlas_[glyph][(y % kSquarePixels) * kSquarePixels + x % kSquarePixels];
+                if (value != kTransparent) {
+                    pixel = value;
+                }
+            }
+            line[x + 1] = pixel;
+        }
+    }
+
+    uLongf compressed_size = compressBound(static_cast<uLong>(raw.size()));
+    std::string compressed(compressed_size, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressed_size, raw.data(),
+                  static_cast<uLong>(raw.size()), Z_BEST_COMPRESSION) != Z_OK) {
+        throw std::runtime_error("Failed to compress the board image");
+    }
+    compressed.resize(compressed_size);
+
+    std::string header;
+    AppendU32(header, kBoardPixels);
+    AppendU32(header, kBoardPixels);
+    header += {8, 3, 0, 0, 0};  // 8 бит на пиксель, палитра, без чересстрочности
+
+    std::string palette;
+    for (const auto& colour : kPalette) {
+        palette.append(reinterpret_cast<const char*>(colour), 3);
+    }
+
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+    AppendChunk(png, "IHDR", header);
+    AppendChunk(png, "PLTE", palette);
+    AppendChunk(png, "IDAT", compressed);
+    AppendChunk(png, "IEND", "");
+    return png;
+}
+
+std::string BoardRenderer::EncodeSvg(const Squares& squares) const {
+    std::string size = std::to_string(kBoardPixels);
+    std::string svg = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" + size + "\" height=\"" + size +
+                      "\" viewBox=\"0 0 8 8\" shape-rendering=\"crispEdges\"><defs>";
+
+    std::array<bool, 12> used{};
+    for (char symbol : squares) {
+        if (int glyph = GlyphIndex(symbol); glyph >= 0 && !used[glyph]) {
+            used[glyph] = true;
+            svg += svg_glyphs_[glyph];
+        }
+    }
+    svg += "</defs><rect width=\"8\" height=\"8\" fill=\"" + std::string(kSvgColours[LightSquare]) + "\"/>";
+
+    for (std::size_t square = 0; square < squares.size(); ++square) {
+        std::string x = std::to_string(square % 8);
+        std::string y = std::to_string(square / 8);
+        if ((square % 8 + square / 8) % 2 == 1) {
+            svg += "<rect x=\"" + x + "\" y=\"" + y + "\" width=\"1\" height=\"1\" fill=\"" +
+                   kSvgColours[DarkSquare] + "\"/>";
+        }
+        if (int glyph = GlyphIndex(squares[square]); glyph >= 0) {
+            svg += "<use href=\"#g" + std::to_string(glyph) + "\" x=\"" + x + "\" y=\"" + y +
+                   "\" width=\"1\" height=\"1\"/>";
+        }
+    }
+    svg += "</svg>";
+    return svg;
+}
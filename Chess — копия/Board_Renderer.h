@@ -0,0 +1,93 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "My_Lru_Cache.h"
+
+/*! \brief Image formats produced by BoardRenderer. */
+enum class BoardFormat { Png, Svg };
+
+/*!
+ * \class BoardRenderer
+ * \brief Draws board states as PNG or SVG images and keeps the results in an LRU cache.
+ * \details The twelve piece glyphs are rasterised once, in the constructor, into an atlas of
+ * palette-indexed tiles; rendering a PNG only copies tiles onto the squares and compresses the
+ * result. Images are cached by a hash of the position and the format, so popular positions such
+ * as the opening are encoded once and then served as the same bytes. All methods are thread-safe.
+ */
+class BoardRenderer {
+public:
+    static constexpr std::size_t kSquarePixels = 48;                 ///< Side of a square in a PNG.
+    static constexpr std::size_t kBoardPixels = 8 * kSquarePixels;   ///< Side of the whole PNG.
+    static constexpr std::size_t kDefaultCacheEntries = 1024;        ///< Images kept by default.
+
+    /*!
+     * \brief Builds the glyph atlas.
+     * \param cache_entries Maximum number of cached images.
+     */
+    explicit BoardRenderer(std::size_t cache_entries = kDefaultCacheEntries);
+
+    /*!
+     * \brief Returns a cached image without rendering anything.
+     * \param board_state Board state produced by Table::GenerateBoardState().
+     * \param format Image format.
+     * \return The encoded image, or nullptr if it is not cached.
+     */
+    std::shared_ptr<const std::string> FindCached(std::string_view board_state, BoardFormat format);
+
+    /*!
+     * \brief Returns the image of a position, rendering and caching it on a miss.
+     * \details A miss takes a few milliseconds of CPU; callers on an I/O thread should try
+     * FindCached() first and render elsewhere.
+     * \param board_state Board state produced by Table::GenerateBoardState().
+     * \param format Image format.
+     * \return The encoded image.
+     */
+    std::shared_ptr<const std::string> Render(std::string_view board_state, BoardFormat format);
+
+    /*!
+     * \brief Renders a position and caches it without looking the cache up first.
+     * \details For callers that have just missed in FindCached(), so that the miss is counted once.
+     * \param board_state Board state produced by Table::GenerateBoardState().
+     * \param format Image format.
+     * \return The encoded image.
+     */
+    std::shared_ptr<const std::string> RenderAfterMiss(std::string_view board_state, BoardFormat format);
+
+    /*!
+     * \brief Returns the MIME type of a format.
+     */
+    static const char* ContentType(BoardFormat format);
+
+    CacheStats GetCacheStats() const { return cache_.GetStats(); }
+
+private:
+    using Squares = std::array<char, 64>;  ///< Piece symbols from a8 to h1.
+
+    /*! \brief Cache entry; the position is kept to tell hash collisions from hits. */
+    struct CachedImage {
+        Squares squares{};                          ///< Position the image shows.
+        std::shared_ptr<const std::string> bytes;   ///< Encoded image.
+    };
+
+    static Squares ParseSquares(std::string_view board_state);
+    static std::uint64_t PositionHash(const Squares& squares, BoardFormat format);
+
+    std::string EncodePng(const Squares& squares) const;
+    std::string EncodeSvg(const Squares& squares) const;
+    std::shared_ptr<const std::string> Encode(const Squares& squares, std::uint64_t hash, BoardFormat format);
+
+    std::array<std::vector<std::uint8_t>, 12> atlas_;  ///< Palette indices of each glyph tile.
+    std::array<std::string, 12> svg_glyphs_;           ///< The same glyphs as SVG symbols.
+    LruCache<std::uint64_t, CachedImage> cache_;       ///< Images by position hash.
+};
@@ -12,8 +12,11 @@
  cell color, available moves and cell name.
  */
 
+#include <memory>
+#include <memory_resource>
 #include <string_view>
 #include <unordered_set>
+#include <vector>
 
 #include "Types/Game_types.h"
 
@@ -34,3 +37,7 @@ class Cell {
  protected:
   Coord coord_;  ///< The coordinates are protected so they should be visible to other figures but not changeable.
 };
+
+/*! \brief 8x8 grid of cells; the rows and the cells are allocated from the memory resource of the grid.
+ */
+using Board = std::pmr::vector<std::pmr::vector<std::shared_ptr<Cell>>>;
@@ -1,22 +1,121 @@
-#include <httplib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <pqxx/pqxx>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "/Users/wenderlender/Desktop/Chess/Server_Interface.h"
 
-int main() {
-    ChessServer server;
+int main(int argc, char* argv[]) {
+    // --sharded: every game lives on the event loop of one core
+    // --io-threads=N: number of threads serving HTTP connections
+    // --rate-limit=/endpoint:RATE:BURST: per-player requests per second and burst size (RATE 0 disables)
+    // --hibernate-after=SECONDS: idle games are kept only as position and move log (0 disables)
+    // --trace=FILE: write spans of sampled requests to FILE in Chrome trace-event JSON
+    // --trace-sample=N: trace one request in N (default 100)
+    // --storage=SPEC: postgres (default), postgres:CONNECTION, memory or file:PATH (single SQLite file)
+    // --db-connections=N: size of the PostgreSQL connection pool
+    RuntimeMode mode = RuntimeMode::Shared;
+    std::size_t io_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    std::vector<std::pair<std::string, RateLimit>> rate_limits;
+    std::chrono::seconds hibernate_after = Games_Manager::kDefaultHibernateAfter;
+    std::string trace_path;
+    std::uint32_t trace_sample = 100;
+    std::string storage_spec = "postgres";
+    std::size_t db_connections = kDefaultDatabaseConnections;
+    const char* usage = "Usage: Chess [--sharded] [--io-threads=N] [--rate-limit=/endpoint:RATE:BURST]... "
+                        "[--hibernate-after=SECONDS] [--trace=FILE] [--trace-sample=N] [--storage=SPEC] "
+                        "[--db-connections=N]";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const std::string& prefix) { return arg.substr(prefix.size()); };
+        // число целиком и в допустимых пределах: "8x" и "-1" не должны молча превращаться в настройку
+        auto integer = [](const std::string& text, long min) {
+            std::size_t used = 0;
+            long number = std::stol(text, &used);
+            if (used != text.size() || number < min) {
+                throw std::out_of_range(text);
+            }
+            return number;
+        };
+        auto real = [](const std::string& text, double min) {
+            std::size_t used = 0;
+            double number = std::stod(text, &used);
+            if (used != text.size() || !(number >= min)) {
+                throw std::out_of_range(text);
+            }
+            return number;
+        };
+        try {
+            if (arg == "--sharded") {
+                mode = RuntimeMode::Sharded;
+            } else if (arg.starts_with("--io-threads=")) {
+                io_threads = static_cast<std::size_t>(integer(value("--io-threads="), 1));
+            } else if (arg.starts_with("--hibernate-after=")) {
+                hibernate_after = std::chrono::seconds(integer(value("--hibernate-after="), 0));
+            } else if (arg.starts_with("--trace=")) {
+                trace_path = value("--trace=");
+            } else if (arg.starts_with("--trace-sample=")) {
+                trace_sample = static_cast<std::uint32_t>(integer(value("--trace-sample="), 1));
+            } else if (arg.starts_with("--storage=")) {
+                storage_spec = value("--storage=");
+            } else if (arg.starts_with("--db-connections=")) {
+                db_connections = static_cast<std::size_t>(integer(value("--db-connections="), 1));
+            } else if (arg.starts_with("--rate-limit=")) {
+                std::string spec = value("--rate-limit=");
+                auto first = spec.find(':');
+                auto second = first == std::string::npos ? std::string::npos : spec.find(':', first + 1);
+                if (first == 0 || second == std::string::npos) {
+                    std::cerr << "❌ Expected --rate-limit=/endpoint:RATE:BURST, got " << arg << std::endl;
+                    std::cerr << usage << std::endl;
+                    return 1;
+                }
+                rate_limits.emplace_back(spec.substr(0, first),
+                                         RateLimit{real(spec.substr(first + 1, second - first - 1), 0),
+                                                   real(spec.substr(second + 1), 1)});
+            } else {
+                std::cerr << "❌ Unknown option " << arg << std::endl;
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "❌ Invalid value in " << arg << std::endl;
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+
+    if (!trace_path.empty()) {
+        try {
+            Tracer::Instance().Start(trace_path, trace_sample);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-    // Running the server in a separate thread
-    std::thread server_thread(&ChessServer::runServer, &server);
+    std::shared_ptr<Storage> storage;
+    try {
+        storage = OpenStorage(storage_spec, db_connections);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
 
-    // Optional: we give the server time to start
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    ChessServer server(mode, hibernate_after, storage);
+    for (const auto& [endpoint, limit] : rate_limits) {
+        server.SetRateLimit(endpoint, limit);
+    }
 
     try {
-        // Waiting for the server to shut down (usually the server will not shut down on its own)
-        server_thread.join();
+        // The server runs on this thread until it is stopped
+        server.runServer(io_threads);
     } catch (const std::exception& e) {
         std::cerr << "❌ Error: " << e.what() << std::endl;
         return 1;
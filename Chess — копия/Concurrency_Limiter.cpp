@@ -0,0 +1,111 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Concurrency_Limiter.h"
+
+#include <algorithm>
+#include <utility>
+
+ConcurrencyLimiter::Permit::Permit(ConcurrencyLimiter* limiter, RequestPriority priority)
+    : limiter_(limiter), priority_(priority), start_(std::chrono::steady_clock::now()) {}
+
+ConcurrencyLimiter::Permit::Permit(Permit&& other) noexcept
+    : limiter_(std::exchange(other.limiter_, nullptr)), priority_(other.priority_), start_(other.start_) {}
+
+ConcurrencyLimiter::Permit& ConcurrencyLimiter::Permit::operator=(Permit&& other) noexcept {
+    if (this != &other) {
+        if (limiter_) {
+            limiter_->Release(priority_, std::chrono::steady_clock::now() - start_);
+        }
+        limiter_ = std::exchange(other.limiter_, nullptr);
+        priority_ = other.priority_;
+        start_ = other.start_;
+    }
+    return *this;
+}
+
+ConcurrencyLimiter::Permit::~Permit() {
+    if (limiter_) {
+        limiter_->Release(priority_, std::chrono::steady_clock::now() - start_);
+    }
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter() : ConcurrencyLimiter(Options()) {}
+
+ConcurrencyLimiter::ConcurrencyLimiter(Options options)
+    : options_(options)
+    , limit_(std::clamp(options.initial_limit, options.min_limit, options.max_limit))
+    , window_start_(std::chrono::steady_clock::now())
+    , window_limit_(static_cast<double>(limit_.load())) {}
+
+std::optional<ConcurrencyLimiter::Permit> ConcurrencyLimiter::TryAcquire(RequestPriority priority) {
+    if (priority == RequestPriority::Unlimited) {
+        return Permit::Unlimited();
+    }
+
+    std::size_t threshold = Threshold(priority);
+    std::size_t current = in_flight_.load(std::memory_order_relaxed);
+    do {
+        if (current >= threshold) {
+            shed_[static_cast<std::size_t>(priority)].fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+    } while (!in_flight_.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+
+    std::size_t peak = window_peak_.load(std::memory_order_relaxed);
+    while (peak < current + 1 && !window_peak_.compare_exchange_weak(peak, current + 1, std::memory_order_relaxed)) {
+    }
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+    return Permit(this, priority);
+}
+
+ConcurrencyStats ConcurrencyLimiter::GetStats() const {
+    ConcurrencyStats stats;
+    stats.limit = limit_.load(std::memory_order_relaxed);
+    stats.in_flight = in_flight_.load(std::memory_order_relaxed);
+    stats.admitted = admitted_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < shed_.size(); ++i) {
+        stats.shed[i] = shed_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void ConcurrencyLimiter::Release(RequestPriority priority, std::chrono::steady_clock::duration latency) {
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    if (priority != RequestPriority::Critical) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(window_mutex_);
+    window_overloaded_ = window_overloaded_ || latency > options_.latency_target;
+    if (now - window_start_ < options_.window) {
+        return;
+    }
+
+    // AIMD: медленное окно — сжимаем лимит, иначе растём, но только если лимит действительно упирается
+    std::size_t peak = window_peak_.exchange(in_flight_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    if (window_overloaded_) {
+        window_limit_ *= options_.backoff;
+    } else if (peak * 2 >= limit_.load(std::memory_order_relaxed)) {
+        window_limit_ += 1;
+    }
+    window_limit_ = std::clamp(window_limit_, static_cast<double>(options_.min_limit),
+                               static_cast<double>(options_.max_limit));
+    limit_.store(static_cast<std::size_t>(window_limit_), std::memory_order_relaxed);
+
+    window_start_ = now;
+    window_overloaded_ = false;
+}
+
+std::size_t ConcurrencyLimiter::Threshold(RequestPriority priority) const {
+    std::size_t limit = limit_.load(std::memory_order_relaxed);
+    switch (priority) {
+        case RequestPriority::Critical: return limit;
+        case RequestPriority::Normal: return std::max<std::size_t>(1, limit * 4 / 5);
+        case RequestPriority::Background: return std::max<std::size_t>(1, limit / 2);
+        case RequestPriority::Unlimited: break;
+    }
+    return limit;
+}
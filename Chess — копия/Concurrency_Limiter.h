@@ -0,0 +1,110 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+/*! \brief
+ *   Priority class of a request; lower classes are shed first.
+ */
+enum class RequestPriority {
+    Critical,     ///< Moves; may use the whole limit and drive its adaptation.
+    Normal,       ///< Status queries and move batches.
+    Background,   ///< Work nobody is waiting on interactively (images, diagnostics).
+    Unlimited,    ///< Authentication, long polls and other requests that mostly wait; never counted or shed.
+};
+
+/*! \brief
+ *   Counters collected by ConcurrencyLimiter.
+ */
+struct ConcurrencyStats {
+    std::size_t limit = 0;                   ///< Current concurrency limit.
+    std::size_t in_flight = 0;               ///< Requests holding a permit.
+    std::uint64_t admitted = 0;              ///< Permits handed out.
+    std::array<std::uint64_t, 3> shed{};     ///< Rejected requests by priority (Critical, Normal, Background).
+};
+
+/*!
+ * \class ConcurrencyLimiter
+ * \brief Caps the number of requests in flight and adapts the cap to the observed latency (AIMD).
+ * \details Each admitted request holds a Permit until it is answered. Latencies of Critical requests
+ * are collected in short windows: if any of them exceeded the latency target the limit is multiplied
+ * by the backoff factor, otherwise, if the window actually used at least half of the limit, it grows
+ * by one. Normal and Background requests may only use a fraction of the limit, so under overload
+ * they are shed first and the remaining headroom stays with Critical ones.
+ *
+ * Admission is a single compare-and-swap on the in-flight counter; only the end of a Critical
+ * request takes a short lock to update the window.
+ */
+class ConcurrencyLimiter {
+public:
+    /*! \brief Tuning of the limiter. */
+    struct Options {
+        std::size_t initial_limit = 64;                     ///< Limit before any latency is observed.
+        std::size_t min_limit = 8;                          ///< The limit never drops below this.
+        std::size_t max_limit = 4096;                       ///< The limit never grows above this.
+        std::chrono::milliseconds latency_target{50};       ///< Critical requests slower than this mean overload.
+        std::chrono::milliseconds window{100};              ///< How often the limit is adjusted.
+        double backoff = 0.9;                               ///< Multiplicative decrease factor.
+    };
+
+    /*!
+     * \class Permit
+     * \brief Slot of one admitted request; returned to the limiter on destruction.
+     */
+    class Permit {
+    public:
+        /*! \brief Returns a permit that is not counted, e.g. when no limiter is configured. */
+        static Permit Unlimited() { return Permit(nullptr, RequestPriority::Unlimited); }
+
+        Permit(Permit&& other) noexcept;
+        Permit& operator=(Permit&& other) noexcept;
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+        ~Permit();
+
+    private:
+        friend class ConcurrencyLimiter;
+        Permit(ConcurrencyLimiter* limiter, RequestPriority priority);
+
+        ConcurrencyLimiter* limiter_;                        ///< nullptr for Unlimited or moved-from permits.
+        RequestPriority priority_;                           ///< Class the permit was taken for.
+        std::chrono::steady_clock::time_point start_;        ///< Admission time.
+    };
+
+    ConcurrencyLimiter();
+    explicit ConcurrencyLimiter(Options options);
+
+    /*!
+     * \brief Admits a request if its class still has room.
+     * \param priority Priority class of the request.
+     * \return A permit to hold until the request is answered, or std::nullopt if it must be shed.
+     */
+    std::optional<Permit> TryAcquire(RequestPriority priority);
+
+    ConcurrencyStats GetStats() const;
+
+private:
+    void Release(RequestPriority priority, std::chrono::steady_clock::duration latency);
+    std::size_t Threshold(RequestPriority priority) const;
+
+    Options options_;                                        ///< Tuning.
+    std::atomic<std::size_t> limit_;                         ///< Current limit.
+    std::atomic<std::size_t> in_flight_{0};                  ///< Requests holding a permit.
+    std::atomic<std::size_t> window_peak_{0};                ///< Largest in_flight_ seen in the current window.
+    std::atomic<std::uint64_t> admitted_{0};                 ///< Permits handed out.
+    std::array<std::atomic<std::uint64_t>, 3> shed_{};       ///< Rejections by priority.
+
+    std::mutex window_mutex_;                                ///< Guards the window state below.
+    std::chrono::steady_clock::time_point window_start_;     ///< Start of the current window.
+    double window_limit_;                                    ///< Fractional limit, so that +1 and ×0.9 compose.
+    bool window_overloaded_ = false;                         ///< A Critical request missed the target.
+};
@@ -0,0 +1,147 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Connection_Pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Logger.h"
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), connection_(std::move(other.connection_)), broken_(other.broken_) {
+    other.pool_ = nullptr;
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (pool_ != nullptr && connection_) {
+        pool_->Release(std::move(connection_), broken_);
+    }
+}
+
+ConnectionPool::ConnectionPool(std::string connection_string, std::size_t size,
+                               std::chrono::milliseconds checkout_timeout, Setup setup)
+    : connection_string_(std::move(connection_string)),
+      size_(std::max<std::size_t>(size, 1)),
+      checkout_timeout_(checkout_timeout),
+      setup_(std::move(setup)) {
+    try {
+        idle_.push_back({Open(), std::chrono::steady_clock::now()});
+        open_ = 1;
+        CHESS_LOG_INFO("database connected", {"pool_size", size_});
+    } catch (const std::exception& e) {
+        retry_after_ = std::chrono::steady_clock::now() + kReconnectPause;
+        CHESS_LOG_ERROR("database connection failed", {"error", e.what()});
+    }
+}
+
+ConnectionPool::Lease ConnectionPool::Acquire() {
+    ScopedLatency wait(wait_times_);
+    auto deadline = std::chrono::steady_clock::now() + checkout_timeout_;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (!idle_.empty()) {
+            Idle idle = std::move(idle_.back());
+            idle_.pop_back();
+            lock.unlock();
+
+            // давно не использованное соединение могло быть закрыто сервером или сетью
+            bool stale = std::chrono::steady_clock::now() - idle.since >= kHealthCheckAfter;
+            if (stale ? Healthy(*idle.connection) : idle.connection->is_open()) {
+                return Lease(*this, std::move(idle.connection));
+            }
+            discarded_.fetch_add(1, std::memory_order_relaxed);
+            CHESS_LOG_WARN("database connection failed a health check");
+            idle.connection.reset();
+
+            lock.lock();
+            --open_;
+            continue;
+        }
+
+        bool pausing = std::chrono::steady_clock::now() < retry_after_;
+        if (pausing && open_ == 0) {
+            // после неудачного подключения ждать нечего: занятых соединений нет, отказываем сразу
+            throw std::runtime_error("Database is unavailable");
+        }
+        if (open_ < size_ && !pausing) {
+            ++open_;
+            lock.unlock();
+            try {
+                return Lease(*this, Open());
+            } catch (const std::exception& e) {
+                CHESS_LOG_ERROR("database connection failed", {"error", e.what()});
+                lock.lock();
+                --open_;
+                retry_after_ = std::chrono::steady_clock::now() + kReconnectPause;
+                available_.notify_one();
+                throw;
+            }
+        }
+
+        // в паузе новых соединений не открываем, но занятые ещё вернутся; проснёмся и к её концу
+        auto wake = open_ < size_ ? std::min(deadline, retry_after_) : deadline;
+        bool ready = available_.wait_until(lock, wake, [this]() {
+            return !idle_.empty() ||
+                   (open_ < size_ && (open_ == 0 || std::chrono::steady_clock::now() >= retry_after_));
+        });
+        if (!ready && std::chrono::steady_clock::now() >= deadline) {
+            timeouts_.fetch_add(1, std::memory_order_relaxed);
+            throw std::runtime_error("Timed out waiting for a database connection");
+        }
+    }
+}
+
+ConnectionPoolStats ConnectionPool::Stats() const {
+    ConnectionPoolStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.size = size_;
+        stats.idle = idle_.size();
+        stats.busy = open_ - idle_.size();
+    }
+    stats.opened = opened_.load(std::memory_order_relaxed);
+    stats.discarded = discarded_.load(std::memory_order_relaxed);
+    stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::unique_ptr<pqxx::connection> ConnectionPool::Open() {
+    auto connection = std::make_unique<pqxx::connection>(connection_string_);
+    if (!connection->is_open()) {
+        throw std::runtime_error("Connection to the database is not open");
+    }
+    if (setup_) {
+        setup_(*connection);
+    }
+    opened_.fetch_add(1, std::memory_order_relaxed);
+    return connection;
+}
+
+bool ConnectionPool::Healthy(pqxx::connection& connection) {
+    if (!connection.is_open()) {
+        return false;
+    }
+    try {
+        pqxx::nontransaction probe(connection);
+        probe.exec("SELECT 1");
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void ConnectionPool::Release(std::unique_ptr<pqxx::connection> connection, bool broken) {
+    if (broken || !connection->is_open()) {
+        discarded_.fetch_add(1, std::memory_order_relaxed);
+        // закрытие соединения может ждать сеть, поэтому вне блокировки
+        connection.reset();
+        std::lock_guard<std::mutex> lock(mutex_);
+        --open_;
+    } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+    }
+    available_.notify_one();
+}
@@ -0,0 +1,138 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <pqxx/pqxx>
+#include <string>
+#include <vector>
+
+#include "Metrics.h"
+
+/*! \brief
+ *   State of a connection pool, for monitoring.
+ */
+struct ConnectionPoolStats {
+    std::size_t size = 0;           ///< Largest number of connections.
+    std::size_t idle = 0;           ///< Open connections waiting for a request.
+    std::size_t busy = 0;           ///< Connections checked out or being opened.
+    std::uint64_t opened = 0;       ///< Connections opened since start.
+    std::uint64_t discarded = 0;    ///< Connections closed after failing a health check or a query.
+    std::uint64_t timeouts = 0;     ///< Checkouts that gave up waiting.
+};
+
+/*!
+ * \class ConnectionPool
+ * \brief Bounded pool of PostgreSQL connections shared by the threads that use the database.
+ * \details A thread checks a connection out with Acquire() and gets it back into the pool when the
+ * returned Lease is destroyed; while all connections are busy, Acquire() waits up to the checkout
+ * timeout. Connections are opened lazily, up to the pool size, and every new connection is passed to
+ * the setup function, e.g. to prepare statements, before its first use.
+ *
+ * A connection that failed with pqxx::broken_connection should be marked with Lease::MarkBroken();
+ * it is then closed instead of being returned and the next checkout opens a new one. A connection
+ * idle for longer than the health-check interval is probed with `SELECT 1` before it is handed out.
+ * After a failed connection attempt no new connection is opened for a short pause, so requests do not
+ * queue up behind connection timeouts while the database is down. Checkouts during the pause still get
+ * connections that are returned to the pool, and fail at once only if the pool has no connection left.
+ */
+class ConnectionPool {
+public:
+    using Setup = std::function<void(pqxx::connection&)>;
+
+    static constexpr std::chrono::milliseconds kDefaultCheckoutTimeout{5000};    ///< Longest wait for a connection.
+    static constexpr std::chrono::seconds kHealthCheckAfter{30};                 ///< Idle time before a probe.
+    static constexpr std::chrono::seconds kReconnectPause{1};                    ///< Pause after a failed connection.
+
+    /*!
+     * \class Lease
+     * \brief Connection checked out of the pool; returns it on destruction.
+     * \details Must not outlive the pool.
+     */
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        pqxx::connection& operator*() const { return *connection_; }
+        pqxx::connection* operator->() const { return connection_.get(); }
+
+        /*! \brief Closes the connection on return instead of reusing it. */
+        void MarkBroken() { broken_ = true; }
+
+    private:
+        friend class ConnectionPool;
+
+        Lease(ConnectionPool& pool, std::unique_ptr<pqxx::connection> connection)
+            : pool_(&pool), connection_(std::move(connection)) {}
+
+        ConnectionPool* pool_;                           ///< Owner of the connection.
+        std::unique_ptr<pqxx::connection> connection_;   ///< Checked-out connection.
+        bool broken_ = false;                            ///< Set by MarkBroken().
+    };
+
+    /*!
+     * \brief Creates the pool and opens its first connection to check the address.
+     * \details A failure is logged, not thrown: the server starts, and connections are retried on use.
+     * \param connection_string PostgreSQL connection string.
+     * \param size Largest number of connections; at least 1.
+     * \param checkout_timeout Longest wait of Acquire() for a free connection.
+     * \param setup Called with every newly opened connection; may be empty.
+     */
+    ConnectionPool(std::string connection_string, std::size_t size,
+                   std::chrono::milliseconds checkout_timeout = kDefaultCheckoutTimeout, Setup setup = {});
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /*!
+     * \brief Checks a healthy connection out, opening one if there is room.
+     * \throws std::runtime_error if no connection becomes free within the checkout timeout, a new
+     *         connection cannot be opened, or the pool is empty during the pause after a failed attempt.
+     */
+    Lease Acquire();
+
+    /*! \brief Returns the pool state. */
+    ConnectionPoolStats Stats() const;
+
+    /*! \brief Returns the time Acquire() took, including opening and probing connections. */
+    const LatencyHistogram& WaitTimes() const { return wait_times_; }
+
+private:
+    struct Idle {
+        std::unique_ptr<pqxx::connection> connection;       ///< Open connection.
+        std::chrono::steady_clock::time_point since;        ///< When it was returned.
+    };
+
+    std::unique_ptr<pqxx::connection> Open();
+    static bool Healthy(pqxx::connection& connection);
+    void Release(std::unique_ptr<pqxx::connection> connection, bool broken);
+
+    const std::string connection_string_;                ///< Where to connect.
+    const std::size_t size_;                             ///< Largest number of connections.
+    const std::chrono::milliseconds checkout_timeout_;   ///< Longest wait for a connection.
+    const Setup setup_;                                  ///< Prepares new connections.
+
+    mutable std::mutex mutex_;                           ///< Guards the fields below.
+    std::condition_variable available_;                  ///< Signalled when a connection or a slot frees up.
+    std::vector<Idle> idle_;                             ///< Connections ready for use, newest last.
+    std::size_t open_ = 0;                               ///< Connections idle, checked out or being opened.
+    std::chrono::steady_clock::time_point retry_after_;  ///< No new connections before this time.
+
+    LatencyHistogram wait_times_;                        ///< Durations of Acquire().
+    std::atomic<std::uint64_t> opened_{0};               ///< Connections opened.
+    std::atomic<std::uint64_t> discarded_{0};            ///< Connections closed as broken.
+    std::atomic<std::uint64_t> timeouts_{0};             ///< Checkouts that timed out.
+};
@@ -4,45 +4,100 @@
 
 #include "DataBase.h"
 
-DataBase::DataBase(const std::string& conn_str) {
+#include "Logger.h"
+#include "Tracing.h"
+
+namespace {
+
+/*! \brief Statement prepared on every connection of the pool. */
+struct PreparedStatement {
+    const char* name;   ///< Name used to execute the statement.
+    const char* sql;    ///< Statement text with $n parameters.
+};
+
+// разбираются и планируются один раз на соединение, а не на каждый ход
+constexpr PreparedStatement kStatements[] = {
+    {"insert_player", "INSERT INTO \"User\" (user_id, username, game_id, userColour) VALUES ($1, $2, $3, $4)"},
+    {"player_by_username", "SELECT user_id FROM \"User\" WHERE username = $1"},
+    {"game_by_username", "SELECT game_id FROM \"User\" WHERE username = $1"},
+    {"delete_player", "DELETE FROM \"User\" WHERE username = $1"},
+    {"game_by_player", "SELECT game_id FROM \"User\" WHERE user_id = $1 LIMIT 1"},
+    {"create_game", "INSERT INTO GameHistory (game_id, board_states) VALUES ($1, ARRAY[$2::text])"},
+    {"update_history", "UPDATE GameHistory SET board_states = ARRAY[$2::text] WHERE game_id = $1"},
+    {"board_history", "SELECT board_states FROM GameHistory WHERE game_id = $1"},
+    {"delete_game_players", "DELETE FROM \"User\" WHERE game_id = $1"},
+    {"delete_game", "DELETE FROM GameHistory WHERE game_id = $1"},
+    {"save_snapshot", "INSERT INTO GameSnapshot (game_id, ply, board_state, moves) VALUES ($1, $2, $3, $4) "
+                      "ON CONFLICT (game_id) DO UPDATE SET ply = EXCLUDED.ply, board_state = EXCLUDED.board_state, "
+                      "moves = EXCLUDED.moves"},
+    {"load_snapshot", "SELECT ply, board_state, moves FROM GameSnapshot WHERE game_id = $1"},
+    {"delete_snapshot", "DELETE FROM GameSnapshot WHERE game_id = $1"},
+};
+
+/*! \brief Table of hibernated games; it is not part of the original schema, so the server creates it. */
+constexpr const char* kSnapshotSchema =
+    "CREATE TABLE IF NOT EXISTS GameSnapshot ("
+    "  game_id INTEGER PRIMARY KEY,"
+    "  ply INTEGER NOT NULL,"
+    "  board_state TEXT NOT NULL,"
+    "  moves TEXT NOT NULL)";
+
+void PrepareStatements(pqxx::connection& connection) {
+    // запрос можно подготовить только к существующей таблице
     try {
-        conn_ = std::make_unique<pqxx::connection>(conn_str);
-        if (conn_->is_open()) {
-            std::cout << "The connection is successful." << std::endl;
-        } else {
-            std::cerr << "Connection error." << std::endl;
-            conn_.reset();
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "An exception was raised when connecting: " << e.what() << std::endl;
-        conn_.reset();
+        pqxx::nontransaction txn(connection);
+        txn.exec(kSnapshotSchema);
+    } catch (const pqxx::sql_error& e) {
+        // два новых соединения могли создавать таблицу одновременно; если её нет, prepare ниже сообщит об ошибке
+        CHESS_LOG_DEBUG("snapshot table not created", {"error", e.what()});
+    }
+    for (const PreparedStatement& statement : kStatements) {
+        connection.prepare(statement.name, statement.sql);
     }
 }
 
-pqxx::result DataBase::Execute(const std::string& query) {
-    try {
-        if (!conn_ || !conn_->is_open()) {
-            throw std::runtime_error("Connection to the database is not established");
-        }
+}
+
+DataBase::DataBase(const std::string& conn_str, std::size_t connections)
+    : pool_(conn_str, connections, ConnectionPool::kDefaultCheckoutTimeout, PrepareStatements) {}
 
-        pqxx::work txn(*conn_);
-        pqxx::result res = txn.exec(query);
+pqxx::result DataBase::Transact(const char* name, const std::function<pqxx::result(pqxx::work&)>& statements) {
+    TraceSpan connection_wait("db connection wait", "db");
+    ConnectionPool::Lease connection = pool_.Acquire();
+    connection_wait.End();
+    TraceSpan query(name, "db");
+    try {
+        ScopedLatency round_trip(round_trips_);
+        pqxx::work txn(*connection);
+        pqxx::result res = statements(txn);
         txn.commit();
+        return res;
+    } catch (const pqxx::broken_connection&) {
+        // соединение больше не годится: пул закроет его и откроет новое
+        connection.MarkBroken();
+        throw;
+    }
+}
+
+pqxx::result DataBase::Execute(const std::string& query) {
+    try {
+        pqxx::result res = Transact("Execute", [&](pqxx::work& txn) { return txn.exec(query); });
 
-        for (const auto& row : res) {
-            if (row.size() > 0) {
-                std::cout << "Row: ";
+        // строки результата нужны только при отладке, в обычной сборке цикл исчезает целиком
+        if constexpr (LogEnabled(LogLevel::Trace)) {
+            for (const auto& row : res) {
+                std::string columns;
                 for (std::size_t i = 0; i < res.columns(); ++i) {
-                    std::cout << res.column_name(i) << "=" << row[i].c_str() << " ";
+                    columns += std::string(i > 0 ? " " : "") + res.column_name(i) + "=" + row[i].c_str();
                 }
-                std::cout << std::endl;
+                CHESS_LOG_TRACE("query row", {"columns", columns});
             }
         }
 
         return res;
     }
     catch (const std::exception &e) {
-        std::cerr << "Request execution error: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("query failed", {"error", e.what()});
         throw;
     }
 }
@@ -51,167 +106,211 @@ std::string DataBase::DetermineUserColor(int user_id) {
     return (user_id % 2 == 0) ? "black" : "white";
 }
 
-int DataBase::InsertIDToDataBase(int user_id, const std::string& username, int game_id) {
+int DataBase::InsertIDToDataBase(int user_id, const std::string& username, int game_id, const std::string& user_colour) {
     try {
-        if (!conn_ || !conn_->is_open()) {
-            std::cerr << "Connection to the database is not established" << std::endl;
-            return 1;
-        }
-
-        std::string userColour = (user_id % 2 == 0) ? "black" : "white";
+        std::string userColour = user_colour.empty() ? DetermineUserColor(user_id)
+                                 : (user_colour == "Black" ? "black" : "white");
 
-        std::string query =
-            "INSERT INTO \"User\" (user_id, username, game_id, userColour) VALUES (" +
-            std::to_string(user_id) + ", " +
-            "'" + conn_->esc(username) + "', " +
-            std::to_string(game_id) + ", '" +
-            userColour + "');";
-
-        pqxx::work txn(*conn_);
-        txn.exec(query);
-        txn.commit();
+        Transact("InsertIDToDataBase", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"insert_player"}, pqxx::params{user_id, username, game_id, userColour});
+        });
 
         return 0;
     } catch (const std::exception& e) {
-        std::cerr << "User insertion error:" << e.what() << std::endl;
+        CHESS_LOG_ERROR("player insertion failed", {"player_id", user_id}, {"game_id", game_id}, {"error", e.what()});
         return 1;
     }
 }
 
 void DataBase::GetPlayerID(const std::string& username) {
     try {
-        std::string query = "SELECT user_id FROM \"User\" WHERE username = '" + conn_->esc(username) + "';";
-        pqxx::result res = Execute(query);
+        pqxx::result res = Transact("GetPlayerID", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"player_by_username"}, pqxx::params{username});
+        });
 
         if (!res.empty()) {
             int user_id = res[0]["user_id"].as<int>();
-            std::cout << "User ID:" << username << " это " << user_id << std::endl;
+            CHESS_LOG_DEBUG("player found", {"username", username}, {"player_id", user_id});
         } else {
-            std::cout << "The user was not found: " << username << std::endl;
+            CHESS_LOG_DEBUG("player not found", {"username", username});
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error in finding the user: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("player lookup failed", {"username", username}, {"error", e.what()});
     }
 }
 
 void DataBase::GetGameID(const std::string& username) {
     try {
-        std::string query = "SELECT game_id FROM \"User\" WHERE username = '" + conn_->esc(username) + "';";
-        pqxx::result res = Execute(query);
+        pqxx::result res = Transact("GetGameID", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"game_by_username"}, pqxx::params{username});
+        });
 
         if (!res.empty()) {
             int game_id = res[0]["game_id"].as<int>();
-            std::cout << "Game ID for player " << username << " is " << game_id << std::endl;
+            CHESS_LOG_DEBUG("game of player found", {"username", username}, {"game_id", game_id});
         } else {
-            std::cout << "User not found: " << username << std::endl;
+            CHESS_LOG_DEBUG("player not found", {"username", username});
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error in GetGameID: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("game lookup failed", {"username", username}, {"error", e.what()});
     }
 }
 
 int DataBase::DeleteIDFromDataBase(const std::string& username) {
     try {
-        std::string query = "DELETE FROM \"User\" WHERE username = '" + conn_->esc(username) + "';";
-        pqxx::work txn(*conn_);
-        txn.exec(query);
-        txn.commit();
-        std::cout << "User " << username << " deleted successfully." << std::endl;
+        Transact("DeleteIDFromDataBase", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"delete_player"}, pqxx::params{username});
+        });
+        CHESS_LOG_INFO("player deleted", {"username", username});
         return 0;
     } catch (const std::exception& e) {
-        std::cerr << "Error deleting user: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("player deletion failed", {"username", username}, {"error", e.what()});
         return 1;
     }
 }
 
 void DataBase::CreateNewGame(int game_id, const std::string& initial_board) {
     try {
-        if (!conn_ || !conn_->is_open()) {
-            throw std::runtime_error("Connection to the database is not established");
-        }
-
-        pqxx::work txn(*conn_);
-        std::string query = "INSERT INTO GameHistory (game_id, board_states) VALUES (" +
-                            txn.esc(std::to_string(game_id)) + ", ARRAY[" +
-                            txn.quote(initial_board) + "])";
-        txn.exec(query);
-        txn.commit();
+        Transact("CreateNewGame", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"create_game"}, pqxx::params{game_id, initial_board});
+        });
 
-        std::cout << "A new game has been created with game_id:" << game_id << std::endl;
+        CHESS_LOG_INFO("game row created", {"game_id", game_id});
     } catch (const std::exception &e) {
-        std::cerr << "Error when creating a new game: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("game row creation failed", {"game_id", game_id}, {"error", e.what()});
         throw;
     }
 }
 
 void DataBase::UpdateGameHistory(int game_id, const std::string& new_board_state) {
     try {
-        if (!conn_ || !conn_->is_open()) {
-            throw std::runtime_error("Connection to the database is not established");
-        }
-
-        pqxx::work txn(*conn_);
+        Transact("UpdateGameHistory", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"update_history"}, pqxx::params{game_id, new_board_state});
+        });
 
-        std::string query =
-            "UPDATE GameHistory "
-            "SET board_states = ARRAY[" + txn.quote(new_board_state) + "] "
-            "WHERE game_id = " + txn.esc(std::to_string(game_id));
-
-        txn.exec(query);
-        txn.commit();
+        CHESS_LOG_DEBUG("game history updated", {"game_id", game_id});
+    } catch (const std::exception &e) {
+        CHESS_LOG_ERROR("game history update failed", {"game_id", game_id}, {"error", e.what()});
+        throw;
+    }
+}
 
-        std::cout << "Game history is overwritten for game_id: " << game_id << std::endl;
+void DataBase::UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) {
+    try {
+        // одна транзакция и один коммит на всю пачку ходов
+        Transact("UpdateGameHistories", [&](pqxx::work& txn) {
+            pqxx::result res;
+            for (const auto& [game_id, board_state] : updates) {
+                res = txn.exec(pqxx::prepped{"update_history"}, pqxx::params{game_id, board_state});
+            }
+            return res;
+        });
     } catch (const std::exception &e) {
-        std::cerr << "Error updating the game history: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("game history batch failed", {"games", updates.size()}, {"error", e.what()});
         throw;
     }
 }
 
 int DataBase::DeleteGame(int game_id) {
     try {
-        if (!conn_ || !conn_->is_open()) {
-            throw std::runtime_error("Connection to the database is not established");
-        }
-
-        pqxx::work txn(*conn_);
-
-        std::string deleteUsersQuery =
-            "DELETE FROM \"User\" WHERE game_id = " + txn.esc(std::to_string(game_id));
-        txn.exec(deleteUsersQuery);
+        Transact("DeleteGame", [&](pqxx::work& txn) {
+            txn.exec(pqxx::prepped{"delete_game_players"}, pqxx::params{game_id});
+            txn.exec(pqxx::prepped{"delete_snapshot"}, pqxx::params{game_id});
+            return txn.exec(pqxx::prepped{"delete_game"}, pqxx::params{game_id});
+        });
 
-        std::string deleteGameQuery =
-            "DELETE FROM GameHistory WHERE game_id = " + txn.esc(std::to_string(game_id));
-        txn.exec(deleteGameQuery);
-
-        txn.commit();
-
-        std::cout << "Playing with game_id " << game_id << " successfully deleted" << std::endl;
+        CHESS_LOG_INFO("game deleted", {"game_id", game_id});
         return 0;
     } catch (const std::exception &e) {
-        std::cerr << "Error deleting the game: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("game deletion failed", {"game_id", game_id}, {"error", e.what()});
         return 1;
     }
 }
 
 int DataBase::GetGameIDByPlayerID(int user_id) {
     try {
-        if (!conn_ || !conn_->is_open()) {
-            throw std::runtime_error("Connection to the database is not established");
-        }
-
-        std::string query =
-            "SELECT game_id FROM \"User\" WHERE user_id = " + std::to_string(user_id) + " LIMIT 1;";
-
-        pqxx::result res = Execute(query);
+        pqxx::result res = Transact("GetGameIDByPlayerID", [&](pqxx::work& txn) {
+            return txn.exec(pqxx::prepped{"game_by_player"}, pqxx::params{user_id});
+        });
 
         if (!res.empty()){
             return res[0]["game_id"].as<int>();
         } else {
-            std::cerr << "⚠️ User with user_id= " << user_id << " not found in the database." << std::endl;
+            CHESS_LOG_WARN("player not found", {"player_id", user_id});
             return -1;
         }
     } catch (const std::exception &e) {
-        std::cerr << "❌ Error in GetGameIDByPlayerID: " << e.what() << std::endl;
+        CHESS_LOG_ERROR("game lookup failed", {"player_id", user_id}, {"error", e.what()});
         return -1;
     }
-}
\ No newline at end of file
+}
+
+std::string DataBase::GetBoardHistory(int game_id) {
+    pqxx::result r = Transact("GetBoardHistory", [&](pqxx::work& txn) {
+        return txn.exec(pqxx::prepped{"board_history"}, pqxx::params{game_id});
+    });
+
+    if (!r.empty() && !r[0][0].is_null()) {
+        return r[0][0].as<std::string>();
+    }
+    return {};
+}
+
+void DataBase::SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) {
+    try {
+        Transact("SaveSnapshots", [&](pqxx::work& txn) {
+            pqxx::result res;
+            for (const auto& [game_id, snapshot] : snapshots) {
+                res = txn.exec(pqxx::prepped{"save_snapshot"},
+                               pqxx::params{game_id, snapshot.ply, snapshot.board_state, EncodeMoves(snapshot.moves)});
+            }
+            return res;
+        });
+    } catch (const std::exception &e) {
+        CHESS_LOG_ERROR("snapshot batch failed", {"games", snapshots.size()}, {"error", e.what()});
+        throw;
+    }
+}
+
+std::optional<GameSnapshot> DataBase::LoadSnapshot(int game_id) {
+    pqxx::result r = Transact("LoadSnapshot", [&](pqxx::work& txn) {
+        return txn.exec(pqxx::prepped{"load_snapshot"}, pqxx::params{game_id});
+    });
+
+    if (r.empty()) {
+        return std::nullopt;
+    }
+    GameSnapshot snapshot;
+    snapshot.ply = r[0]["ply"].as<int>();
+    snapshot.board_state = r[0]["board_state"].as<std::string>();
+    snapshot.moves = DecodeMoves(r[0]["moves"].as<std::string>());
+    return snapshot;
+}
+
+void DataBase::DeleteSnapshots(const std::vector<int>& game_ids) {
+    Transact("DeleteSnapshots", [&](pqxx::work& txn) {
+        pqxx::result res;
+        for (int game_id : game_ids) {
+            res = txn.exec(pqxx::prepped{"delete_snapshot"}, pqxx::params{game_id});
+        }
+        return res;
+    });
+}
+
+void DataBase::ReportMetrics(MetricsWriter& metrics) const {
+    ConnectionPoolStats stats = pool_.Stats();
+    metrics.Gauge("chess_db_pool_size", "Largest number of database connections.", {},
+                  static_cast<double>(stats.size));
+    metrics.Gauge("chess_db_pool_connections", "Database connections by state.", {{"state", "idle"}},
+                  static_cast<double>(stats.idle));
+    metrics.Gauge("chess_db_pool_connections", "Database connections by state.", {{"state", "busy"}},
+                  static_cast<double>(stats.busy));
+    metrics.Counter("chess_db_pool_opened_total", "Database connections opened.", {},
+                    static_cast<double>(stats.opened));
+    metrics.Counter("chess_db_pool_discarded_total", "Database connections closed after a failure.", {},
+                    static_cast<double>(stats.discarded));
+    metrics.Counter("chess_db_pool_timeouts_total", "Checkouts that timed out waiting for a connection.", {},
+                    static_cast<double>(stats.timeouts));
+    metrics.Histogram("chess_db_pool_wait_duration_seconds", "Time to check a connection out of the pool.", {},
+                      pool_.WaitTimes().Snapshot());
+}
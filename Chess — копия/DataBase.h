@@ -4,25 +4,35 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <pqxx/pqxx>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "Connection_Pool.h"
+#include "Storage.h"
 
 /**
  * @class DataBase
  * @brief Class for working with PostgreSQL database.
  *
  * Provides connection handling, SQL query execution, and management of players and games.
+ * The PostgreSQL implementation of Storage.
+ *
+ * Every call checks a connection out of a ConnectionPool for the duration of its transaction,
+ * so concurrent requests use the database in parallel, up to the size of the pool. The queries
+ * are prepared once on every connection and run with bound parameters; only Execute() sends SQL text.
  */
-class DataBase {
+class DataBase : public Storage {
 public:
   /**
-   * @brief Pointer to the database connection.
-   *
-   * A shared_ptr is used to safely share the connection
-   * between multiple objects or threads.
+   * @brief Connection string used when none is given.
    */
-  std::shared_ptr<pqxx::connection> conn_; ///< Pointer to the PostgreSQL connection.
+  static constexpr const char* kDefaultConnection = "host=localhost port=5433 dbname=mydb user=myuser password=mypassword";
 
   /**
    * @brief Inserts a user into the database and returns their ID.
@@ -32,9 +42,10 @@ public:
    * @param user_id Unique identifier of the user.
    * @param username Username of the player.
    * @param game_id Unique identifier of the game.
+   * @param user_colour Colour of the player ("White" or "Black"); if empty it is derived from the ID.
    * @return The ID assigned to the user.
    */
-  int InsertIDToDataBase(int user_id, const std::string& username, int game_id);
+  int InsertIDToDataBase(int user_id, const std::string& username, int game_id, const std::string& user_colour = "") override;
 
   /**
    * @brief Retrieves the player ID by username.
@@ -56,7 +67,7 @@ public:
    * @param username Username of the player.
    * @return Operation result code (0 — success, 1 — error).
    */
-  int DeleteIDFromDataBase(const std::string& username);
+  int DeleteIDFromDataBase(const std::string& username) override;
 
   /**
    * @brief Determines the player's color (white or black) by their ID.
@@ -72,7 +83,7 @@ public:
    * @param game_id Unique identifier of the game.
    * @param initial_board Initial state of the chessboard.
    */
-  void CreateNewGame(int game_id, const std::string& initial_board);
+  void CreateNewGame(int game_id, const std::string& initial_board) override;
 
   /**
    * @brief Updates the game history.
@@ -80,7 +91,14 @@ public:
    * @param game_id Unique identifier of the game.
    * @param new_board_state New board state after a move.
    */
-  void UpdateGameHistory(int game_id, const std::string& new_board_state);
+  void UpdateGameHistory(int game_id, const std::string& new_board_state) override;
+
+  /**
+   * @brief Updates the history of several games in a single transaction.
+   *
+   * @param updates Pairs of game ID and new board state.
+   */
+  void UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) override;
 
   /**
    * @brief Deletes a game from the database.
@@ -88,19 +106,39 @@ public:
    * @param game_id Unique identifier of the game.
    * @return Operation result code (0 — success, 1 — error).
    */
-  int DeleteGame(int game_id);
+  int DeleteGame(int game_id) override;
+  /**
+   * @brief Stores the snapshots of hibernated games in a single transaction.
+   *
+   * @param snapshots Pairs of game ID and snapshot; an existing snapshot of the same game is replaced.
+   */
+  void SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) override;
+  /**
+   * @brief Retrieves the snapshot of a hibernated game.
+   *
+   * @param game_id Unique identifier of the game.
+   * @return The snapshot, or std::nullopt if none is stored.
+   */
+  std::optional<GameSnapshot> LoadSnapshot(int game_id) override;
+  /**
+   * @brief Deletes the snapshots of several games in a single transaction.
+   *
+   * @param game_ids Unique identifiers of the games.
+   */
+  void DeleteSnapshots(const std::vector<int>& game_ids) override;
 
   /**
-   * @brief Constructor. Establishes a connection to the PostgreSQL database.
+   * @brief Constructor. Creates the connection pool and opens its first connection.
    *
    * @param conn_str PostgreSQL connection string.
+   * @param connections Largest number of connections open at once.
    */
-  explicit DataBase(const std::string& conn_str);
+  explicit DataBase(const std::string& conn_str, std::size_t connections = kDefaultDatabaseConnections);
 
   /**
-   * @brief Destructor. Automatically closes the connection.
+   * @brief Destructor. Automatically closes the connections.
    */
-  ~DataBase() = default;
+  ~DataBase() override = default;
 
   /**
    * @brief Executes an SQL query and returns the result.
@@ -116,5 +154,37 @@ public:
    * @param user_id Unique identifier of the player.
    * @return Unique identifier of the game.
    */
-  int GetGameIDByPlayerID(int user_id);
+  int GetGameIDByPlayerID(int user_id) override;
+
+  /**
+   * @brief Returns the stored board history of a game.
+   *
+   * @param game_id Unique identifier of the game.
+   * @return PostgreSQL array of board states as text, empty if the game has no history.
+   */
+  std::string GetBoardHistory(int game_id) override;
+
+  /**
+   * @brief Adds the state and checkout wait times of the connection pool to a scrape.
+   */
+  void ReportMetrics(MetricsWriter& metrics) const override;
+
+private:
+  /**
+   * @brief Runs statements in a transaction on a pooled connection and commits it.
+   *
+   * A connection that breaks during the transaction is not returned to the pool.
+   *
+   * @param name Name of the operation in traces.
+   * @param statements Receives the transaction and returns the result of its last statement.
+   */
+  pqxx::result Transact(const char* name, const std::function<pqxx::result(pqxx::work&)>& statements);
+
+  /**
+   * @brief Connections to the database.
+   *
+   * A pqxx::connection must not be used by two threads at once, so every
+   * transaction checks one out for its duration only.
+   */
+  ConnectionPool pool_;
 };
\ No newline at end of file
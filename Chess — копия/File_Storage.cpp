@@ -0,0 +1,334 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "File_Storage.h"
+
+#include <sqlite3.h>
+
+#include <stdexcept>
+
+#include "Logger.h"
+#include "Tracing.h"
+
+namespace {
+
+constexpr const char* kSchema =
+    "CREATE TABLE IF NOT EXISTS \"User\" ("
+    "  user_id INTEGER PRIMARY KEY,"
+    "  username TEXT NOT NULL,"
+    "  game_id INTEGER NOT NULL,"
+    "  userColour TEXT NOT NULL);"
+    "CREATE INDEX IF NOT EXISTS user_game_id ON \"User\" (game_id);"
+    "CREATE INDEX IF NOT EXISTS user_username ON \"User\" (username);"
+    "CREATE TABLE IF NOT EXISTS GameHistory ("
+    "  game_id INTEGER PRIMARY KEY,"
+    "  board_states TEXT NOT NULL);"
+    "CREATE TABLE IF NOT EXISTS GameSnapshot ("
+    "  game_id INTEGER PRIMARY KEY,"
+    "  ply INTEGER NOT NULL,"
+    "  board_state TEXT NOT NULL,"
+    "  moves TEXT NOT NULL);";
+
+constexpr int kBusyTimeoutMs = 5000;   ///< Wait for a lock held by another process on the file.
+
+/*! \brief Resets a statement and its parameters when the scope ends, ready for the next call. */
+class StatementReset {
+public:
+    explicit StatementReset(sqlite3_stmt* statement) : statement_(statement) {}
+    ~StatementReset() {
+        sqlite3_reset(statement_);
+        sqlite3_clear_bindings(statement_);
+    }
+
+    StatementReset(const StatementReset&) = delete;
+    StatementReset& operator=(const StatementReset&) = delete;
+
+private:
+    sqlite3_stmt* statement_;
+};
+
+void BindText(sqlite3_stmt* statement, int index, const std::string& text) {
+    sqlite3_bind_text(statement, index, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+}
+
+}
+
+FileStorage::FileStorage(const std::string& path) {
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(path.c_str(), &db_, flags, nullptr) != SQLITE_OK) {
+        std::string error = db_ != nullptr ? sqlite3_errmsg(db_) : "out of memory";
+        Close();
+        throw std::runtime_error("Cannot open storage file " + path + ": " + error);
+    }
+    try {
+        sqlite3_busy_timeout(db_, kBusyTimeoutMs);
+        Exec("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
+        Exec(kSchema);
+        insert_player_ = Prepare("INSERT INTO \"User\" (user_id, username, game_id, userColour) VALUES (?, ?, ?, ?)");
+        delete_player_ = Prepare("DELETE FROM \"User\" WHERE username = ?");
+        select_game_ = Prepare("SELECT game_id FROM \"User\" WHERE user_id = ? LIMIT 1");
+        insert_game_ = Prepare("INSERT INTO GameHistory (game_id, board_states) VALUES (?, ?)");
+        update_game_ = Prepare("UPDATE GameHistory SET board_states = ? WHERE game_id = ?");
+        select_history_ = Prepare("SELECT board_states FROM GameHistory WHERE game_id = ?");
+        delete_players_ = Prepare("DELETE FROM \"User\" WHERE game_id = ?");
+        delete_game_ = Prepare("DELETE FROM GameHistory WHERE game_id = ?");
+        save_snapshot_ = Prepare("INSERT OR REPLACE INTO GameSnapshot (game_id, ply, board_state, moves) VALUES (?, ?, ?, ?)");
+        select_snapshot_ = Prepare("SELECT ply, board_state, moves FROM GameSnapshot WHERE game_id = ?");
+        delete_snapshot_ = Prepare("DELETE FROM GameSnapshot WHERE game_id = ?");
+    } catch (const std::exception& e) {
+        Close();
+        throw std::runtime_error("Cannot open storage file " + path + ": " + e.what());
+    }
+    CHESS_LOG_INFO("storage file opened", {"path", path});
+}
+
+FileStorage::~FileStorage() {
+    Close();
+}
+
+void FileStorage::Close() {
+    for (sqlite3_stmt* statement : {insert_player_, delete_player_, select_game_, insert_game_, update_game_,
+                                    select_history_, delete_players_, delete_game_, save_snapshot_,
+                                    select_snapshot_, delete_snapshot_}) {
+        sqlite3_finalize(statement);
+    }
+    sqlite3_close(db_);
+    db_ = nullptr;
+}
+
+void FileStorage::Exec(const char* sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        std::string message = error != nullptr ? error : sqlite3_errmsg(db_);
+        sqlite3_free(error);
+        throw std::runtime_error(message);
+    }
+}
+
+sqlite3_stmt* FileStorage::Prepare(const char* sql) {
+    sqlite3_stmt* statement = nullptr;
+    if (sqlite3_prepare_v3(db_, sql, -1, SQLITE_PREPARE_PERSISTENT, &statement, nullptr) != SQLITE_OK) {
+        throw std::runtime_error(sqlite3_errmsg(db_));
+    }
+    return statement;
+}
+
+void FileStorage::Run(sqlite3_stmt* statement) {
+    int status = sqlite3_step(statement);
+    while (status == SQLITE_ROW) {
+        status = sqlite3_step(statement);
+    }
+    if (status != SQLITE_DONE) {
+        throw std::runtime_error(sqlite3_errmsg(db_));
+    }
+}
+
+int FileStorage::InsertIDToDataBase(int user_id, const std::string& username, int game_id,
+                                    const std::string& user_colour) {
+    std::string colour = StoredColour(user_id, user_colour);
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        ScopedLatency round_trip(round_trips_);
+        StatementReset reset(insert_player_);
+        sqlite3_bind_int(insert_player_, 1, user_id);
+        BindText(insert_player_, 2, username);
+        sqlite3_bind_int(insert_player_, 3, game_id);
+        BindText(insert_player_, 4, colour);
+        Run(insert_player_);
+        return 0;
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("player insertion failed", {"player_id", user_id}, {"game_id", game_id}, {"error", e.what()});
+        return 1;
+    }
+}
+
+int FileStorage::DeleteIDFromDataBase(const std::string& username) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        ScopedLatency round_trip(round_trips_);
+        StatementReset reset(delete_player_);
+        BindText(delete_player_, 1, username);
+        Run(delete_player_);
+        CHESS_LOG_INFO("player deleted", {"username", username});
+        return 0;
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("player deletion failed", {"username", username}, {"error", e.what()});
+        return 1;
+    }
+}
+
+int FileStorage::GetGameIDByPlayerID(int user_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScopedLatency round_trip(round_trips_);
+    StatementReset reset(select_game_);
+    sqlite3_bind_int(select_game_, 1, user_id);
+    int status = sqlite3_step(select_game_);
+    if (status == SQLITE_ROW) {
+        return sqlite3_column_int(select_game_, 0);
+    }
+    if (status == SQLITE_DONE) {
+        CHESS_LOG_WARN("player not found", {"player_id", user_id});
+    } else {
+        CHESS_LOG_ERROR("game lookup failed", {"player_id", user_id}, {"error", sqlite3_errmsg(db_)});
+    }
+    return -1;
+}
+
+void FileStorage::CreateNewGame(int game_id, const std::string& initial_board) {
+    std::string history = BoardHistoryText({initial_board});
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        ScopedLatency round_trip(round_trips_);
+        StatementReset reset(insert_game_);
+        sqlite3_bind_int(insert_game_, 1, game_id);
+        BindText(insert_game_, 2, history);
+        Run(insert_game_);
+        CHESS_LOG_INFO("game row created", {"game_id", game_id});
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("game row creation failed", {"game_id", game_id}, {"error", e.what()});
+        throw;
+    }
+}
+
+void FileStorage::UpdateGameHistory(int game_id, const std::string& new_board_state) {
+    UpdateGameHistories({{game_id, new_board_state}});
+}
+
+void FileStorage::UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        // одна транзакция и одна запись журнала на всю пачку ходов
+        ScopedLatency round_trip(round_trips_);
+        Exec("BEGIN IMMEDIATE");
+        try {
+            for (const auto& [game_id, board_state] : updates) {
+                std::string history = BoardHistoryText({board_state});
+                StatementReset reset(update_game_);
+                BindText(update_game_, 1, history);
+                sqlite3_bind_int(update_game_, 2, game_id);
+                Run(update_game_);
+            }
+            Exec("COMMIT");
+        } catch (...) {
+            sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+            throw;
+        }
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("game history batch failed", {"games", updates.size()}, {"error", e.what()});
+        throw;
+    }
+}
+
+std::string FileStorage::GetBoardHistory(int game_id) {
+    TraceSpan connection_wait("db connection wait", "db");
+    std::lock_guard<std::mutex> lock(mutex_);
+    connection_wait.End();
+    TraceSpan query("GetBoardHistory", "db");
+    ScopedLatency round_trip(round_trips_);
+    StatementReset reset(select_history_);
+    sqlite3_bind_int(select_history_, 1, game_id);
+    int status = sqlite3_step(select_history_);
+    if (status == SQLITE_ROW) {
+        const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(select_history_, 0));
+        if (text == nullptr) {
+            return {};
+        }
+        return std::string(text, static_cast<std::size_t>(sqlite3_column_bytes(select_history_, 0)));
+    }
+    if (status != SQLITE_DONE) {
+        throw std::runtime_error(sqlite3_errmsg(db_));
+    }
+    return {};
+}
+
+int FileStorage::DeleteGame(int game_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        ScopedLatency round_trip(round_trips_);
+        Exec("BEGIN IMMEDIATE");
+        try {
+            for (sqlite3_stmt* statement : {delete_players_, delete_game_, delete_snapshot_}) {
+                StatementReset reset(statement);
+                sqlite3_bind_int(statement, 1, game_id);
+                Run(statement);
+            }
+            Exec("COMMIT");
+        } catch (...) {
+            sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+            throw;
+        }
+        CHESS_LOG_INFO("game deleted", {"game_id", game_id});
+        return 0;
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("game deletion failed", {"game_id", game_id}, {"error", e.what()});
+        return 1;
+    }
+}
+
+void FileStorage::SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try {
+        ScopedLatency round_trip(round_trips_);
+        Exec("BEGIN IMMEDIATE");
+        try {
+            for (const auto& [game_id, snapshot] : snapshots) {
+                std::string moves = EncodeMoves(snapshot.moves);
+                StatementReset reset(save_snapshot_);
+                sqlite3_bind_int(save_snapshot_, 1, game_id);
+                sqlite3_bind_int(save_snapshot_, 2, snapshot.ply);
+                BindText(save_snapshot_, 3, snapshot.board_state);
+                BindText(save_snapshot_, 4, moves);
+                Run(save_snapshot_);
+            }
+            Exec("COMMIT");
+        } catch (...) {
+            sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+            throw;
+        }
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("snapshot batch failed", {"games", snapshots.size()}, {"error", e.what()});
+        throw;
+    }
+}
+
+std::optional<GameSnapshot> FileStorage::LoadSnapshot(int game_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScopedLatency round_trip(round_trips_);
+    StatementReset reset(select_snapshot_);
+    sqlite3_bind_int(select_snapshot_, 1, game_id);
+    int status = sqlite3_step(select_snapshot_);
+    if (status == SQLITE_DONE) {
+        return std::nullopt;
+    }
+    if (status != SQLITE_ROW) {
+        throw std::runtime_error(sqlite3_errmsg(db_));
+    }
+    auto column = [&](int index) {
+        const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(select_snapshot_, index));
+        return text == nullptr ? std::string()
+                               : std::string(text, static_cast<std::size_t>(sqlite3_column_bytes(select_snapshot_, index)));
+    };
+    GameSnapshot snapshot;
+    snapshot.ply = sqlite3_column_int(select_snapshot_, 0);
+    snapshot.board_state = column(1);
+    snapshot.moves = DecodeMoves(column(2));
+    return snapshot;
+}
+
+void FileStorage::DeleteSnapshots(const std::vector<int>& game_ids) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScopedLatency round_trip(round_trips_);
+    Exec("BEGIN IMMEDIATE");
+    try {
+        for (int game_id : game_ids) {
+            StatementReset reset(delete_snapshot_);
+            sqlite3_bind_int(delete_snapshot_, 1, game_id);
+            Run(delete_snapshot_);
+        }
+        Exec("COMMIT");
+    } catch (...) {
+        sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+        throw;
+    }
+}
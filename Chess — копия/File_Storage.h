@@ -0,0 +1,74 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Storage.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+/*!
+ * \class FileStorage
+ * \brief Storage in a single SQLite file, for deployments of one server without a database server.
+ * \details The file holds the tables of the PostgreSQL schema, "User", GameHistory and GameSnapshot,
+ * and is created on first use. It runs in WAL mode with `synchronous=NORMAL`: a committed change survives a crash of
+ * the server process, and a power loss may take back only the last transactions, never corrupt the
+ * file. Every statement is prepared once when the file is opened.
+ *
+ * One connection serves all threads under a mutex; a batch of board updates is one transaction.
+ */
+class FileStorage : public Storage {
+public:
+    /*!
+     * \brief Opens or creates the file and prepares the statements.
+     * \throws std::runtime_error if the file cannot be opened or is not a storage file.
+     */
+    explicit FileStorage(const std::string& path);
+
+    /*! \brief Closes the file. */
+    ~FileStorage() override;
+
+    FileStorage(const FileStorage&) = delete;
+    FileStorage& operator=(const FileStorage&) = delete;
+
+    int InsertIDToDataBase(int user_id, const std::string& username, int game_id,
+                           const std::string& user_colour = "") override;
+    int DeleteIDFromDataBase(const std::string& username) override;
+    int GetGameIDByPlayerID(int user_id) override;
+    void CreateNewGame(int game_id, const std::string& initial_board) override;
+    void UpdateGameHistory(int game_id, const std::string& new_board_state) override;
+    void UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) override;
+    std::string GetBoardHistory(int game_id) override;
+    int DeleteGame(int game_id) override;
+    void SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) override;
+    std::optional<GameSnapshot> LoadSnapshot(int game_id) override;
+    void DeleteSnapshots(const std::vector<int>& game_ids) override;
+
+private:
+    void Exec(const char* sql);
+    sqlite3_stmt* Prepare(const char* sql);
+    void Run(sqlite3_stmt* statement);
+    void Close();
+
+    std::mutex mutex_;                             ///< Serializes use of the connection.
+    sqlite3* db_ = nullptr;                        ///< Connection to the file.
+    sqlite3_stmt* insert_player_ = nullptr;        ///< INSERT INTO "User".
+    sqlite3_stmt* delete_player_ = nullptr;        ///< DELETE FROM "User" by username.
+    sqlite3_stmt* select_game_ = nullptr;          ///< Game of a player.
+    sqlite3_stmt* insert_game_ = nullptr;          ///< INSERT INTO GameHistory.
+    sqlite3_stmt* update_game_ = nullptr;          ///< Replaces the history of a game.
+    sqlite3_stmt* select_history_ = nullptr;       ///< History of a game.
+    sqlite3_stmt* delete_players_ = nullptr;       ///< DELETE FROM "User" by game.
+    sqlite3_stmt* delete_game_ = nullptr;          ///< DELETE FROM GameHistory.
+    sqlite3_stmt* save_snapshot_ = nullptr;        ///< Inserts or replaces a snapshot.
+    sqlite3_stmt* select_snapshot_ = nullptr;      ///< Snapshot of a game.
+    sqlite3_stmt* delete_snapshot_ = nullptr;      ///< DELETE FROM GameSnapshot.
+};
@@ -0,0 +1,42 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Game_Arena.h"
+
+GameArena::GameArena(std::pmr::memory_resource* upstream)
+    : buffer_(storage_.data(), storage_.size(), upstream) {}
+
+void* GameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (!IsRecycled(bytes, alignment)) {
+        return buffer_.allocate(bytes, alignment);
+    }
+    std::size_t size_class = SizeClass(bytes);
+    if (FreeBlock* block = free_[size_class]) {
+        free_[size_class] = block->next;
+        return block;
+    }
+    // блок выделяется под весь класс, чтобы потом его мог взять любой запрос того же класса
+    return buffer_.allocate((size_class + 1) * kGranule, kGranule);
+}
+
+void GameArena::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+    if (!IsRecycled(bytes, alignment)) {
+        // крупные блоки живут до уничтожения арены
+        return;
+    }
+    std::size_t size_class = SizeClass(bytes);
+    free_[size_class] = ::new (pointer) FreeBlock{free_[size_class]};
+}
+
+bool GameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+bool GameArena::IsRecycled(std::size_t bytes, std::size_t alignment) {
+    return bytes <= kGranule * kClasses && alignment <= kGranule;
+}
+
+std::size_t GameArena::SizeClass(std::size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / kGranule;
+}
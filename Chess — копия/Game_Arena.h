@@ -0,0 +1,55 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+/*!
+ * \class GameArena
+ * \brief Memory resource holding the whole state of one game.
+ * \details Memory comes from a buffer inside the arena and, once it is used up, from geometrically
+ * growing blocks of the upstream resource. Small blocks freed during the game (a captured piece,
+ * the empty cell left behind by a move) go to a free list of their size class and are handed out
+ * again, so a game of any length stays within a few kilobytes; larger blocks are only reclaimed
+ * when the arena is destroyed, all at once.
+ *
+ * The arena is not synchronized: it must be used by one thread at a time, e.g. under the lock of
+ * the game it belongs to.
+ */
+class GameArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kInlineBytes = 6144;  ///< Buffer size; an initial board takes about 4.3 KiB.
+
+    /*!
+     * \brief Creates an empty arena.
+     * \param upstream Resource used when the inline buffer is exhausted.
+     */
+    explicit GameArena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    GameArena(const GameArena&) = delete;
+    GameArena& operator=(const GameArena&) = delete;
+
+private:
+    static constexpr std::size_t kGranule = alignof(std::max_align_t);  ///< Step between size classes.
+    static constexpr std::size_t kClasses = 8;                          ///< Blocks up to kGranule * kClasses are recycled.
+
+    /*! \brief Freed block, linked through its own memory. */
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    static bool IsRecycled(std::size_t bytes, std::size_t alignment);
+    static std::size_t SizeClass(std::size_t bytes);
+
+    alignas(std::max_align_t) std::array<std::byte, kInlineBytes> storage_;  ///< Inline buffer.
+    std::pmr::monotonic_buffer_resource buffer_;                            ///< Hands out storage_, then upstream blocks.
+    std::array<FreeBlock*, kClasses> free_{};                                ///< Free lists by size class.
+};
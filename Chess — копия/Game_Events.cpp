@@ -0,0 +1,147 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Game_Events.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+GameEvents::GameEvents(std::size_t partitions) {
+    partitions_.resize(std::max<std::size_t>(1, partitions));
+    for (auto& partition : partitions_) {
+        partition = std::make_unique<Partition>();
+    }
+}
+
+GameEvents::Partition& GameEvents::PartitionOf(int game_id) {
+    return *partitions_[std::hash<int>()(game_id) % partitions_.size()];
+}
+
+std::shared_ptr<GameEvents::Channel> GameEvents::FindChannel(int game_id) {
+    Partition& partition = PartitionOf(game_id);
+    std::shared_lock<std::shared_mutex> lock(partition.mutex);
+    auto it = partition.channels.find(game_id);
+    return it != partition.channels.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<GameEvents::Channel> GameEvents::GetChannel(int game_id) {
+    if (auto channel = FindChannel(game_id)) {
+        return channel;
+    }
+
+    Partition& partition = PartitionOf(game_id);
+    std::unique_lock<std::shared_mutex> lock(partition.mutex);
+    auto& channel = partition.channels[game_id];
+    if (!channel) {
+        channel = std::make_shared<Channel>();
+        channel->latest.game_id = game_id;
+    }
+    return channel;
+}
+
+void GameEvents::Publish(const GameUpdate& update) {
+    GameUpdate published;
+    std::vector<std::shared_ptr<Subscriber>> subscribers;
+    while (true) {
+        auto channel = GetChannel(update.game_id);
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        // канал удалили между поиском и блокировкой: ход должен попасть в новый
+        if (channel->removed) {
+            continue;
+        }
+        if (update.ply <= channel->latest.ply) {
+            return;
+        }
+        channel->dormant = false;
+        auto now = std::chrono::steady_clock::now();
+        channel->latest = update;
+        channel->latest.think_time =
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - channel->last_move_at);
+        channel->last_move_at = now;
+
+        published = channel->latest;
+        subscribers.reserve(channel->subscribers.size());
+        for (const auto& [id, subscriber] : channel->subscribers) {
+            subscribers.push_back(subscriber);
+        }
+        break;
+    }
+
+    for (const auto& subscriber : subscribers) {
+        (*subscriber)(published);
+    }
+}
+
+int GameEvents::Subscribe(int game_id, Subscriber subscriber) {
+    auto shared = std::make_shared<Subscriber>(std::move(subscriber));
+    while (true) {
+        auto channel = GetChannel(game_id);
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (channel->removed) {
+            continue;
+        }
+        int id = channel->next_subscription++;
+        channel->subscribers[id] = shared;
+        return id;
+    }
+}
+
+void GameEvents::Unsubscribe(int game_id, int subscription_id) {
+    auto channel = FindChannel(game_id);
+    if (!channel) {
+        return;
+    }
+
+    bool last_of_dormant = false;
+    {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        channel->subscribers.erase(subscription_id);
+        last_of_dormant = channel->dormant && channel->subscribers.empty();
+    }
+    // партия уже выгружена, канал держал только этот подписчик
+    if (last_of_dormant) {
+        Partition& partition = PartitionOf(game_id);
+        std::unique_lock<std::shared_mutex> map_lock(partition.mutex);
+        auto it = partition.channels.find(game_id);
+        if (it == partition.channels.end() || it->second != channel) {
+            return;
+        }
+        // пока ждали блокировку, мог прийти ход или новый подписчик
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (channel->dormant && channel->subscribers.empty()) {
+            channel->removed = true;
+            partition.channels.erase(it);
+        }
+    }
+}
+
+std::optional<GameUpdate> GameEvents::Latest(int game_id) {
+    auto channel = FindChannel(game_id);
+    if (!channel) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(channel->mutex);
+    if (channel->latest.ply == 0) {
+        return std::nullopt;
+    }
+    return channel->latest;
+}
+
+void GameEvents::Remove(int game_id) {
+    Partition& partition = PartitionOf(game_id);
+    std::unique_lock<std::shared_mutex> lock(partition.mutex);
+    auto it = partition.channels.find(game_id);
+    if (it == partition.channels.end()) {
+        return;
+    }
+    std::lock_guard<std::mutex> channel_lock(it->second->mutex);
+    if (!it->second->subscribers.empty()) {
+        it->second->dormant = true;
+        return;
+    }
+    it->second->removed = true;
+    partition.channels.erase(it);
+}
@@ -0,0 +1,118 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*! \brief
+ *   State of a game after an accepted move.
+ */
+struct GameUpdate {
+    int game_id = 0;          ///< Game the move was made in.
+    int ply = 0;              ///< Half-moves played after the move.
+    std::string move;         ///< The move as sent by the player.
+    std::string board_state;  ///< Board after the move.
+    std::chrono::milliseconds think_time{0};  ///< Time since the previous move of the game; set by Publish().
+};
+
+/*!
+ * \class GameEvents
+ * \brief Per-game notification point for accepted moves.
+ * \details The code that applies a move publishes the new ply here, and readers subscribe to get a
+ * callback for every move. Each game has its own channel and mutex, so a move reaches only the readers
+ * of that game. A channel exists while its game is resident or has subscribers: it is created by the
+ * first Publish() or Subscribe() and dropped by Remove() when the game is hibernated, so memory follows
+ * the active games.
+ *
+ * The channel map is split into partitions, each with its own lock. A game goes to partition
+ * `std::hash<int>()(game_id) % partitions`, the same rule ShardedGames uses to pick the shard, so with one
+ * partition per shard a shard publishes only into its own map and never shares its lock with other shards.
+ */
+class GameEvents {
+public:
+    using Subscriber = std::function<void(const GameUpdate&)>;
+
+    /*!
+     * \brief Creates the channel maps.
+     * \param partitions Number of channel maps; one per shard in sharded mode. 0 is treated as 1.
+     */
+    explicit GameEvents(std::size_t partitions = 1);
+
+    /*!
+     * \brief Returns the number of channel maps.
+     */
+    std::size_t Partitions() const { return partitions_.size(); }
+
+    /*!
+     * \brief Records an accepted move and passes it to the subscribers of its game.
+     * \details Updates older than the latest published ply of the game are ignored.
+     * \param update New state of the game.
+     */
+    void Publish(const GameUpdate& update);
+
+    /*!
+     * \brief Registers a callback invoked for every accepted move of a game.
+     * \details Callbacks run on the publishing thread, outside the channel lock, and must not block.
+     * \param game_id Game ID.
+     * \param subscriber Callback receiving each update.
+     * \return Subscription ID for Unsubscribe().
+     */
+    int Subscribe(int game_id, Subscriber subscriber);
+
+    /*!
+     * \brief Removes a callback registered with Subscribe().
+     * \param game_id Game ID.
+     * \param subscription_id ID returned by Subscribe().
+     */
+    void Unsubscribe(int game_id, int subscription_id);
+
+    /*!
+     * \brief Returns the latest published update of a game, if any. Never creates a channel.
+     * \param game_id Game ID.
+     * \return The update, or std::nullopt if no move has been published since the channel was created.
+     */
+    std::optional<GameUpdate> Latest(int game_id);
+
+    /*!
+     * \brief Drops the channel of a game that is no longer resident.
+     * \details A channel that still has subscribers is kept and dropped when the last one leaves,
+     *          unless a move is published in the meantime.
+     * \param game_id Game ID.
+     */
+    void Remove(int game_id);
+
+private:
+    /*! \brief Notification state of one game. */
+    struct Channel {
+        std::mutex mutex;              ///< Guards the fields below.
+        GameUpdate latest;             ///< Latest published update; ply 0 before the first move.
+        std::chrono::steady_clock::time_point last_move_at = std::chrono::steady_clock::now();  ///< Time of the latest move.
+        std::unordered_map<int, std::shared_ptr<Subscriber>> subscribers;  ///< Callbacks by subscription ID.
+        int next_subscription = 1;     ///< Next subscription ID.
+        bool dormant = false;          ///< Remove() was called while subscribers were left.
+        bool removed = false;          ///< No longer in the map; users must look the game up again.
+    };
+
+    /*! \brief Channels of the games that hash to one partition. */
+    struct Partition {
+        std::shared_mutex mutex;                                      ///< Guards the channel map only.
+        std::unordered_map<int, std::shared_ptr<Channel>> channels;   ///< Channels by game ID.
+    };
+
+    Partition& PartitionOf(int game_id);
+    std::shared_ptr<Channel> GetChannel(int game_id);
+    std::shared_ptr<Channel> FindChannel(int game_id);
+
+    std::vector<std::unique_ptr<Partition>> partitions_;              ///< Channel maps indexed by hash of the game ID.
+};
@@ -0,0 +1,151 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Game_Shard.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "Logger.h"
+#include "Tracing.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+GameShard::GameShard(std::size_t index, Storage& storage)
+    : index_(index), storage_(storage), thread_([this]() { Loop(); }) {
+#if defined(__linux__)
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores != 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index_ % cores, &cpus);
+        pthread_setaffinity_np(thread_.native_handle(), sizeof(cpus), &cpus);
+    }
+#endif
+}
+
+GameShard::~GameShard() {
+    inbox_.Close();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void GameShard::Post(Task task) {
+    if (!inbox_.PushBack(std::move(task))) {
+        CHESS_LOG_WARN("shard is stopped, task dropped", {"shard", index_});
+    }
+}
+
+RunningGame& GameShard::AddGame(int id_game) {
+    auto& game = games_[id_game];
+    game = std::make_unique<RunningGame>(GameLocking::SingleOwner);
+    return *game;
+}
+
+RunningGame* GameShard::FindGame(int id_game) {
+    auto it = games_.find(id_game);
+    if (it != games_.end()) {
+        it->second->Touch();
+        return it->second.get();
+    }
+
+    std::optional<GameSnapshot> snapshot;
+    if (auto pending = hibernating_.find(id_game); pending != hibernating_.end()) {
+        // снимок ещё не записан: партия возвращается прямо из памяти
+        snapshot = std::move(pending->second);
+        hibernating_.erase(pending);
+    } else if (hibernated_.count(id_game) != 0) {
+        snapshot = storage_.LoadSnapshot(id_game);
+        hibernated_.erase(id_game);
+        if (!snapshot) {
+            CHESS_LOG_ERROR("snapshot of a hibernated game is missing", {"shard", index_}, {"game_id", id_game});
+            return nullptr;
+        }
+    } else {
+        return nullptr;
+    }
+
+    RunningGame& game = AddGame(id_game);
+    if (!game.Restore(*snapshot)) {
+        CHESS_LOG_WARN("game restored with a different board", {"shard", index_}, {"game_id", id_game});
+    }
+    return &game;
+}
+
+std::vector<std::pair<int, GameSnapshot>> GameShard::HibernateIdle(std::chrono::steady_clock::duration idle_timeout) {
+    auto deadline = std::chrono::steady_clock::now() - idle_timeout;
+    for (auto it = games_.begin(); it != games_.end();) {
+        if (it->second->LastActive() <= deadline) {
+            hibernating_[it->first] = it->second->Snapshot();
+            it = games_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // неудачная прошлая запись повторяется вместе с новыми снимками
+    return {hibernating_.begin(), hibernating_.end()};
+}
+
+std::vector<int> GameShard::CompleteHibernation(const std::vector<int>& stored) {
+    std::vector<int> hibernated;
+    for (int id_game : stored) {
+        if (hibernating_.erase(id_game) != 0) {
+            hibernated_.insert(id_game);
+            hibernated.push_back(id_game);
+        }
+    }
+    return hibernated;
+}
+
+void GameShard::RemoveGame(int id_game) {
+    games_.erase(id_game);
+    hibernating_.erase(id_game);
+    hibernated_.erase(id_game);
+}
+
+void GameShard::Loop() {
+    Tracer::Instance().NameThread("game shard " + std::to_string(index_));
+    std::vector<Task> batch;
+    batch.reserve(kBatchSize);
+
+    while (inbox_.DrainInto(batch, kBatchSize) != 0) {
+        for (auto& task : batch) {
+            try {
+                task(*this);
+            } catch (const std::exception& e) {
+                CHESS_LOG_ERROR("shard task failed", {"shard", index_}, {"error", e.what()});
+            }
+        }
+        batch.clear();
+        PublishCounts();
+    }
+}
+
+void GameShard::PublishCounts() {
+    // игры меняются только задачами шарда, так что хватает обновить счётчики после пачки
+    resident_count_.store(games_.size(), std::memory_order_relaxed);
+    hibernated_count_.store(hibernating_.size() + hibernated_.size(), std::memory_order_relaxed);
+}
+
+ShardedGames::ShardedGames(Storage& storage, std::size_t shard_count) {
+    if (shard_count == 0) {
+        shard_count = DefaultShardCount();
+    }
+
+    shards_.reserve(shard_count);
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<GameShard>(i, storage));
+    }
+}
+
+std::size_t ShardedGames::DefaultShardCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+GameShard& ShardedGames::ShardOf(int id_game) {
+    return *shards_[std::hash<int>()(id_game) % shards_.size()];
+}
@@ -0,0 +1,245 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Async_Task.h"
+#include "My_MPSC_Queue.h"
+#include "Run.h"
+#include "Storage.h"
+
+/*!
+ * \class GameShard
+ * \brief Event loop that owns a subset of games.
+ * \details Each shard runs one thread, pinned to a core where the platform allows it. Games owned
+ * by the shard are created, moved and destroyed only on that thread, so their state is never
+ * shared between cores. Other threads talk to the shard by posting tasks into its inbox.
+ *
+ * A hibernated game leaves only its ID in the shard: its snapshot is kept in the shard until it is
+ * written to the storage, and read back from the storage when the game is used again.
+ */
+class GameShard {
+public:
+    using Task = std::function<void(GameShard&)>;
+
+    /*!
+     * \brief Starts the shard event loop.
+     * \param index Shard number, also used as the preferred CPU core.
+     * \param storage Storage the snapshots of hibernated games are read from; must outlive the shard.
+     */
+    GameShard(std::size_t index, Storage& storage);
+
+    /*!
+     * \brief Closes the inbox, lets the loop finish queued tasks and joins the thread.
+     */
+    ~GameShard();
+
+    GameShard(const GameShard&) = delete;
+    GameShard& operator=(const GameShard&) = delete;
+
+    /*!
+     * \brief Queues a task for execution on the shard thread. Safe to call from any thread.
+     * \param task Task receiving the shard.
+     */
+    void Post(Task task);
+
+    /*!
+     * \brief Creates a game owned by this shard. Shard thread only.
+     * \param id_game Game ID.
+     * \return Reference to the new game.
+     */
+    RunningGame& AddGame(int id_game);
+
+    /*!
+     * \brief Finds a game owned by this shard, rehydrating it if it was hibernated. Shard thread only.
+     * \details Rehydrating a game whose snapshot is already stored reads the storage on the shard thread.
+     * \param id_game Game ID.
+     * \return Pointer to the game, or nullptr if the shard does not own it.
+     * \throws std::exception if the snapshot cannot be read; the game stays hibernated.
+     */
+    RunningGame* FindGame(int id_game);
+
+    /*!
+     * \brief Replaces games idle for at least \p idle_timeout with their snapshots. Shard thread only.
+     * \details The snapshots stay in the shard until CompleteHibernation() reports them stored.
+     * \param idle_timeout Inactivity after which a game is hibernated.
+     * \return Snapshots not stored yet: of the games hibernated now and of those whose write failed before.
+     */
+    std::vector<std::pair<int, GameSnapshot>> HibernateIdle(std::chrono::steady_clock::duration idle_timeout);
+
+    /*!
+     * \brief Drops the snapshots that were written to the storage, keeping only the IDs. Shard thread only.
+     * \param stored Games whose snapshots were stored.
+     * \return Games that were still waiting for the write; the others were rehydrated or removed meanwhile.
+     */
+    std::vector<int> CompleteHibernation(const std::vector<int>& stored);
+
+    /*!
+     * \brief Destroys a game owned by this shard, resident or hibernated. Shard thread only.
+     * \param id_game Game ID.
+     */
+    void RemoveGame(int id_game);
+
+    /*!
+     * \brief Returns the shard number.
+     */
+    std::size_t Index() const { return index_; }
+
+    /*!
+     * \brief Returns the number of games kept in memory. Safe to call from any thread.
+     */
+    std::size_t ResidentGames() const { return resident_count_.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Returns the number of hibernated games. Safe to call from any thread.
+     */
+    std::size_t HibernatedGames() const { return hibernated_count_.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Returns the number of tasks waiting in the inbox. Safe to call from any thread.
+     */
+    std::size_t InboxDepth() const { return inbox_.Size(); }
+
+private:
+    void Loop();
+    void PublishCounts();
+
+    static constexpr std::size_t kBatchSize = 64;  ///< Tasks taken from the inbox per wake-up.
+
+    std::size_t index_;                                            ///< Shard number.
+    MPSCQueue<Task> inbox_;                                        ///< Tasks posted by other threads.
+    std::unordered_map<int, std::unique_ptr<RunningGame>> games_;  ///< Games owned by this shard.
+    Storage& storage_;                                             ///< Where the snapshots are read from.
+    std::unordered_map<int, GameSnapshot> hibernating_;            ///< Snapshots not written to the storage yet.
+    std::unordered_set<int> hibernated_;                           ///< Games whose snapshot is in the storage.
+    std::atomic<std::size_t> resident_count_{0};                   ///< games_.size() for other threads.
+    std::atomic<std::size_t> hibernated_count_{0};                 ///< Hibernated games for other threads.
+    std::thread thread_;                                           ///< Event loop thread.
+};
+
+/*!
+ * \class ShardedGames
+ * \brief Thread-per-core game runtime.
+ * \details Routes every operation on a game to the shard that owns it, chosen by hashing the game ID.
+ * Callers get the result through a std::future, or in a coroutine through SubmitAsync().
+ */
+class ShardedGames {
+public:
+    /*!
+     * \brief Starts the shards.
+     * \param storage Storage of the snapshots of hibernated games; must outlive the shards.
+     * \param shard_count Number of shards; 0 means one per hardware thread.
+     */
+    explicit ShardedGames(Storage& storage, std::size_t shard_count = 0);
+
+    /*!
+     * \brief Returns the number of shards started when none is given: one per hardware thread.
+     */
+    static std::size_t DefaultShardCount();
+
+    /*!
+     * \brief Returns the shard that owns a game.
+     * \param id_game Game ID.
+     */
+    GameShard& ShardOf(int id_game);
+
+    /*!
+     * \brief Returns the number of shards.
+     */
+    std::size_t Size() const { return shards_.size(); }
+
+    /*!
+     * \brief Returns a shard by its number, e.g. to post maintenance tasks to every shard.
+     * \param index Shard number, below Size().
+     */
+    GameShard& ShardAt(std::size_t index) { return *shards_[index]; }
+
+    /*!
+     * \brief Runs a function on the shard that owns a game and returns its result.
+     * \param id_game Game ID used for routing.
+     * \param fn Callable taking `GameShard&`.
+     * \return Future receiving the result or the exception thrown by \p fn.
+     */
+    template <typename F>
+    auto Submit(int id_game, F&& fn) -> std::future<std::invoke_result_t<F&, GameShard&>>;
+
+    /*!
+     * \brief Runs a function on a shard chosen by number and returns its result, e.g. for maintenance of every shard.
+     * \param index Shard number, below Size().
+     * \param fn Callable taking `GameShard&`.
+     * \return Future receiving the result or the exception thrown by \p fn.
+     */
+    template <typename F>
+    auto SubmitAt(std::size_t index, F&& fn) -> std::future<std::invoke_result_t<F&, GameShard&>>;
+
+    /*!
+     * \brief Runs a function on the shard that owns a game and resumes the awaiting coroutine with its result.
+     * \details Unlike Submit(), no thread waits for the shard meanwhile.
+     * \param id_game Game ID used for routing.
+     * \param fn Callable taking `GameShard&`.
+     * \return Result of \p fn; an exception thrown by \p fn is rethrown from `co_await`.
+     */
+    template <typename F>
+    auto SubmitAsync(int id_game, F fn) -> Task<std::invoke_result_t<F&, GameShard&>>;
+
+private:
+    template <typename F>
+    static auto SubmitTo(GameShard& shard, F&& fn) -> std::future<std::invoke_result_t<F&, GameShard&>>;
+
+    std::vector<std::unique_ptr<GameShard>> shards_;  ///< Shards indexed by hash of the game ID.
+};
+
+template <typename F>
+auto ShardedGames::Submit(int id_game, F&& fn) -> std::future<std::invoke_result_t<F&, GameShard&>> {
+    return SubmitTo(ShardOf(id_game), std::forward<F>(fn));
+}
+
+template <typename F>
+auto ShardedGames::SubmitAt(std::size_t index, F&& fn) -> std::future<std::invoke_result_t<F&, GameShard&>> {
+    return SubmitTo(ShardAt(index), std::forward<F>(fn));
+}
+
+template <typename F>
+auto ShardedGames::SubmitTo(GameShard& shard, F&& fn) -> std::future<std::invoke_result_t<F&, GameShard&>> {
+    using Result = std::invoke_result_t<F&, GameShard&>;
+
+    auto promise = std::make_shared<std::promise<Result>>();
+    auto future = promise->get_future();
+
+    shard.Post([promise, fn = std::forward<F>(fn)](GameShard& shard) mutable {
+        try {
+            if constexpr (std::is_void_v<Result>) {
+                fn(shard);
+                promise->set_value();
+            } else {
+                promise->set_value(fn(shard));
+            }
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+
+    return future;
+}
+
+template <typename F>
+auto ShardedGames::SubmitAsync(int id_game, F fn) -> Task<std::invoke_result_t<F&, GameShard&>> {
+    GameShard& shard = ShardOf(id_game);
+    return AwaitOn<std::invoke_result_t<F&, GameShard&>>(
+        [&shard](std::function<void()> work) { shard.Post([work = std::move(work)](GameShard&) { work(); }); },
+        [&shard, fn = std::move(fn)]() mutable { return fn(shard); });
+}
@@ -0,0 +1,403 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Http_Server.h"
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <cctype>
+#include <iostream>
+#include <memory>
+#include <optional>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+/*!
+ * \brief Decodes `%XX` escapes and `+` in a URL-encoded string.
+ */
+std::string UrlDecode(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '+') {
+            result += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+                   std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            result += static_cast<char>(std::stoi(std::string(text.substr(i + 1, 2)), nullptr, 16));
+            i += 2;
+        } else {
+            result += text[i];
+        }
+    }
+    return result;
+}
+
+/*!
+ * \brief Adds the parameters of a URL-encoded `a=1&b=2` string to \p params.
+ */
+void ParseParams(std::string_view query, std::unordered_map<std::string, std::string>& params) {
+    while (!query.empty()) {
+        auto end = query.find('&');
+        std::string_view pair = query.substr(0, end);
+        if (!pair.empty()) {
+            auto eq = pair.find('=');
+            if (eq == std::string_view::npos) {
+                params.emplace(UrlDecode(pair), std::string());
+            } else {
+                params.emplace(UrlDecode(pair.substr(0, eq)), UrlDecode(pair.substr(eq + 1)));
+            }
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        query.remove_prefix(end + 1);
+    }
+}
+
+/*!
+ * \brief Runs a coroutine handler to completion and sends its response.
+ * \details The request is copied into the coroutine frame because the connection reuses its buffers.
+ */
+Task<> RunCoroutine(HttpServer::CoroutineHandler handler, HttpRequest request, HttpServer::Responder respond) {
+    HttpResponse response;
+    try {
+        co_await handler(request, response);
+    } catch (const std::exception& e) {
+        response = HttpResponse();
+        response.status = 500;
+        response.SetContent(std::string("Error: ") + e.what(), "text/plain");
+    }
+    respond(std::move(response));
+}
+
+/*!
+ * \class HttpConnection
+ * \brief One keep-alive connection; requests are read, handled and answered one after another.
+ * \details Pipelined requests wait in the read buffer until the previous response is written, so
+ * responses always go out in request order. All handlers of a connection run on its strand.
+ */
+class HttpConnection : public std::enable_shared_from_this<HttpConnection> {
+public:
+    HttpConnection(tcp::socket&& socket, const HttpServer& server)
+        : stream_(std::move(socket)), server_(server) {}
+
+    void Start() {
+        net::dispatch(stream_.get_executor(), [self = shared_from_this()]() { self->DoRead(); });
+    }
+
+private:
+    void DoRead() {
+        parser_.emplace();
+        parser_->header_limit(static_cast<std::uint32_t>(server_.Limits().max_header_bytes));
+        parser_->body_limit(server_.Limits().max_body_bytes);
+
+        stream_.expires_after(server_.Limits().idle_timeout);
+        http::async_read_header(stream_, buffer_, *parser_,
+                                [self = shared_from_this()](beast::error_code ec, std::size_t) { self->OnHeader(ec); });
+    }
+
+    void OnHeader(beast::error_code ec) {
+        if (ec) {
+            return OnRead(ec);
+        }
+
+        // перегрузку отсекаем до чтения тела: такой запрос почти ничего не стоит
+        beast::string_view target = parser_->get().target();
+        std::string_view path(target.data(), target.size());
+        permit_ = server_.Admit(std::string(path.substr(0, path.find('?'))));
+        if (!permit_) {
+            version_ = parser_->get().version();
+            return WriteError(http::status::service_unavailable, "Server overloaded", "1");
+        }
+        http::async_read(stream_, buffer_, *parser_,
+                         [self = shared_from_this()](beast::error_code ec, std::size_t) { self->OnRead(ec); });
+    }
+
+    void OnRead(beast::error_code ec) {
+        if (ec == http::error::header_limit) {
+            return WriteError(http::status::request_header_fields_too_large, "Request header too large");
+        }
+        if (ec == http::error::body_limit) {
+            return WriteError(http::status::payload_too_large, "Request body too large");
+        }
+        if (ec) {
+            // end_of_stream, timeout or a broken connection
+            stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+            return;
+        }
+
+        http::request<http::string_body> message = parser_->release();
+        version_ = message.version();
+        keep_alive_ = message.keep_alive();
+
+        HttpRequest request;
+        request.method = std::string(message.method_string());
+        std::string_view target(message.target().data(), message.target().size());
+        auto query_start = target.find('?');
+        request.path = std::string(target.substr(0, query_start));
+        if (query_start != std::string_view::npos) {
+            ParseParams(target.substr(query_start + 1), request.params);
+        }
+        std::string_view content_type(message[http::field::content_type].data(), message[http::field::content_type].size());
+        if (content_type.starts_with("application/x-www-form-urlencoded")) {
+            ParseParams(message.body(), request.params);
+        }
+        request.body = std::move(message.body());
+        request.trace = Tracer::Instance().BeginRequest();
+
+        // пока обработчик работает, соединение не должно закрыться по таймауту простоя
+        stream_.expires_never();
+        server_.Dispatch(request, [self = shared_from_this(), id = request.trace.request_id](HttpResponse response) {
+            response.SetHeader("X-Request-Id", std::to_string(id));
+            net::post(self->stream_.get_executor(), [self, response = std::move(response)]() mutable {
+                self->Write(std::move(response));
+            });
+        });
+    }
+
+    void Write(HttpResponse response) {
+        // задержка считается до готовности ответа; запись в сокет зависит уже от клиента
+        permit_.reset();
+        response_.emplace(static_cast<http::status>(response.status), version_);
+        response_->set(http::field::content_type, response.content_type);
+        for (auto& [name, value] : response.headers) {
+            response_->set(name, value);
+        }
+        response_->body() = std::move(response.body);
+        response_->keep_alive(keep_alive_);
+        response_->prepare_payload();
+
+        stream_.expires_after(server_.Limits().idle_timeout);
+        http::async_write(stream_, *response_, [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            if (ec) {
+                return;
+            }
+            if (!self->keep_alive_) {
+                self->stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+                return;
+            }
+            self->DoRead();
+        });
+    }
+
+    /*! \brief Answers a request that could not be read or was shed, and closes the connection. */
+    void WriteError(http::status status, std::string text, std::string retry_after = "") {
+        keep_alive_ = false;
+        HttpResponse response;
+        response.status = static_cast<int>(status);
+        response.SetContent(std::move(text), "text/plain");
+        if (!retry_after.empty()) {
+            response.SetHeader("Retry-After", std::move(retry_after));
+        }
+        Write(std::move(response));
+    }
+
+    beast::tcp_stream stream_;                                        ///< Socket with timeouts.
+    const HttpServer& server_;                                        ///< Owning server.
+    beast::flat_buffer buffer_;                                       ///< Read buffer; holds pipelined requests.
+    std::optional<http::request_parser<http::string_body>> parser_;   ///< Parser of the current request.
+    std::optional<http::response<http::string_body>> response_;       ///< Response being written.
+    std::optional<ConcurrencyLimiter::Permit> permit_;                ///< Slot of the request being handled.
+    unsigned version_ = 11;                                           ///< HTTP version of the current request.
+    bool keep_alive_ = true;                                          ///< Whether to read another request.
+};
+
+}
+
+HttpServer::HttpServer(std::size_t io_threads, std::size_t blocking_threads, HttpLimits limits)
+    : io_threads_(io_threads == 0 ? 1 : io_threads)
+    , limits_(limits)
+    , ioc_(static_cast<int>(io_threads_))
+    , acceptor_(net::make_strand(ioc_))
+    , blocking_pool_(blocking_threads == 0 ? 1 : blocking_threads) {}
+
+HttpServer::~HttpServer() {
+    Stop();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    blocking_pool_.join();
+}
+
+void HttpServer::Get(const std::string& path, Handler handler) {
+    GetAsync(path, [handler = std::move(handler)](const HttpRequest& request, Responder respond) {
+        HttpResponse response;
+        handler(request, response);
+        respond(std::move(response));
+    });
+}
+
+void HttpServer::Post(const std::string& path, Handler handler) {
+    PostAsync(path, [handler = std::move(handler)](const HttpRequest& request, Responder respond) {
+        HttpResponse response;
+        handler(request, response);
+        respond(std::move(response));
+    });
+}
+
+void HttpServer::GetAsync(const std::string& path, AsyncHandler handler) {
+    AddRoute("GET", path, std::move(handler));
+}
+
+void HttpServer::PostAsync(const std::string& path, AsyncHandler handler) {
+    AddRoute("POST", path, std::move(handler));
+}
+
+void HttpServer::AddRoute(const std::string& method, const std::string& path, AsyncHandler handler) {
+    Route& route = routes_[{method, path}];
+    route.handler = std::move(handler);
+    if (!route.metrics) {
+        route.metrics = std::make_unique<RouteMetrics>();
+    }
+}
+
+void HttpServer::GetCoroutine(const std::string& path, CoroutineHandler handler) {
+    GetAsync(path, SpawnCoroutine(std::move(handler)));
+}
+
+void HttpServer::PostCoroutine(const std::string& path, CoroutineHandler handler) {
+    PostAsync(path, SpawnCoroutine(std::move(handler)));
+}
+
+HttpServer::AsyncHandler HttpServer::SpawnCoroutine(CoroutineHandler handler) {
+    return [this, handler = std::move(handler)](const HttpRequest& request, Responder respond) {
+        net::co_spawn(ioc_, RunCoroutine(handler, request, std::move(respond)), net::detached);
+    };
+}
+
+void HttpServer::SetPriority(const std::string& path, RequestPriority priority) {
+    priorities_[path] = priority;
+}
+
+std::optional<ConcurrencyLimiter::Permit> HttpServer::Admit(const std::string& path) const {
+    if (!limiter_) {
+        return ConcurrencyLimiter::Permit::Unlimited();
+    }
+    auto it = priorities_.find(path);
+    return limiter_->TryAcquire(it == priorities_.end() ? RequestPriority::Normal : it->second);
+}
+
+void HttpServer::AddFilter(Filter filter) {
+    filters_.push_back(std::move(filter));
+}
+
+HttpServer::AsyncHandler HttpServer::Offload(Handler handler) {
+    auto shared = std::make_shared<Handler>(std::move(handler));
+    return [this, shared](const HttpRequest& request, Responder respond) {
+        net::post(blocking_pool_, [shared, request, respond = std::move(respond)]() {
+            HttpResponse response;
+            try {
+                (*shared)(request, response);
+            } catch (const std::exception& e) {
+                response.status = 500;
+                response.SetContent(std::string("Error: ") + e.what(), "text/plain");
+            }
+            respond(std::move(response));
+        });
+    };
+}
+
+void HttpServer::Dispatch(const HttpRequest& request, Responder respond) const {
+    auto it = routes_.find({request.method, request.path});
+    if (it == routes_.end()) {
+        unrouted_.Add();
+        HttpResponse response;
+        response.status = 404;
+        response.SetContent("Not found", "text/plain");
+        respond(std::move(response));
+        return;
+    }
+
+    // ответ учитывается там, где он готов: обработчик может ответить из другого потока
+    RouteMetrics* metrics = it->second.metrics.get();
+    metrics->requests.Add();
+    // имя спана — путь маршрута: строка живёт в routes_ столько же, сколько сервер
+    respond = [metrics, start = std::chrono::steady_clock::now(), trace = request.trace,
+               name = it->first.second.c_str(), respond = std::move(respond)](HttpResponse response) {
+        auto end = std::chrono::steady_clock::now();
+        metrics->latency.Record(end - start);
+        Tracer::Instance().Record(trace, name, "http", start, end);
+        if (response.status >= 400) {
+            metrics->errors.Add();
+        }
+        respond(std::move(response));
+    };
+
+    try {
+        for (const auto& filter : filters_) {
+            HttpResponse response;
+            if (!filter(request, response)) {
+                respond(std::move(response));
+                return;
+            }
+        }
+        it->second.handler(request, respond);
+    } catch (const std::exception& e) {
+        HttpResponse response;
+        response.status = 500;
+        response.SetContent(std::string("Error: ") + e.what(), "text/plain");
+        respond(std::move(response));
+    }
+}
+
+std::vector<RouteStats> HttpServer::GetRouteStats() const {
+    std::vector<RouteStats> stats;
+    stats.reserve(routes_.size());
+    for (const auto& [key, route] : routes_) {
+        stats.push_back({key.first, key.second, route.metrics->requests.Value(), route.metrics->errors.Value(),
+                         route.metrics->latency.Snapshot()});
+    }
+    return stats;
+}
+
+bool HttpServer::Listen(const std::string& host, unsigned short port) {
+    beast::error_code ec;
+    tcp::endpoint endpoint(net::ip::make_address(host, ec), port);
+    if (!ec) acceptor_.open(endpoint.protocol(), ec);
+    if (!ec) acceptor_.set_option(net::socket_base::reuse_address(true), ec);
+    if (!ec) acceptor_.bind(endpoint, ec);
+    if (!ec) acceptor_.listen(net::socket_base::max_listen_connections, ec);
+    if (ec) {
+        std::cerr << "❌ Cannot listen on " << host << ":" << port << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    DoAccept();
+    for (std::size_t i = 1; i < io_threads_; ++i) {
+        threads_.emplace_back([this, i]() {
+            Tracer::Instance().NameThread("http io " + std::to_string(i));
+            ioc_.run();
+        });
+    }
+    Tracer::Instance().NameThread("http io 0");
+    ioc_.run();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    return true;
+}
+
+void HttpServer::Stop() {
+    ioc_.stop();
+}
+
+void HttpServer::DoAccept() {
+    acceptor_.async_accept(net::make_strand(ioc_), [this](beast::error_code ec, tcp::socket socket) {
+        if (!ec) {
+            std::make_shared<HttpConnection>(std::move(socket), *this)->Start();
+        }
+        if (acceptor_.is_open()) {
+            DoAccept();
+        }
+    });
+}
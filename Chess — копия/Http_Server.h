@@ -0,0 +1,267 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Async_Task.h"
+#include "Concurrency_Limiter.h"
+#include "Metrics.h"
+#include "Tracing.h"
+
+/*!
+ * \brief Parsed HTTP request passed to route handlers.
+ * \details Parameters are collected from the query string and, for form posts, from the
+ * `application/x-www-form-urlencoded` body; both are URL-decoded.
+ */
+struct HttpRequest {
+    std::string method;                                  ///< Request method ("GET", "POST", ...).
+    std::string path;                                    ///< Target without the query string.
+    std::unordered_map<std::string, std::string> params; ///< Query and form parameters.
+    std::string body;                                    ///< Raw request body.
+    TraceContext trace;                                  ///< Request ID and whether the request is traced.
+
+    /*!
+     * \brief Checks whether a parameter is present.
+     */
+    bool HasParam(const std::string& name) const { return params.count(name) != 0; }
+
+    /*!
+     * \brief Returns a parameter value, or an empty string if it is missing.
+     */
+    std::string GetParam(const std::string& name) const {
+        auto it = params.find(name);
+        return it == params.end() ? std::string() : it->second;
+    }
+};
+
+/*!
+ * \brief HTTP response filled in by route handlers.
+ */
+struct HttpResponse {
+    int status = 200;                                         ///< HTTP status code.
+    std::string body;                                         ///< Response body.
+    std::string content_type = "text/plain";                  ///< Value of the Content-Type header.
+    std::vector<std::pair<std::string, std::string>> headers; ///< Extra headers.
+
+    /*!
+     * \brief Sets the body and its content type.
+     */
+    void SetContent(std::string content, std::string type) {
+        body = std::move(content);
+        content_type = std::move(type);
+    }
+
+    /*!
+     * \brief Adds a response header.
+     */
+    void SetHeader(std::string name, std::string value) {
+        headers.emplace_back(std::move(name), std::move(value));
+    }
+};
+
+/*!
+ * \brief Limits applied to every connection of an HttpServer.
+ */
+struct HttpLimits {
+    std::size_t max_header_bytes = 8 * 1024;            ///< Larger request headers are answered with 431.
+    std::size_t max_body_bytes = 64 * 1024;             ///< Larger request bodies are answered with 413.
+    std::chrono::seconds idle_timeout{120};             ///< Keep-alive connections idle this long are closed.
+};
+
+/*!
+ * \brief Counters of one route, as returned by HttpServer::GetRouteStats().
+ */
+struct RouteStats {
+    std::string method;            ///< Request method.
+    std::string path;              ///< Route path.
+    std::uint64_t requests = 0;    ///< Requests dispatched to the route.
+    std::uint64_t errors = 0;      ///< Responses with a status of 400 or above.
+    HistogramSnapshot latency;     ///< Time from dispatch to the response.
+};
+
+/*!
+ * \class HttpServer
+ * \brief Asynchronous HTTP/1.1 server on Boost.Asio with a fixed number of I/O threads.
+ * \details Connections are kept alive, and pipelined requests are answered in the order they
+ * arrive. An idle connection costs only its socket and buffers, so many thousands of idle
+ * clients can stay connected on a few threads.
+ *
+ * Synchronous handlers run on an I/O thread and must not block. An asynchronous handler gets a
+ * Responder and may call it later from any thread; the connection waits for it before reading
+ * the next request. Coroutine handlers run on the I/O threads and `co_await` game operations, database
+ * calls and timers without parking a thread. Handlers that have to block can be wrapped with Offload(),
+ * which runs them on a separate worker pool.
+ */
+class HttpServer {
+public:
+    using Handler = std::function<void(const HttpRequest&, HttpResponse&)>;
+    using Responder = std::function<void(HttpResponse)>;
+    using AsyncHandler = std::function<void(const HttpRequest&, Responder)>;
+    using CoroutineHandler = std::function<Task<>(const HttpRequest&, HttpResponse&)>;
+    using Filter = std::function<bool(const HttpRequest&, HttpResponse&)>;
+
+    /*!
+     * \brief Creates the server without starting it.
+     * \param io_threads Number of I/O threads.
+     * \param blocking_threads Number of workers for handlers wrapped with Offload().
+     * \param limits Request size limits and keep-alive timeout.
+     */
+    explicit HttpServer(std::size_t io_threads, std::size_t blocking_threads = 4, HttpLimits limits = {});
+
+    /*!
+     * \brief Stops the server and joins all threads.
+     */
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    /*!
+     * \brief Registers a synchronous GET handler.
+     */
+    void Get(const std::string& path, Handler handler);
+
+    /*!
+     * \brief Registers a synchronous POST handler.
+     */
+    void Post(const std::string& path, Handler handler);
+
+    /*!
+     * \brief Registers an asynchronous GET handler.
+     */
+    void GetAsync(const std::string& path, AsyncHandler handler);
+
+    /*!
+     * \brief Registers an asynchronous POST handler.
+     */
+    void PostAsync(const std::string& path, AsyncHandler handler);
+
+    /*!
+     * \brief Registers a coroutine GET handler.
+     */
+    void GetCoroutine(const std::string& path, CoroutineHandler handler);
+
+    /*!
+     * \brief Registers a coroutine POST handler.
+     */
+    void PostCoroutine(const std::string& path, CoroutineHandler handler);
+
+    /*!
+     * \brief Adds a check that runs on the I/O thread before the handler of every known route.
+     * \details A filter that returns false has filled in the response itself, and the handler is not
+     * called; filters therefore must be cheap. Add filters before calling Listen().
+     */
+    void AddFilter(Filter filter);
+
+    /*!
+     * \brief Sheds requests the limiter does not admit; call before Listen().
+     * \details The check runs as soon as the request header is read: a rejected request is answered
+     * with 503 and `Retry-After` without reading its body, and the connection is closed. An admitted
+     * request holds its permit until the handler has produced the response.
+     * \param limiter Limiter shared by all connections; must outlive the server.
+     */
+    void SetConcurrencyLimiter(ConcurrencyLimiter* limiter) { limiter_ = limiter; }
+
+    /*!
+     * \brief Sets the priority class of a path for the concurrency limiter; paths default to Normal.
+     */
+    void SetPriority(const std::string& path, RequestPriority priority);
+
+    /*!
+     * \brief Admits a request to \p path, or returns std::nullopt if it must be shed; called by connections.
+     */
+    std::optional<ConcurrencyLimiter::Permit> Admit(const std::string& path) const;
+
+    /*!
+     * \brief Wraps a blocking handler so that it runs on the worker pool instead of an I/O thread.
+     */
+    AsyncHandler Offload(Handler handler);
+
+    /*!
+     * \brief Returns the I/O context, e.g. for timers used by asynchronous handlers.
+     */
+    boost::asio::io_context& Context() { return ioc_; }
+
+    /*!
+     * \brief Returns the worker pool, e.g. for blocking calls awaited with RunBlocking().
+     */
+    boost::asio::thread_pool& BlockingPool() { return blocking_pool_; }
+
+    /*!
+     * \brief Binds to \p host:\p port and serves requests until Stop() is called.
+     * \details The calling thread becomes one of the I/O threads.
+     * \return false if the address could not be bound.
+     */
+    bool Listen(const std::string& host, unsigned short port);
+
+    /*!
+     * \brief Stops accepting connections and makes Listen() return.
+     */
+    void Stop();
+
+    /*!
+     * \brief Dispatches a request to its route; called by connections.
+     */
+    void Dispatch(const HttpRequest& request, Responder respond) const;
+
+    /*!
+     * \brief Returns the limits applied to connections.
+     */
+    const HttpLimits& Limits() const { return limits_; }
+
+    /*!
+     * \brief Returns the counters of every route; safe to call while the server is running.
+     */
+    std::vector<RouteStats> GetRouteStats() const;
+
+    /*!
+     * \brief Returns the number of requests for paths without a route.
+     */
+    std::uint64_t UnroutedRequests() const { return unrouted_.Value(); }
+
+private:
+    /*! \brief Instrumentation of a route; sharded, so recording does not contend between I/O threads. */
+    struct RouteMetrics {
+        ShardedCounter requests;     ///< Requests dispatched.
+        ShardedCounter errors;       ///< Responses with status >= 400.
+        LatencyHistogram latency;    ///< Dispatch-to-response time.
+    };
+
+    /*! \brief Handler of a route with its counters. */
+    struct Route {
+        AsyncHandler handler;                    ///< Route handler.
+        std::unique_ptr<RouteMetrics> metrics;   ///< Counters; kept stable while the map changes.
+    };
+
+    void AddRoute(const std::string& method, const std::string& path, AsyncHandler handler);
+
+    void DoAccept();
+    AsyncHandler SpawnCoroutine(CoroutineHandler handler);
+
+    std::size_t io_threads_;                                           ///< Number of I/O threads.
+    HttpLimits limits_;                                                ///< Per-connection limits.
+    boost::asio::io_context ioc_;                                      ///< I/O context shared by all connections.
+    boost::asio::ip::tcp::acceptor acceptor_;                          ///< Listening socket.
+    boost::asio::thread_pool blocking_pool_;                           ///< Workers for offloaded handlers.
+    std::map<std::pair<std::string, std::string>, Route> routes_;      ///< Handlers by method and path.
+    mutable ShardedCounter unrouted_;                                  ///< Requests answered with 404.
+    std::vector<Filter> filters_;                                      ///< Checks run before every handler.
+    ConcurrencyLimiter* limiter_ = nullptr;                            ///< Load shedding; none if nullptr.
+    std::unordered_map<std::string, RequestPriority> priorities_;      ///< Priority classes by path.
+    std::vector<std::thread> threads_;                                 ///< I/O threads besides the caller of Listen().
+};
@@ -47,7 +47,7 @@ char KingCell::getSymbol() const {
   return (colour_ == Colour::WHITE) ? 'K' : 'k';
 }
 
-bool KingCell::IsCellUnderAttack(const std::vector<std::vector<std::shared_ptr<Cell>>>& board) const {
+bool KingCell::IsCellUnderAttack(const Board& board) const {
 
   Colour opponentColour = (colour_ == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
 
@@ -64,7 +64,7 @@ bool KingCell::IsCellUnderAttack(const std::vector<std::vector<std::shared_ptr<C
   return false;
 }
 
-bool KingCell::canCastle(bool isShort, const std::vector<std::vector<std::shared_ptr<Cell>>>& board) const {
+bool KingCell::canCastle(bool isShort, const Board& board) const {
   if (hasMoved)
     return false;  // перенести в Table
 
@@ -93,7 +93,7 @@ bool KingCell::canCastle(bool isShort, const std::vector<std::vector<std::shared
   return true;
 }
 
-void KingCell::performCastle(bool isShort, std::vector<std::vector<std::shared_ptr<Cell>>>& board) {
+void KingCell::performCastle(bool isShort, Board& board) {
   int row = coord_.row;
   int col = coord_.col;
 
@@ -101,9 +101,9 @@ void KingCell::performCastle(bool isShort, std::vector<std::vector<std::shared_p
   int direction = isShort ? 1 : -1;
 
   board[row][col + 2 * direction] = board[row][col];
-  board[row][col] = std::make_shared<EmptyCell>(Coord{row, col});
+  board[row][col] = std::allocate_shared<EmptyCell>(board.get_allocator(), Coord{row, col});
   coord_.col += 2 * direction;
 
   board[row][col + direction] = board[row][rookCol];
-  board[row][rookCol] = std::make_shared<EmptyCell>(Coord{row, rookCol});
+  board[row][rookCol] = std::allocate_shared<EmptyCell>(board.get_allocator(), Coord{row, rookCol});
 }
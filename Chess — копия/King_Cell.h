@@ -72,7 +72,7 @@ class KingCell : public Cell {
    \param board A reference to the chessboard.
    \return `true` if castling is possible; otherwise, `false`.
    */
-  bool canCastle(bool isShort, const std::vector<std::vector<std::shared_ptr<Cell>>>& board) const;
+  bool canCastle(bool isShort, const Board& board) const;
 
   /*!
    \brief Performs castling for the king.
@@ -81,7 +81,7 @@ class KingCell : public Cell {
    \param isShort A boolean indicating if the move is short castling (true) or long castling (false).
    \param board A reference to the chessboard.
    */
-  void performCastle(bool isShort, std::vector<std::vector<std::shared_ptr<Cell>>>& board);
+  void performCastle(bool isShort, Board& board);
 
   /*!
    \brief Checks if a specific cell is under attack.
@@ -90,7 +90,7 @@ class KingCell : public Cell {
    \param board A reference to the chessboard.
    \return `true` if the cell is under attack; otherwise, `false`.
    */
-  bool IsCellUnderAttack(const std::vector<std::vector<std::shared_ptr<Cell>>>& board) const;
+  bool IsCellUnderAttack(const Board& board) const;
 
  private:
   bool hasMoved = false;  ///< Indicates whether the king has moved during the game.
@@ -0,0 +1,391 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Load_Generator.h"
+
+#include <boost/beast.hpp>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string_view>
+
+#include "Empty_Cell.h"
+#include "Manager.h"
+#include "Table.h"
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+constexpr auto kRequestTimeout = std::chrono::seconds(60);   ///< Longer than the server's long poll.
+constexpr int kMaxSilentPolls = 2;                           ///< Empty /wait replies before giving up on the opponent.
+constexpr int kMaxAuthAttempts = 3;                          ///< /auth calls before a bot counts as unpaired.
+constexpr int kMaxRetries = 5;                               ///< Attempts of a request answered with 429 or 503.
+constexpr auto kRetryPause = std::chrono::milliseconds(100); ///< Pause before such a retry.
+constexpr auto kProgressPeriod = std::chrono::seconds(5);    ///< How often progress is printed.
+
+/*! \brief Text of a square in the notation of Manager::ConvertToCoord(). */
+std::string SquareName(Coord coord) {
+    return {static_cast<char>('a' + coord.col), static_cast<char>('0' + 8 - coord.row)};
+}
+
+/*!
+ * \brief Picks a random move the server accepts, or returns an empty string if there is none.
+ */
+std::string RandomMove(const Table& table, Colour colour, std::mt19937& random) {
+    std::vector<std::pair<Coord, Coord>> moves;
+    const auto& board = table.getBoard();
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const auto& cell = board[row][col];
+            if (cell->Name() == EmptyName || cell->getColour() != colour) {
+                continue;
+            }
+            for (Coord to : cell->getReservedSteps()) {
+                if (table.CheckTurn({row, col}, to) == Table::TurnVerdict::correct) {
+                    moves.emplace_back(Coord{row, col}, to);
+                }
+            }
+        }
+    }
+    if (moves.empty()) {
+        return {};
+    }
+    auto [from, to] = moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(random)];
+    return SquareName(from) + " " + SquareName(to);
+}
+
+/*! \brief Applies a move accepted by the server to the bot's copy of the board. */
+bool ApplyMove(Table& table, Manager& manager, const std::string& move) {
+    auto [from, to] = manager.WordToCoord(table.getBoard(), move);
+    if (from.row == 8 || to.row == 8) {
+        return false;
+    }
+    table.DoTurn(from, to);
+    return true;
+}
+
+/*! \brief Reads an integer that follows \p key in \p text. */
+std::optional<int> FindNumber(std::string_view text, std::string_view key) {
+    auto pos = text.find(key);
+    if (pos == std::string_view::npos) {
+        return std::nullopt;
+    }
+    try {
+        return std::stoi(std::string(text.substr(pos + key.size())));
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+/*! \brief Percent-encodes a form value. */
+std::string FormEncode(std::string_view value) {
+    static const char* kHex = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.') {
+            out.push_back(static_cast<char>(c));
+        } else if (c == ' ') {
+            out.push_back('+');
+        } else {
+            out += {'%', kHex[c >> 4], kHex[c & 15]};
+        }
+    }
+    return out;
+}
+
+}
+
+/*!
+ * \class LoadGenerator::Connection
+ * \brief Keep-alive HTTP connection of one bot; reconnects when the server closes it.
+ */
+class LoadGenerator::Connection {
+public:
+    Connection(LoadGenerator& generator, net::any_io_executor executor)
+        : generator_(generator), stream_(std::move(executor)) {}
+
+    /*!
+     * \brief Sends a request and records its latency under \p endpoint.
+     * \details Requests shed with 429 or 503 are retried after a short pause; every attempt counts.
+     * \return The response, or std::nullopt if the request failed.
+     */
+    Task<std::optional<http::response<http::string_body>>> Send(Endpoint endpoint, http::verb method,
+                                                                 std::string target, std::string body = {}) {
+        EndpointStats& stats = generator_.stats_[endpoint];
+        for (int attempt = 0; attempt < kMaxRetries; ++attempt) {
+            stats.requests.Add();
+            auto start = std::chrono::steady_clock::now();
+            auto response = co_await Exchange(method, target, body);
+            stats.latency.Record(std::chrono::steady_clock::now() - start);
+
+            bool shed = response && (response->result() == http::status::too_many_requests ||
+                                     response->result() == http::status::service_unavailable);
+            bool failed = !response || response->result_int() >= 400 || response->body().starts_with("Error:");
+            if (failed) {
+                stats.errors.Add();
+            }
+            if (!shed) {
+                if (failed) {
+                    co_return std::nullopt;
+                }
+                co_return response;
+            }
+
+            net::steady_timer pause(stream_.get_executor());
+            pause.expires_after(kRetryPause);
+            co_await pause.async_wait(net::use_awaitable);
+        }
+        co_return std::nullopt;
+    }
+
+private:
+    /*! \brief One request-response round-trip; a stale keep-alive connection is reopened once. */
+    Task<std::optional<http::response<http::string_body>>> Exchange(http::verb method, const std::string& target,
+                                                                     const std::string& body) {
+        http::request<http::string_body> request{method, target, 11};
+        request.set(http::field::host, generator_.options_.host);
+        request.keep_alive(true);
+        if (!body.empty()) {
+            request.set(http::field::content_type, "application/x-www-form-urlencoded");
+            request.body() = body;
+        }
+        request.prepare_payload();
+
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            bool reused = open_;
+            beast::error_code ec;
+            if (!open_) {
+                stream_.expires_after(kRequestTimeout);
+                co_await stream_.async_connect(generator_.endpoints_, net::redirect_error(net::use_awaitable, ec));
+                if (ec) {
+                    co_return std::nullopt;
+                }
+                open_ = true;
+            }
+
+            stream_.expires_after(kRequestTimeout);
+            co_await http::async_write(stream_, request, net::redirect_error(net::use_awaitable, ec));
+            http::response<http::string_body> response;
+            if (!ec) {
+                co_await http::async_read(stream_, buffer_, response, net::redirect_error(net::use_awaitable, ec));
+            }
+            if (!ec) {
+                if (!response.keep_alive()) {
+                    Close();
+                }
+                co_return response;
+            }
+
+            Close();
+            // сервер мог закрыть простаивающее соединение — тогда повторяем один раз на новом
+            if (!reused) {
+                break;
+            }
+        }
+        co_return std::nullopt;
+    }
+
+    void Close() {
+        beast::error_code ec;
+        stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+        stream_.close();
+        buffer_.clear();
+        open_ = false;
+    }
+
+    LoadGenerator& generator_;     ///< Owner; collects the statistics.
+    beast::tcp_stream stream_;     ///< Socket with timeouts.
+    beast::flat_buffer buffer_;    ///< Read buffer.
+    bool open_ = false;            ///< The socket is connected.
+};
+
+LoadGenerator::LoadGenerator(LoadOptions options) : options_(std::move(options)) {}
+
+void LoadGenerator::Run() {
+    tcp::resolver resolver(ioc_);
+    endpoints_ = resolver.resolve(options_.host, options_.port);
+
+    start_ = std::chrono::steady_clock::now();
+    net::co_spawn(ioc_, SpawnBots(), net::detached);
+    net::co_spawn(ioc_, ReportProgress(), net::detached);
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < options_.threads; ++i) {
+        threads.emplace_back([this]() { ioc_.run(); });
+    }
+    ioc_.run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    end_ = std::chrono::steady_clock::now();
+}
+
+Task<> LoadGenerator::SpawnBots() {
+    auto executor = co_await net::this_coro::executor;
+    net::steady_timer timer(executor);
+    auto next = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < options_.players; ++i) {
+        if (options_.arrival_rate > 0 && i > 0) {
+            // равномерный поток прибытия, без накопления ошибки округления
+            next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / options_.arrival_rate));
+            timer.expires_at(next);
+            co_await timer.async_wait(net::use_awaitable);
+        }
+        // у каждого бота свой strand: его корутина не выполняется параллельно сама с собой
+        net::co_spawn(net::make_strand(ioc_), PlayBot(i), [this](std::exception_ptr error) { OnBotFinished(error); });
+    }
+}
+
+Task<> LoadGenerator::PlayBot(std::size_t index) {
+    std::mt19937 random(options_.seed + static_cast<std::uint32_t>(index));
+    Connection connection(*this, co_await net::this_coro::executor);
+
+    int rating = std::uniform_int_distribution<int>(1300, 1700)(random);
+    std::optional<http::response<http::string_body>> auth;
+    for (int attempt = 0; attempt < kMaxAuthAttempts; ++attempt) {
+        auth = co_await connection.Send(Auth, http::verb::post, "/auth",
+                                        "username=" + FormEncode("bot" + std::to_string(index)) +
+                                        "&rating=" + std::to_string(rating));
+        if (!auth) {
+            co_return;
+        }
+        // сервер отозвал билет после ожидания: встаём в очередь заново, как живой клиент
+        if (auth->body().find("No opponent found") == std::string::npos) {
+            break;
+        }
+    }
+    std::optional<int> player_id = FindNumber(auth->body(), "ID = ");
+    std::string token(auth->base()["X-Session-Token"]);
+    bool white = auth->body().find("Color = White") != std::string::npos;
+    bool black = auth->body().find("Color = Black") != std::string::npos;
+    if (!player_id || (!white && !black)) {
+        unpaired_.fetch_add(1, std::memory_order_relaxed);
+        co_return;
+    }
+    std::string credentials = "id_player=" + std::to_string(*player_id) + "&token=" + FormEncode(token);
+
+    Table table;
+    Manager manager;
+    Colour colour = white ? Colour::WHITE : Colour::BLACK;
+    std::exponential_distribution<double> think(1.0 / std::max<double>(1, options_.think_time.count()));
+    net::steady_timer timer(co_await net::this_coro::executor);
+    int ply = 0;
+    int silent_polls = 0;
+
+    while (ply < options_.max_plies) {
+        bool my_turn = (ply % 2 == 0) == white;
+        if (my_turn) {
+            timer.expires_after(std::chrono::milliseconds(static_cast<long long>(think(random))));
+            co_await timer.async_wait(net::use_awaitable);
+
+            std::string move = RandomMove(table, colour, random);
+            if (move.empty()) {
+                break;
+            }
+            auto reply = co_await connection.Send(Move, http::verb::post, "/move",
+                                                  credentials + "&move=" + FormEncode(move));
+            if (!reply || reply->body() != "Move accepted" || !ApplyMove(table, manager, move)) {
+                break;
+            }
+            moves_.fetch_add(1, std::memory_order_relaxed);
+            ++ply;
+
+            co_await connection.Send(Status, http::verb::get, "/status?" + credentials);
+            continue;
+        }
+
+        auto update = co_await connection.Send(Wait, http::verb::get,
+                                               "/wait?" + credentials + "&since_ply=" + std::to_string(ply));
+        if (!update) {
+            break;
+        }
+        std::optional<int> new_ply = FindNumber(update->body(), "Ply = ");
+        auto move_start = update->body().find("Move = ");
+        if (update->body().starts_with("No new moves") || !new_ply || move_start == std::string::npos) {
+            // соперник ушёл или думает дольше нескольких long poll'ов
+            if (++silent_polls > kMaxSilentPolls) {
+                break;
+            }
+            continue;
+        }
+        silent_polls = 0;
+        auto move_end = update->body().find('\n', move_start);
+        std::string move = update->body().substr(move_start + 7, move_end - move_start - 7);
+        if (*new_ply != ply + 1 || !ApplyMove(table, manager, move)) {
+            break;
+        }
+        ply = *new_ply;
+    }
+}
+
+Task<> LoadGenerator::ReportProgress() {
+    net::steady_timer timer(co_await net::this_coro::executor);
+    std::uint64_t last_moves = 0;
+    while (finished_.load() < options_.players) {
+        timer.expires_after(kProgressPeriod);
+        co_await timer.async_wait(net::use_awaitable);
+        std::uint64_t moves = moves_.load();
+        std::cout << "… " << finished_.load() << "/" << options_.players << " bots finished, "
+                  << static_cast<double>(moves - last_moves) / std::chrono::duration<double>(kProgressPeriod).count()
+                  << " moves/s" << std::endl;
+        last_moves = moves;
+    }
+}
+
+void LoadGenerator::OnBotFinished(std::exception_ptr error) {
+    if (error) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    finished_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<EndpointReport> LoadGenerator::Report() const {
+    std::vector<EndpointReport> reports;
+    for (std::size_t i = 0; i < kEndpoints; ++i) {
+        const EndpointStats& stats = stats_[i];
+        reports.push_back({PathOf(static_cast<Endpoint>(i)), stats.requests.Value(), stats.errors.Value(),
+                           stats.latency.Snapshot()});
+    }
+    return reports;
+}
+
+void LoadGenerator::PrintReport(std::ostream& out) const {
+    double seconds = std::chrono::duration<double>(end_ - start_).count();
+    out << "Players: " << options_.players << ", unpaired: " << unpaired_.load() << ", failed: " << failed_.load()
+        << ", accepted moves: " << moves_.load() << ", duration: " << std::fixed << std::setprecision(1) << seconds
+        << " s\n";
+    out << std::left << std::setw(10) << "endpoint" << std::right << std::setw(10) << "requests" << std::setw(9)
+        << "errors" << std::setw(10) << "req/s" << std::setw(11) << "p50 ms" << std::setw(11) << "p99 ms"
+        << std::setw(11) << "p999 ms" << "\n";
+
+    // квантили — верхние границы корзин гистограммы, т.е. с погрешностью до 1/8 сверху
+    auto millis = [](std::uint64_t micros) { return static_cast<double>(micros) / 1000.0; };
+    for (const EndpointReport& report : Report()) {
+        out << std::left << std::setw(10) << report.path << std::right << std::setw(10) << report.requests
+            << std::setw(9) << report.errors << std::setw(10) << std::setprecision(1)
+            << (seconds > 0 ? static_cast<double>(report.requests) / seconds : 0.0) << std::setprecision(3)
+            << std::setw(11) << millis(report.latency.Quantile(0.5)) << std::setw(11)
+            << millis(report.latency.Quantile(0.99)) << std::setw(11) << millis(report.latency.Quantile(0.999))
+            << "\n";
+    }
+    out << "/wait includes the opponent's think time; /auth includes waiting for the matchmaker.\n";
+}
+
+const char* LoadGenerator::PathOf(Endpoint endpoint) {
+    switch (endpoint) {
+        case Auth: return "/auth";
+        case Move: return "/move";
+        case Status: return "/status";
+        case Wait: return "/wait";
+        case kEndpoints: break;
+    }
+    return "?";
+}
@@ -0,0 +1,107 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Async_Task.h"
+#include "Metrics.h"
+
+/*! \brief
+ *   Settings of a load run.
+ */
+struct LoadOptions {
+    std::string host = "127.0.0.1";                  ///< Server address.
+    std::string port = "9090";                       ///< Server HTTP port.
+    std::size_t players = 100;                       ///< Number of simulated players.
+    double arrival_rate = 0;                         ///< New players per second; 0 starts all at once.
+    std::chrono::milliseconds think_time{500};       ///< Mean pause before a move, exponentially distributed.
+    int max_plies = 40;                              ///< A bot leaves its game after this many half-moves.
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());  ///< Client I/O threads.
+    std::uint32_t seed = 1;                          ///< Seed of move choice, ratings and think times.
+};
+
+/*! \brief
+ *   Results of one endpoint over a run.
+ */
+struct EndpointReport {
+    std::string path;              ///< Endpoint, e.g. "/move".
+    std::uint64_t requests = 0;    ///< Requests sent.
+    std::uint64_t errors = 0;      ///< Failed requests: transport errors, HTTP errors and "Error:" replies.
+    HistogramSnapshot latency;     ///< Request latencies.
+};
+
+/*!
+ * \class LoadGenerator
+ * \brief Simulates concurrent players against a running server.
+ * \details Every bot is a coroutine with its own keep-alive HTTP connection. It authenticates with
+ * `/auth`, which returns once the matchmaker has paired it, and then plays its game: on its turn it
+ * waits for the think time, sends a random move through `/move` and reads `/status`; on the
+ * opponent's turn it long-polls `/wait`. Bots keep a copy of the board built with the server's own
+ * Table, so every move they choose is one the server accepts. A bot leaves when it has no moves,
+ * after `max_plies` half-moves, or when its opponent stops answering.
+ *
+ * Latencies are recorded per endpoint into the histograms used by the server metrics.
+ */
+class LoadGenerator {
+public:
+    explicit LoadGenerator(LoadOptions options);
+
+    /*!
+     * \brief Starts the bots and blocks until every one of them has finished.
+     * \throws boost::system::system_error if the server address cannot be resolved.
+     */
+    void Run();
+
+    /*! \brief Returns the per-endpoint results collected so far. */
+    std::vector<EndpointReport> Report() const;
+
+    /*!
+     * \brief Prints throughput, errors and latency quantiles of every endpoint.
+     * \param out Output stream.
+     */
+    void PrintReport(std::ostream& out) const;
+
+private:
+    /*! \brief Endpoints measured by the generator. */
+    enum Endpoint : std::size_t { Auth, Move, Status, Wait, kEndpoints };
+
+    struct EndpointStats {
+        ShardedCounter requests;    ///< Requests sent.
+        ShardedCounter errors;      ///< Failed requests.
+        LatencyHistogram latency;   ///< Request latencies.
+    };
+
+    class Connection;
+
+    Task<> SpawnBots();
+    Task<> PlayBot(std::size_t index);
+    Task<> ReportProgress();
+    void OnBotFinished(std::exception_ptr error);
+
+    static const char* PathOf(Endpoint endpoint);
+
+    LoadOptions options_;                                       ///< Settings.
+    boost::asio::io_context ioc_;                               ///< Runs the bots.
+    boost::asio::ip::tcp::resolver::results_type endpoints_;    ///< Resolved server address.
+    std::array<EndpointStats, kEndpoints> stats_;               ///< Results per endpoint.
+
+    std::atomic<std::size_t> finished_{0};        ///< Bots that have left.
+    std::atomic<std::size_t> failed_{0};          ///< Bots stopped by an exception.
+    std::atomic<std::size_t> unpaired_{0};        ///< Bots the matchmaker did not pair in time.
+    std::atomic<std::uint64_t> moves_{0};         ///< Accepted moves.
+    std::chrono::steady_clock::time_point start_; ///< Start of the run.
+    std::chrono::steady_clock::time_point end_;   ///< End of the run.
+};
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "Load_Generator.h"
+
+int main(int argc, char* argv[]) {
+    // --host=ADDRESS, --port=PORT: server to load (127.0.0.1:9090)
+    // --players=N: number of simulated players
+    // --arrival-rate=R: new players per second (0 starts all of them at once)
+    // --think-ms=MS: mean pause before each move
+    // --max-plies=N: half-moves after which a game is left
+    // --threads=N: client I/O threads
+    // --seed=N: seed of moves, ratings and think times
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const std::string& prefix) { return arg.substr(prefix.size()); };
+        try {
+            if (arg.starts_with("--host=")) {
+                options.host = value("--host=");
+            } else if (arg.starts_with("--port=")) {
+                options.port = value("--port=");
+            } else if (arg.starts_with("--players=")) {
+                options.players = std::stoul(value("--players="));
+            } else if (arg.starts_with("--arrival-rate=")) {
+                options.arrival_rate = std::stod(value("--arrival-rate="));
+            } else if (arg.starts_with("--think-ms=")) {
+                options.think_time = std::chrono::milliseconds(std::stol(value("--think-ms=")));
+            } else if (arg.starts_with("--max-plies=")) {
+                options.max_plies = std::stoi(value("--max-plies="));
+            } else if (arg.starts_with("--threads=")) {
+                options.threads = std::max<std::size_t>(1, std::stoul(value("--threads=")));
+            } else if (arg.starts_with("--seed=")) {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value("--seed=")));
+            } else {
+                std::cerr << "❌ Unknown option " << arg << std::endl;
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "❌ Invalid value in " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    LoadGenerator generator(options);
+    try {
+        generator.Run();
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+    generator.PrintReport(std::cout);
+    return 0;
+}
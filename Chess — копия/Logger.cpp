@@ -0,0 +1,272 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+
+/*!
+ * \brief Ring of the current thread; marks it orphaned when the thread exits.
+ * \details The ring is shared with the logger, so records the thread made just before exiting are
+ * still written.
+ */
+struct LoggerThreadRing {
+    std::shared_ptr<Logger::Ring> ring;
+
+    ~LoggerThreadRing() {
+        if (ring) {
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+namespace {
+
+constexpr auto kIdleFlushPeriod = std::chrono::seconds(1);  ///< Longest sleep of the writer; a fallback to wake-ups.
+
+const char* LevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO ";
+        case LogLevel::Warn: return "WARN ";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off: break;
+    }
+    return "?    ";
+}
+
+/*!
+ * \brief Appends to a fixed buffer and silently truncates at its end.
+ */
+class SlotWriter {
+public:
+    SlotWriter(char* begin, std::size_t capacity) : pos_(begin), end_(begin + capacity) {}
+
+    void Put(char c) {
+        if (pos_ != end_) {
+            *pos_++ = c;
+        }
+    }
+
+    void Put(std::string_view text) {
+        std::size_t n = std::min<std::size_t>(text.size(), end_ - pos_);
+        std::memcpy(pos_, text.data(), n);
+        pos_ += n;
+    }
+
+    void Put(std::int64_t value) {
+        auto [next, ec] = std::to_chars(pos_, end_, value);
+        if (ec == std::errc()) {
+            pos_ = next;
+        } else {
+            pos_ = end_;
+        }
+    }
+
+    /*! \brief Writes a logfmt value, quoted and escaped if it contains spaces or special characters. */
+    void PutValue(std::string_view text) {
+        bool plain = !text.empty() && std::none_of(text.begin(), text.end(), [](char c) {
+            return c == ' ' || c == '=' || c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        });
+        if (plain) {
+            Put(text);
+            return;
+        }
+        Put('"');
+        for (char c : text) {
+            switch (c) {
+                case '"': Put("\\\""); break;
+                case '\\': Put("\\\\"); break;
+                case '\n': Put("\\n"); break;
+                case '\r': Put("\\r"); break;
+                case '\t': Put("\\t"); break;
+                default: Put(c);
+            }
+        }
+        Put('"');
+    }
+
+    char* Position() const { return pos_; }
+
+private:
+    char* pos_;         ///< Next free byte.
+    char* const end_;   ///< End of the buffer.
+};
+
+}
+
+Logger& Logger::Instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : writer_([this] { Loop(); }) {}
+
+Logger::~Logger() {
+    running_.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_requested_ = true;
+    }
+    wake_cv_.notify_one();
+    writer_.join();
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    FlushLocked();
+}
+
+void Logger::Write(LogLevel level, std::string_view message, std::initializer_list<LogField> fields) {
+    Ring& ring = LocalRing();
+    std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= kRingRecords) {
+        // писатель не успевает — теряем запись, но не тормозим игру
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = ring.records[head % kRingRecords];
+    record.time = std::chrono::system_clock::now();
+    record.thread = ring.thread;
+    record.level = level;
+
+    SlotWriter text(record.text, kTextBytes);
+    text.Put(message);
+    for (const LogField& field : fields) {
+        text.Put(' ');
+        text.Put(field.key);
+        text.Put('=');
+        if (field.is_number) {
+            text.Put(field.number);
+        } else {
+            text.PutValue(field.text);
+        }
+    }
+    record.length = static_cast<std::uint16_t>(text.Position() - record.text);
+
+    // seq_cst в паре с Loop(): либо писатель увидит запись, либо мы увидим, что он засыпает
+    ring.head.store(head + 1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        Wake();
+    }
+}
+
+void Logger::Wake() {
+    // будит только первый поток, заставший писателя спящим
+    if (!sleeping_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_requested_ = true;
+    }
+    wake_cv_.notify_one();
+}
+
+void Logger::SetOutput(std::FILE* output) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    FlushLocked();
+    output_ = output;
+}
+
+void Logger::Flush() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    FlushLocked();
+}
+
+Logger::Ring& Logger::LocalRing() {
+    thread_local LoggerThreadRing local;
+    if (!local.ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        local.ring = std::make_shared<Ring>(next_thread_++);
+        rings_.push_back(local.ring);
+    }
+    return *local.ring;
+}
+
+void Logger::Loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            if (FlushLocked()) {
+                continue;
+            }
+        }
+
+        // кольца пусты: объявляем сон и проверяем ещё раз, чтобы не пропустить запись между проверками
+        sleeping_.store(true, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            if (FlushLocked()) {
+                sleeping_.store(false, std::memory_order_relaxed);
+                continue;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, kIdleFlushPeriod, [this]() { return wake_requested_; });
+        wake_requested_ = false;
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool Logger::DrainLocked(std::string& out) {
+    for (auto it = rings_.begin(); it != rings_.end();) {
+        Ring& ring = **it;
+        // сначала флаг: после него поток уже ничего не запишет
+        bool orphaned = ring.orphaned.load(std::memory_order_acquire);
+        std::uint64_t head = ring.head.load(std::memory_order_seq_cst);
+        std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            Format(out, ring.records[tail % kRingRecords]);
+        }
+        ring.tail.store(tail, std::memory_order_release);
+
+        if (orphaned) {
+            it = rings_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+        Record record{std::chrono::system_clock::now(), 0, 0, LogLevel::Warn, {}};
+        SlotWriter text(record.text, kTextBytes);
+        text.Put("log records dropped count=");
+        text.Put(static_cast<std::int64_t>(dropped - reported_dropped_));
+        record.length = static_cast<std::uint16_t>(text.Position() - record.text);
+        Format(out, record);
+        reported_dropped_ = dropped;
+    }
+    return !out.empty();
+}
+
+bool Logger::FlushLocked() {
+    std::string out;
+    if (!DrainLocked(out)) {
+        return false;
+    }
+    std::fwrite(out.data(), 1, out.size(), output_);
+    std::fflush(output_);
+    return true;
+}
+
+void Logger::Format(std::string& out, const Record& record) {
+    auto since_epoch = record.time.time_since_epoch();
+    std::time_t seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch).count();
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count() % 1000;
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+
+    char header[64];
+    int length = std::snprintf(header, sizeof(header), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ %s t%u ",
+                               utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min,
+                               utc.tm_sec, static_cast<int>(millis), LevelName(record.level), record.thread);
+    out.append(header, static_cast<std::size_t>(length));
+    out.append(record.text, record.length);
+    out.push_back('\n');
+}
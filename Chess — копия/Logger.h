@@ -0,0 +1,176 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*! \brief
+ *   Severity of a log record.
+ */
+enum class LogLevel {
+    Trace,   ///< Per-step details of move validation and queries.
+    Debug,   ///< Per-request events, e.g. rejected moves.
+    Info,    ///< Lifecycle of games and players.
+    Warn,    ///< Unexpected but handled situations.
+    Error,   ///< Failed operations.
+    Off,     ///< Disables logging entirely.
+};
+
+#ifndef CHESS_LOG_LEVEL
+#define CHESS_LOG_LEVEL 2  ///< Lowest compiled-in level as an index of LogLevel; 2 is Info.
+#endif
+
+/*! \brief Returns true if records of \p level are compiled in. */
+constexpr bool LogEnabled(LogLevel level) {
+    return static_cast<int>(level) >= CHESS_LOG_LEVEL && level != LogLevel::Off;
+}
+
+/*! \brief
+ *   Structured field of a log record, written as `key=value`.
+ *   The field only refers to its key and string value, so it must not outlive the log statement.
+ */
+struct LogField {
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    LogField(std::string_view key, T value) : key(key), is_number(true), number(static_cast<std::int64_t>(value)) {}
+    LogField(std::string_view key, std::string_view value) : key(key), text(value) {}
+    LogField(std::string_view key, const char* value) : key(key), text(value) {}
+    LogField(std::string_view key, bool value) : key(key), text(value ? "true" : "false") {}
+
+    std::string_view key;         ///< Field name, e.g. "game_id".
+    std::string_view text;        ///< Value of a string field.
+    bool is_number = false;       ///< The value is in number rather than text.
+    std::int64_t number = 0;      ///< Value of an integral field.
+};
+
+/*!
+ * \class Logger
+ * \brief Asynchronous structured logger.
+ * \details A log statement formats its record into a fixed-size slot of a ring buffer owned by the
+ * calling thread and returns: there is no lock, no allocation and no system call on the caller's side.
+ * Each ring has a single producer and the writer thread is its single consumer, so publishing a record
+ * is one release store. The writer thread drains all rings and writes the batch to the output with one
+ * call; records of different threads are not merged by time. When every ring is empty the writer sleeps
+ * until a record lands in an empty ring, so an idle server costs no wake-ups beyond a slow fallback check.
+ *
+ * When a ring is full the record is dropped and counted rather than blocking the caller; the number of
+ * dropped records is reported by the writer. Records below CHESS_LOG_LEVEL are removed at compile time
+ * by the CHESS_LOG_* macros, together with the evaluation of their arguments.
+ *
+ * Records are written in logfmt: `time level thread message key=value ...`.
+ */
+class Logger {
+public:
+    static constexpr std::size_t kTextBytes = 240;     ///< Room for the message and fields of a record.
+    static constexpr std::size_t kRingRecords = 512;   ///< Slots per thread.
+
+    /*! \brief Returns the process-wide logger, starting its writer thread on first use. */
+    static Logger& Instance();
+
+    /*! \brief Drains all rings and stops the writer thread. */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /*!
+     * \brief Queues a record; normally called through the CHESS_LOG_* macros.
+     * \details A record longer than the slot is truncated.
+     * \param level Severity.
+     * \param message Constant part of the record.
+     * \param fields Structured fields.
+     */
+    void Write(LogLevel level, std::string_view message, std::initializer_list<LogField> fields = {});
+
+    /*!
+     * \brief Redirects the output; stderr by default.
+     * \param output Open stream; the logger does not close it.
+     */
+    void SetOutput(std::FILE* output);
+
+    /*!
+     * \brief Blocks until every record queued before the call has been written.
+     */
+    void Flush();
+
+    /*! \brief Returns the number of records dropped because a ring was full. */
+    std::uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        std::chrono::system_clock::time_point time;   ///< When the record was made.
+        std::uint32_t thread;                         ///< Number of the producing thread.
+        std::uint16_t length;                         ///< Bytes used in text.
+        LogLevel level;                               ///< Severity.
+        char text[kTextBytes];                        ///< Message and fields.
+    };
+
+    /*! \brief Single-producer single-consumer ring of one thread. */
+    struct Ring {
+        explicit Ring(std::uint32_t thread) : thread(thread) {}
+
+        alignas(64) std::atomic<std::uint64_t> head{0};   ///< Next slot to write; producer only.
+        alignas(64) std::atomic<std::uint64_t> tail{0};   ///< Next slot to read; writer only.
+        std::atomic<bool> orphaned{false};                ///< The thread has exited.
+        const std::uint32_t thread;                       ///< Number of the thread.
+        std::array<Record, kRingRecords> records;         ///< Slots.
+    };
+
+    friend struct LoggerThreadRing;
+
+    Logger();
+
+    Ring& LocalRing();
+    void Loop();
+    bool DrainLocked(std::string& out);
+    bool FlushLocked();
+    void Wake();
+    static void Format(std::string& out, const Record& record);
+
+    std::mutex rings_mutex_;                     ///< Guards rings_, output_ and consuming from the rings.
+    std::vector<std::shared_ptr<Ring>> rings_;   ///< Rings of all threads that logged.
+    std::uint32_t next_thread_ = 0;              ///< Number of the next registered thread.
+    std::FILE* output_ = stderr;                 ///< Destination.
+
+    std::atomic<std::uint64_t> dropped_{0};      ///< Records lost to full rings.
+    std::uint64_t reported_dropped_ = 0;         ///< Dropped records already reported; guarded by rings_mutex_.
+    std::atomic<bool> running_{true};            ///< Cleared by the destructor.
+    std::atomic<bool> sleeping_{false};          ///< The writer found the rings empty and is about to park.
+    std::mutex wake_mutex_;                      ///< Guards wake_requested_.
+    std::condition_variable wake_cv_;            ///< Wakes the parked writer.
+    bool wake_requested_ = false;                ///< A record arrived or the logger is stopping.
+    std::thread writer_;                         ///< Writer thread.
+};
+
+/*!
+ * \brief Logs a record with the given level if it is compiled in.
+ * \details Usage: `CHESS_LOG(LogLevel::Info, "game created", {"game_id", id}, {"player_id", player});`
+ * Arguments of a disabled statement are not evaluated.
+ */
+#define CHESS_LOG(level, message, ...)                                  \
+    do {                                                                \
+        if constexpr (LogEnabled(level)) {                              \
+            Logger::Instance().Write(level, message, {__VA_ARGS__});    \
+        }                                                               \
+    } while (false)
+
+#define CHESS_LOG_TRACE(...) CHESS_LOG(LogLevel::Trace, __VA_ARGS__)
+#define CHESS_LOG_DEBUG(...) CHESS_LOG(LogLevel::Debug, __VA_ARGS__)
+#define CHESS_LOG_INFO(...) CHESS_LOG(LogLevel::Info, __VA_ARGS__)
+#define CHESS_LOG_WARN(...) CHESS_LOG(LogLevel::Warn, __VA_ARGS__)
+#define CHESS_LOG_ERROR(...) CHESS_LOG(LogLevel::Error, __VA_ARGS__)
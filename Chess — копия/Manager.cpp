@@ -18,7 +18,7 @@ bool Manager::IsValidCoord(const Coord& coord) {
     return coord.row >= 0 && coord.row < 8 && coord.col >= 0 && coord.col < 8;
 }
 
-std::pair<Coord, Coord> Manager::HandleWhiteCastle(const std::vector<std::vector<std::shared_ptr<Cell>>>& board, const std::string& message) {
+std::pair<Coord, Coord> Manager::HandleWhiteCastle(const Board& board, const std::string& message) {
     auto king = std::dynamic_pointer_cast<KingCell>(board[0][4]);
     if (king && king->canCastle(true, board)) {
         return {{0, 4}, {0, 6}};
@@ -28,7 +28,7 @@ std::pair<Coord, Coord> Manager::HandleWhiteCastle(const std::vector<std::vector
     return {};
 }
 
-std::pair<Coord, Coord> Manager::HandleBlackCastle(const std::vector<std::vector<std::shared_ptr<Cell>>>& board, const std::string& message) {
+std::pair<Coord, Coord> Manager::HandleBlackCastle(const Board& board, const std::string& message) {
     auto king = std::dynamic_pointer_cast<KingCell>(board[7][4]);
     if (king && king->canCastle(true, board)) {
         return {{7, 4}, {7, 6}};
@@ -38,7 +38,7 @@ std::pair<Coord, Coord> Manager::HandleBlackCastle(const std::vector<std::vector
     return {};
 }
 
-std::pair<Coord, Coord> Manager::WordToCoord(const std::vector<std::vector<std::shared_ptr<Cell>>>& board, const std::string& message) {
+std::pair<Coord, Coord> Manager::WordToCoord(const Board& board, const std::string& message) {
     if (message == "O-O" || message == "O-O-O") {
         return HandleWhiteCastle(board, message);
     }
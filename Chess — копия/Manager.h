@@ -31,7 +31,7 @@ public:
      * \return A pair of coordinates representing the move (from, to). If invalid, returns an empty pair.
      */
     
-    std::pair<Coord, Coord> WordToCoord(const std::vector<std::vector<std::shared_ptr<Cell>>>& board, const std::string& message);
+    std::pair<Coord, Coord> WordToCoord(const Board& board, const std::string& message);
 
     /*!
      * \brief Converts a chess square notation (e.g., "e4") to board coordinates.
@@ -56,7 +56,7 @@ public:
      * \return A pair of coordinates representing the castling move (from, to). If invalid, returns an empty pair.
      */
     
-    std::pair<Coord, Coord> HandleWhiteCastle(const std::vector<std::vector<std::shared_ptr<Cell>>>& board, const std::string& message);
+    std::pair<Coord, Coord> HandleWhiteCastle(const Board& board, const std::string& message);
 
     /*!
      * \brief Handles black player's castling move (o-o or o-o-o).
@@ -65,5 +65,5 @@ public:
      * \return A pair of coordinates representing the castling move (from, to). If invalid, returns an empty pair.
      */
     
-    std::pair<Coord, Coord> HandleBlackCastle(const std::vector<std::vector<std::shared_ptr<Cell>>>& board, const std::string& message);
+    std::pair<Coord, Coord> HandleBlackCastle(const Board& board, const std::string& message);
 };
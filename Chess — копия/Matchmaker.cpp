@@ -0,0 +1,157 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Matchmaker.h"
+
+#include <algorithm>
+#include <random>
+
+#include "Logger.h"
+
+Matchmaker::Matchmaker(CreateMatch create_match, std::chrono::milliseconds interval)
+    : create_match_(std::move(create_match)), interval_(interval), thread_([this]() { Loop(); }) {}
+
+Matchmaker::~Matchmaker() {
+    incoming_.Close();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::shared_ptr<TicketClaim> Matchmaker::Submit(int player_id, const std::string& username, int rating,
+                                                const std::string& time_control,
+                                                std::function<void(const Pairing&)> on_paired) {
+    auto claim = std::make_shared<TicketClaim>();
+    incoming_.PushBack(MatchTicket{player_id, username, rating, time_control, std::chrono::steady_clock::now(),
+                                   std::move(on_paired), claim});
+    return claim;
+}
+
+bool Matchmaker::Withdraw(const std::shared_ptr<TicketClaim>& claim) {
+    std::lock_guard<std::mutex> lock(claim_mutex_);
+    if (claim->paired) {
+        return false;
+    }
+    claim->withdrawn = true;
+    return true;
+}
+
+void Matchmaker::Loop() {
+    std::vector<MatchTicket> batch;
+
+    while (true) {
+        // с пустым пулом спим до первого игрока, затем даём набраться всей волне запросов
+        if (waiting_.empty() && incoming_.DrainInto(batch, kBatchSize) == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(interval_);
+        incoming_.TryDrainInto(batch, kBatchSize);
+
+        for (auto& ticket : batch) {
+            waiting_[ticket.time_control].push_back(std::move(ticket));
+        }
+        batch.clear();
+
+        DropWithdrawn();
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = waiting_.begin(); it != waiting_.end();) {
+            PairBucket(it->second, now);
+            it = it->second.empty() ? waiting_.erase(it) : std::next(it);
+        }
+        std::size_t waiting = 0;
+        for (const auto& [time_control, bucket] : waiting_) {
+            waiting += bucket.size();
+        }
+        waiting_count_.store(waiting, std::memory_order_relaxed);
+
+        if (incoming_.IsClosed()) {
+            break;
+        }
+    }
+}
+
+void Matchmaker::DropWithdrawn() {
+    std::lock_guard<std::mutex> lock(claim_mutex_);
+    for (auto& [time_control, bucket] : waiting_) {
+        std::erase_if(bucket, [](const MatchTicket& ticket) { return ticket.claim->withdrawn; });
+    }
+}
+
+void Matchmaker::PairBucket(std::vector<MatchTicket>& bucket, std::chrono::steady_clock::time_point now) {
+    std::sort(bucket.begin(), bucket.end(),
+              [](const MatchTicket& a, const MatchTicket& b) { return a.rating < b.rating; });
+
+    auto window = [&](const MatchTicket& ticket) {
+        auto waited = std::chrono::duration_cast<std::chrono::seconds>(now - ticket.enqueued).count();
+        return kBaseRatingWindow + kWindowGrowthPerSecond * static_cast<int>(waited);
+    };
+
+    std::vector<MatchTicket> unpaired;
+    std::size_t i = 0;
+    while (i < bucket.size()) {
+        if (i + 1 < bucket.size()) {
+            int difference = bucket[i + 1].rating - bucket[i].rating;
+            if (difference <= std::max(window(bucket[i]), window(bucket[i + 1]))) {
+                switch (Match(bucket[i], bucket[i + 1])) {
+                    case MatchResult::Paired:
+                    case MatchResult::Failed:
+                        i += 2;
+                        break;
+                    case MatchResult::FirstWithdrawn:
+                        ++i;
+                        break;
+                    case MatchResult::SecondWithdrawn:
+                        // ушедший билет выбрасываем, оставшийся пробуем со следующим соседом
+                        bucket[i + 1] = std::move(bucket[i]);
+                        ++i;
+                        break;
+                }
+                continue;
+            }
+        }
+        unpaired.push_back(std::move(bucket[i]));
+        ++i;
+    }
+    bucket = std::move(unpaired);
+}
+
+Matchmaker::MatchResult Matchmaker::Match(MatchTicket& first, MatchTicket& second) {
+    thread_local std::mt19937 engine(std::random_device{}());
+    bool first_is_white = std::bernoulli_distribution(0.5)(engine);
+
+    MatchTicket& white = first_is_white ? first : second;
+    MatchTicket& black = first_is_white ? second : first;
+
+    int game_id = 0;
+    {
+        // игра создаётся под блокировкой: Withdraw() либо успевает раньше, либо видит готовую пару
+        std::lock_guard<std::mutex> lock(claim_mutex_);
+        if (first.claim->withdrawn) {
+            return MatchResult::FirstWithdrawn;
+        }
+        if (second.claim->withdrawn) {
+            return MatchResult::SecondWithdrawn;
+        }
+        try {
+            game_id = create_match_(white, black);
+        } catch (const std::exception& e) {
+            // оба игрока выбывают, их ожидание закончится таймаутом и повторной авторизацией
+            first.claim->withdrawn = true;
+            second.claim->withdrawn = true;
+            CHESS_LOG_ERROR("match creation failed", {"white_player_id", white.player_id},
+                            {"black_player_id", black.player_id}, {"error", e.what()});
+            return MatchResult::Failed;
+        }
+        first.claim->paired = true;
+        second.claim->paired = true;
+    }
+
+    if (white.on_paired) {
+        white.on_paired({game_id, "White"});
+    }
+    if (black.on_paired) {
+        black.on_paired({game_id, "Black"});
+    }
+    return MatchResult::Paired;
+}
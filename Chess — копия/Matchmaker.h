@@ -0,0 +1,140 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "My_MPSC_Queue.h"
+
+/*! \brief
+ *   Outcome of matchmaking for one player.
+ */
+struct Pairing {
+    int game_id = 0;     ///< Game created for the pair.
+    std::string colour;  ///< "White" or "Black".
+};
+
+/*! \brief
+ *   Outcome of a ticket as far as its player and the matchmaker agree on it.
+ *   Guarded by the matchmaker's claim mutex.
+ */
+struct TicketClaim {
+    bool paired = false;      ///< A game was created for the ticket.
+    bool withdrawn = false;   ///< The player gave up; the ticket must not be paired.
+};
+
+/*! \brief
+ *   A player waiting for an opponent.
+ */
+struct MatchTicket {
+    int player_id = 0;              ///< Unique identifier of the player.
+    std::string username;           ///< Username of the player.
+    int rating = 1500;              ///< Rating used to find a close opponent.
+    std::string time_control;       ///< Only players with the same time control are paired.
+    std::chrono::steady_clock::time_point enqueued;   ///< When the ticket was submitted.
+    std::function<void(const Pairing&)> on_paired;     ///< Called on the matchmaker thread when the player is paired.
+    std::shared_ptr<TicketClaim> claim;                ///< Shared with the submitter, for Withdraw().
+};
+
+/*!
+ * \class Matchmaker
+ * \brief Pairs waiting players in periodic batches.
+ * \details Submitting a ticket is a single lock-free push, so a burst of `/auth` calls never waits
+ * on a lock. A background thread collects tickets every interval, buckets them by time control,
+ * sorts each bucket by rating and pairs neighbours whose rating difference fits the allowed window.
+ * The window widens the longer a player waits, so nobody waits forever for a perfect opponent.
+ * The game is created by a callback only once a pair has been formed.
+ *
+ * A player who stops waiting withdraws the ticket. Withdrawal and pairing exclude each other under a
+ * short claim lock, so a withdrawn ticket is never paired and a failed withdrawal means the game has
+ * already been created.
+ */
+class Matchmaker {
+public:
+    /*!
+     * \brief Creates a game for a formed pair and returns its ID.
+     * \details Called on the matchmaker thread with the players already assigned their colours.
+     */
+    using CreateMatch = std::function<int(const MatchTicket& white, const MatchTicket& black)>;
+
+    /*!
+     * \brief Starts the matchmaker thread.
+     * \param create_match Callback creating the game for a pair.
+     * \param interval Time between pairing batches.
+     */
+    explicit Matchmaker(CreateMatch create_match,
+                        std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+    /*!
+     * \brief Stops the matchmaker thread; unpaired tickets are abandoned.
+     */
+    ~Matchmaker();
+
+    Matchmaker(const Matchmaker&) = delete;
+    Matchmaker& operator=(const Matchmaker&) = delete;
+
+    /*!
+     * \brief Puts a player into the waiting pool. Safe to call from any thread.
+     * \param player_id Player ID.
+     * \param username Username of the player.
+     * \param rating Player rating.
+     * \param time_control Requested time control.
+     * \param on_paired Called on the matchmaker thread with the pairing; must not block. It is not called
+     *        if the game could not be created.
+     * \return Claim of the ticket, to be passed to Withdraw().
+     */
+    std::shared_ptr<TicketClaim> Submit(int player_id, const std::string& username, int rating,
+                                        const std::string& time_control,
+                                        std::function<void(const Pairing&)> on_paired);
+
+    /*!
+     * \brief Takes a ticket out of matchmaking. Safe to call from any thread.
+     * \details Waits only while the ticket's pair is being created, which takes no I/O.
+     * \param claim Claim returned by Submit().
+     * \return true if the ticket will never be paired; false if a game was already created for it,
+     *         in which case the player's pairing has been recorded by the match callback.
+     */
+    bool Withdraw(const std::shared_ptr<TicketClaim>& claim);
+
+    /*!
+     * \brief Returns the number of submitted tickets not yet taken into a batch. Safe to call from any thread.
+     */
+    std::size_t QueueDepth() const { return incoming_.Size(); }
+
+    /*!
+     * \brief Returns the number of players left unpaired by the last batch. Safe to call from any thread.
+     */
+    std::size_t Waiting() const { return waiting_count_.load(std::memory_order_relaxed); }
+
+private:
+    void Loop();
+    /*! \brief Result of trying to pair two tickets. */
+    enum class MatchResult { Paired, Failed, FirstWithdrawn, SecondWithdrawn };
+
+    void DropWithdrawn();
+    void PairBucket(std::vector<MatchTicket>& bucket, std::chrono::steady_clock::time_point now);
+    MatchResult Match(MatchTicket& first, MatchTicket& second);
+
+    static constexpr int kBaseRatingWindow = 100;  ///< Allowed rating difference for a fresh ticket.
+    static constexpr int kWindowGrowthPerSecond = 50;  ///< Extra difference allowed per second of waiting.
+    static constexpr std::size_t kBatchSize = 4096;  ///< Tickets taken from the queue per batch.
+
+    CreateMatch create_match_;                                   ///< Game creation callback.
+    std::chrono::milliseconds interval_;                         ///< Time between batches.
+    MPSCQueue<MatchTicket> incoming_;                            ///< Newly submitted tickets.
+    std::mutex claim_mutex_;                                     ///< Guards every TicketClaim.
+    std::map<std::string, std::vector<MatchTicket>> waiting_;    ///< Unpaired tickets by time control; matchmaker thread only.
+    std::atomic<std::size_t> waiting_count_{0};                  ///< Tickets in waiting_, for other threads.
+    std::thread thread_;                                         ///< Matchmaker thread.
+};
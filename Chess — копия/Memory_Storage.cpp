@@ -0,0 +1,143 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Memory_Storage.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Logger.h"
+#include "Tracing.h"
+
+std::size_t MemoryStorage::StripeOf(int id) {
+    return static_cast<std::size_t>(static_cast<unsigned>(id)) % kStripes;
+}
+
+int MemoryStorage::InsertIDToDataBase(int user_id, const std::string& username, int game_id,
+                                      const std::string& user_colour) {
+    Stripe& stripe = stripes_[StripeOf(user_id)];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    ScopedLatency round_trip(round_trips_);
+    bool inserted = stripe.players.try_emplace(user_id, Player{username, game_id, StoredColour(user_id, user_colour)})
+                        .second;
+    if (!inserted) {
+        CHESS_LOG_ERROR("player insertion failed", {"player_id", user_id}, {"game_id", game_id},
+                        {"error", "duplicate player ID"});
+        return 1;
+    }
+    return 0;
+}
+
+int MemoryStorage::DeleteIDFromDataBase(const std::string& username) {
+    for (Stripe& stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        std::erase_if(stripe.players, [&](const auto& entry) { return entry.second.username == username; });
+    }
+    CHESS_LOG_INFO("player deleted", {"username", username});
+    return 0;
+}
+
+int MemoryStorage::GetGameIDByPlayerID(int user_id) {
+    Stripe& stripe = stripes_[StripeOf(user_id)];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    auto it = stripe.players.find(user_id);
+    if (it == stripe.players.end()) {
+        CHESS_LOG_WARN("player not found", {"player_id", user_id});
+        return -1;
+    }
+    return it->second.game_id;
+}
+
+void MemoryStorage::CreateNewGame(int game_id, const std::string& initial_board) {
+    Stripe& stripe = stripes_[StripeOf(game_id)];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    ScopedLatency round_trip(round_trips_);
+    if (!stripe.games.try_emplace(game_id, std::vector<std::string>{initial_board}).second) {
+        CHESS_LOG_ERROR("game row creation failed", {"game_id", game_id}, {"error", "duplicate game ID"});
+        throw std::runtime_error("Game " + std::to_string(game_id) + " already exists");
+    }
+}
+
+void MemoryStorage::UpdateGameHistory(int game_id, const std::string& new_board_state) {
+    UpdateGameHistories({{game_id, new_board_state}});
+}
+
+void MemoryStorage::UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) {
+    // обновления группируются по полосам: каждая блокируется один раз на пачку
+    std::vector<std::size_t> order(updates.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return StripeOf(updates[a].first) < StripeOf(updates[b].first);
+    });
+
+    for (std::size_t begin = 0; begin < order.size();) {
+        Stripe& stripe = stripes_[StripeOf(updates[order[begin]].first)];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        ScopedLatency round_trip(round_trips_);
+        std::size_t end = begin;
+        for (; end < order.size() && &stripes_[StripeOf(updates[order[end]].first)] == &stripe; ++end) {
+            const auto& [game_id, board_state] = updates[order[end]];
+            // как UPDATE в PostgreSQL: неизвестная партия пропускается
+            if (auto it = stripe.games.find(game_id); it != stripe.games.end()) {
+                it->second.assign(1, board_state);
+            }
+        }
+        begin = end;
+    }
+}
+
+std::string MemoryStorage::GetBoardHistory(int game_id) {
+    Stripe& stripe = stripes_[StripeOf(game_id)];
+    TraceSpan lock_wait("db connection wait", "db");
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    lock_wait.End();
+    TraceSpan query("GetBoardHistory", "db");
+    ScopedLatency round_trip(round_trips_);
+    auto it = stripe.games.find(game_id);
+    if (it == stripe.games.end()) {
+        return {};
+    }
+    return BoardHistoryText(it->second);
+}
+
+int MemoryStorage::DeleteGame(int game_id) {
+    for (Stripe& stripe : stripes_) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        std::erase_if(stripe.players, [&](const auto& entry) { return entry.second.game_id == game_id; });
+        stripe.games.erase(game_id);
+        stripe.snapshots.erase(game_id);
+    }
+    CHESS_LOG_INFO("game deleted", {"game_id", game_id});
+    return 0;
+}
+
+void MemoryStorage::SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) {
+    for (const auto& [game_id, snapshot] : snapshots) {
+        Stripe& stripe = stripes_[StripeOf(game_id)];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        ScopedLatency round_trip(round_trips_);
+        stripe.snapshots[game_id] = snapshot;
+    }
+}
+
+std::optional<GameSnapshot> MemoryStorage::LoadSnapshot(int game_id) {
+    Stripe& stripe = stripes_[StripeOf(game_id)];
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    ScopedLatency round_trip(round_trips_);
+    auto it = stripe.snapshots.find(game_id);
+    if (it == stripe.snapshots.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void MemoryStorage::DeleteSnapshots(const std::vector<int>& game_ids) {
+    for (int game_id : game_ids) {
+        Stripe& stripe = stripes_[StripeOf(game_id)];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.snapshots.erase(game_id);
+    }
+}
@@ -0,0 +1,63 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Storage.h"
+
+/*!
+ * \class MemoryStorage
+ * \brief Storage kept in the memory of the server process; nothing survives a restart.
+ * \details Players and games are spread over stripes by their ID, each stripe with its own mutex and
+ * maps, so operations on different games rarely contend. A batch of board updates locks each stripe
+ * it touches once; unlike a database transaction it is not atomic as a whole, which no caller needs
+ * since the updates are independent. Lookups by username and deleting the players of a game visit
+ * every stripe; the server never does either on a hot path.
+ *
+ * Meant for development, load tests and benchmarks, where it takes the database out of the picture.
+ */
+class MemoryStorage : public Storage {
+public:
+    int InsertIDToDataBase(int user_id, const std::string& username, int game_id,
+                           const std::string& user_colour = "") override;
+    int DeleteIDFromDataBase(const std::string& username) override;
+    int GetGameIDByPlayerID(int user_id) override;
+    void CreateNewGame(int game_id, const std::string& initial_board) override;
+    void UpdateGameHistory(int game_id, const std::string& new_board_state) override;
+    void UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) override;
+    std::string GetBoardHistory(int game_id) override;
+    int DeleteGame(int game_id) override;
+    void SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) override;
+    std::optional<GameSnapshot> LoadSnapshot(int game_id) override;
+    void DeleteSnapshots(const std::vector<int>& game_ids) override;
+
+private:
+    struct Player {
+        std::string username;   ///< Username.
+        int game_id = 0;        ///< Game of the player.
+        std::string colour;     ///< "white" or "black".
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;                                                ///< Guards the maps of the stripe.
+        std::unordered_map<int, Player> players;                         ///< Players by ID.
+        std::unordered_map<int, std::vector<std::string>> games;        ///< Board history by game ID.
+        std::unordered_map<int, GameSnapshot> snapshots;                 ///< Snapshots of hibernated games.
+    };
+
+    static constexpr std::size_t kStripes = 64;   ///< Number of stripes.
+
+    static std::size_t StripeOf(int id);
+
+    std::array<Stripe, kStripes> stripes_;   ///< Players and games, striped by ID.
+};
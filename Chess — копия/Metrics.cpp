@@ -0,0 +1,213 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+constexpr std::size_t kFirstBoundExponent = 4;   ///< Smallest exposed bucket bound: below 16 µs.
+constexpr std::size_t kLastBoundExponent = 25;   ///< Largest exposed bucket bound: below ~33.5 s.
+constexpr double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+std::atomic<std::size_t> next_shard{0};  ///< Shard of the next thread that asks for one.
+
+std::string FormatValue(double value) {
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    char buffer[32];
+    // счётчики печатаются целыми: кратчайшая запись дала бы 8e+05
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<long long>(value));
+        return std::string(buffer, end);
+    }
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, end);
+}
+
+std::string EscapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char symbol : value) {
+        switch (symbol) {
+            case '\\': escaped += "\\\\"; break;
+            case '"': escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += symbol;
+        }
+    }
+    return escaped;
+}
+
+/*!
+ * \brief Name of the quantile gauges of a histogram: `x_seconds` becomes `x_quantile_seconds`.
+ */
+std::string QuantileName(const std::string& name) {
+    constexpr std::string_view kUnit = "_seconds";
+    if (name.size() > kUnit.size() && name.compare(name.size() - kUnit.size(), kUnit.size(), kUnit) == 0) {
+        return name.substr(0, name.size() - kUnit.size()) + "_quantile" + std::string(kUnit);
+    }
+    return name + "_quantile";
+}
+
+}
+
+std::size_t MetricShard() {
+    thread_local std::size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+std::uint64_t ShardedCounter::Value() const {
+    std::uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::uint64_t HistogramSnapshot::Quantile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < counts.size(); ++bucket) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            return LatencyHistogram::UpperBound(bucket);
+        }
+    }
+    return LatencyHistogram::UpperBound(counts.size() - 1);
+}
+
+std::uint64_t HistogramSnapshot::CountBelow(std::uint64_t bound_us) const {
+    std::uint64_t total = 0;
+    for (std::size_t bucket = 0; bucket < counts.size() && LatencyHistogram::UpperBound(bucket) <= bound_us; ++bucket) {
+        total += counts[bucket];
+    }
+    return total;
+}
+
+void LatencyHistogram::Record(std::uint64_t micros) {
+    Shard& shard = shards_[MetricShard()];
+    shard.counts[BucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum_us.fetch_add(micros, std::memory_order_relaxed);
+}
+
+HistogramSnapshot LatencyHistogram::Snapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.counts.assign(kBuckets, 0);
+    for (const auto& shard : shards_) {
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            snapshot.counts[bucket] += shard.counts[bucket].load(std::memory_order_relaxed);
+        }
+        snapshot.sum_us += shard.sum_us.load(std::memory_order_relaxed);
+    }
+    for (std::uint64_t value : snapshot.counts) {
+        snapshot.count += value;
+    }
+    return snapshot;
+}
+
+std::size_t LatencyHistogram::BucketOf(std::uint64_t micros) {
+    if (micros < kSubBuckets) {
+        return static_cast<std::size_t>(micros);
+    }
+    // старший бит задаёт степень двойки, следующие kSubBucketBits бит — часть внутри неё
+    std::size_t exponent = static_cast<std::size_t>(std::bit_width(micros)) - 1;
+    if (exponent > kMaxExponent) {
+        return kBuckets - 1;
+    }
+    std::size_t sub = static_cast<std::size_t>(micros >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::UpperBound(std::size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket + 1;
+    }
+    std::size_t exponent = (bucket - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    std::size_t sub = (bucket - kSubBuckets) % kSubBuckets;
+    return static_cast<std::uint64_t>(kSubBuckets + sub + 1) << (exponent - kSubBucketBits);
+}
+
+void MetricsWriter::Counter(const std::string& name, const std::string& help, const Labels& labels, double value) {
+    AppendSample(FamilyOf(name, help, "counter").samples, name, labels, value);
+}
+
+void MetricsWriter::Gauge(const std::string& name, const std::string& help, const Labels& labels, double value) {
+    AppendSample(FamilyOf(name, help, "gauge").samples, name, labels, value);
+}
+
+void MetricsWriter::Histogram(const std::string& name, const std::string& help, const Labels& labels,
+                              const HistogramSnapshot& snapshot) {
+    std::string& samples = FamilyOf(name, help, "histogram").samples;
+    for (std::size_t exponent = kFirstBoundExponent; exponent <= kLastBoundExponent; ++exponent) {
+        std::uint64_t bound = std::uint64_t{1} << exponent;
+        // le в Prometheus включительный, а граница корзины — нет; отсчёты целые, так что это bound - 1 мкс
+        std::pair<std::string, std::string> le{"le", FormatValue(static_cast<double>(bound - 1) / 1e6)};
+        AppendSample(samples, name + "_bucket", labels, static_cast<double>(snapshot.CountBelow(bound)), &le);
+    }
+    std::pair<std::string, std::string> inf{"le", "+Inf"};
+    AppendSample(samples, name + "_bucket", labels, static_cast<double>(snapshot.count), &inf);
+    AppendSample(samples, name + "_sum", labels, static_cast<double>(snapshot.sum_us) / 1e6);
+    AppendSample(samples, name + "_count", labels, static_cast<double>(snapshot.count));
+
+    std::string quantile_name = QuantileName(name);
+    std::string& quantiles = FamilyOf(quantile_name, "Quantiles of " + name + ".", "gauge").samples;
+    for (double q : kQuantiles) {
+        std::pair<std::string, std::string> label{"quantile", FormatValue(q)};
+        AppendSample(quantiles, quantile_name, labels, static_cast<double>(snapshot.Quantile(q)) / 1e6, &label);
+    }
+}
+
+std::string MetricsWriter::Render() const {
+    std::string out;
+    for (const auto& family : families_) {
+        out += "# HELP " + family.name + " " + family.help + "\n";
+        out += "# TYPE " + family.name + " " + family.type + "\n";
+        out += family.samples;
+    }
+    return out;
+}
+
+MetricsWriter::Family& MetricsWriter::FamilyOf(const std::string& name, const std::string& help, const char* type) {
+    // семейств несколько десятков, линейный поиск дешевле карты
+    auto it = std::find_if(families_.begin(), families_.end(), [&](const Family& family) { return family.name == name; });
+    if (it != families_.end()) {
+        return *it;
+    }
+    families_.push_back({name, help, type, {}});
+    return families_.back();
+}
+
+void MetricsWriter::AppendSample(std::string& out, const std::string& name, const Labels& labels, double value,
+                                 const std::pair<std::string, std::string>* extra) {
+    out += name;
+    if (!labels.empty() || extra != nullptr) {
+        out += '{';
+        bool first = true;
+        auto append = [&](const std::pair<std::string, std::string>& label) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += label.first + "=\"" + EscapeLabel(label.second) + "\"";
+        };
+        for (const auto& label : labels) {
+            append(label);
+        }
+        if (extra != nullptr) {
+            append(*extra);
+        }
+        out += '}';
+    }
+    out += ' ' + FormatValue(value) + '\n';
+}
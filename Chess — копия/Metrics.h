@@ -0,0 +1,170 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+constexpr std::size_t kMetricShards = 16;  ///< Shards of every counter and histogram.
+
+/*!
+ * \brief Returns the shard of the calling thread.
+ * \details Threads get consecutive shards on their first call, so up to kMetricShards threads
+ * never write to the same cache line.
+ */
+std::size_t MetricShard();
+
+/*!
+ * \class ShardedCounter
+ * \brief Monotonic counter split into cache-line-sized per-thread shards.
+ * \details An increment is an uncontended relaxed add on the shard of the calling thread; the
+ * shards are only summed when the value is read, i.e. on a scrape.
+ */
+class ShardedCounter {
+public:
+    /*! \brief Adds \p value to the counter. */
+    void Add(std::uint64_t value = 1) {
+        shards_[MetricShard()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /*! \brief Returns the sum of all shards. */
+    std::uint64_t Value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::array<Shard, kMetricShards> shards_;  ///< Per-thread parts of the counter.
+};
+
+/*!
+ * \brief Merged contents of a LatencyHistogram.
+ */
+struct HistogramSnapshot {
+    std::vector<std::uint64_t> counts;   ///< Samples per bucket.
+    std::uint64_t count = 0;             ///< Number of samples.
+    std::uint64_t sum_us = 0;            ///< Sum of the samples in microseconds.
+
+    /*!
+     * \brief Estimates a quantile from the bucket counts.
+     * \param q Quantile in [0, 1].
+     * \return Upper bound of the bucket holding the quantile, in microseconds; 0 without samples.
+     */
+    std::uint64_t Quantile(double q) const;
+
+    /*!
+     * \brief Returns the number of samples below \p bound_us microseconds.
+     * \details Exact when \p bound_us is a power of two, which is always a bucket boundary.
+     */
+    std::uint64_t CountBelow(std::uint64_t bound_us) const;
+};
+
+/*!
+ * \class LatencyHistogram
+ * \brief HDR-style latency histogram with per-thread shards.
+ * \details Samples are kept in microseconds in log-linear buckets: every power of two is split into
+ * kSubBuckets equal parts, which bounds the relative error by 1/kSubBuckets from a microsecond up to
+ * hours with a few hundred buckets. Recording is two relaxed adds on the shard of the calling thread.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kSubBucketBits = 3;                                ///< log2 of kSubBuckets.
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;    ///< Buckets per power of two.
+    static constexpr std::size_t kMaxExponent = 35;                                  ///< Longer samples (~9.5 h) share the last bucket.
+    static constexpr std::size_t kBuckets = kSubBuckets * (kMaxExponent - kSubBucketBits + 2);  ///< Number of buckets.
+
+    /*! \brief Records a sample in microseconds. */
+    void Record(std::uint64_t micros);
+
+    /*! \brief Records a duration; negative durations count as zero. */
+    void Record(std::chrono::steady_clock::duration duration) {
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        Record(static_cast<std::uint64_t>(micros > 0 ? micros : 0));
+    }
+
+    /*! \brief Merges the shards. */
+    HistogramSnapshot Snapshot() const;
+
+    /*! \brief Returns the bucket of a sample. */
+    static std::size_t BucketOf(std::uint64_t micros);
+
+    /*! \brief Returns the exclusive upper bound of a bucket in microseconds. */
+    static std::uint64_t UpperBound(std::size_t bucket);
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, kBuckets> counts{};  ///< Samples per bucket.
+        std::atomic<std::uint64_t> sum_us{0};                       ///< Sum of the samples.
+    };
+
+    std::array<Shard, kMetricShards> shards_;  ///< Per-thread parts of the histogram.
+};
+
+/*!
+ * \class ScopedLatency
+ * \brief Records the lifetime of the object into a histogram, also when leaving by an exception.
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() { histogram_.Record(std::chrono::steady_clock::now() - start_); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram_;                    ///< Target histogram.
+    std::chrono::steady_clock::time_point start_;    ///< Construction time.
+};
+
+/*!
+ * \class MetricsWriter
+ * \brief Builds a scrape in the Prometheus text exposition format.
+ * \details Samples of one metric may be added in any order; Render() groups them under a single
+ * HELP/TYPE header per metric, in the order the metrics were first seen.
+ */
+class MetricsWriter {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    /*! \brief Adds a sample of a counter. */
+    void Counter(const std::string& name, const std::string& help, const Labels& labels, double value);
+
+    /*! \brief Adds a sample of a gauge. */
+    void Gauge(const std::string& name, const std::string& help, const Labels& labels, double value);
+
+    /*!
+     * \brief Adds a latency histogram in seconds, with buckets at powers of two microseconds.
+     * \details Also adds gauges with the median and the 0.9, 0.99 and 0.999 quantiles, named like the
+     * histogram with `_quantile` before the unit suffix.
+     */
+    void Histogram(const std::string& name, const std::string& help, const Labels& labels,
+                   const HistogramSnapshot& snapshot);
+
+    /*! \brief Returns the scrape. */
+    std::string Render() const;
+
+private:
+    struct Family {
+        std::string name;      ///< Metric name.
+        std::string help;      ///< HELP text.
+        std::string type;      ///< counter, gauge or histogram.
+        std::string samples;   ///< Sample lines.
+    };
+
+    Family& FamilyOf(const std::string& name, const std::string& help, const char* type);
+    static void AppendSample(std::string& out, const std::string& name, const Labels& labels, double value,
+                             const std::pair<std::string, std::string>* extra = nullptr);
+
+    std::vector<Family> families_;  ///< Metrics in order of appearance.
+};
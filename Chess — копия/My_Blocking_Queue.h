@@ -4,7 +4,7 @@
 #pragma once
 
 #include <condition_variable>
-#include <iostream>
+#include <mutex>
 #include <optional>
 #include <queue>
 
@@ -42,8 +42,9 @@ public:
     /*! \brief Adds an item to the back of the queue.
      *
      *   \param object Item to add.
+     *   \return false if the queue is closed and the item was dropped.
      */
-    void PushBack(T object);
+    bool PushBack(T object);
 
 private:
     std::queue<T> queue_;                 ///< Underlying container for storing items.
@@ -55,14 +56,16 @@ private:
 
 /*! \brief Adds an item to the queue if it is open. */
 template <typename T>
-void BlockingQueue<T>::PushBack(T object) {
+bool BlockingQueue<T>::PushBack(T object) {
     std::lock_guard lock(mutex_);
-    if (isOpen_) {
-        queue_.push(std::move(object));
-        if (0 < count_) {
-            cv_.notify_one();
-        }
+    if (!isOpen_) {
+        return false;
     }
+    queue_.push(std::move(object));
+    if (0 < count_) {
+        cv_.notify_one();
+    }
+    return true;
 }
 
 /*! \brief Closes the queue and notifies waiting threads. */
@@ -101,19 +104,17 @@ std::optional<T> BlockingQueue<T>::Get() {
     std::unique_lock lock(mutex_);
 
     if (!queue_.empty()) {
-        T object = queue_.front();
+        T object = std::move(queue_.front());
         queue_.pop();
-        cv_.notify_one();
         return object;
     }
 
-    std::cerr << "Queue is empty" << std::endl;
     ++count_;
     cv_.wait(lock, [&](){ return !queue_.empty() || !isOpen_; });
     --count_;
 
     if (!queue_.empty()) {
-        T object = queue_.front();
+        T object = std::move(queue_.front());
         queue_.pop();
         return object;
     }
@@ -0,0 +1,321 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/*! \brief
+ *   Counters collected by BoundedBlockingQueue.
+ */
+struct QueueStats {
+    std::size_t depth = 0;               ///< Number of items currently in the queue.
+    std::size_t max_depth = 0;           ///< Largest depth observed so far.
+    std::uint64_t pushed = 0;            ///< Items accepted by the queue.
+    std::uint64_t popped = 0;            ///< Items handed to consumers.
+    std::uint64_t rejected = 0;          ///< Items refused because the queue was full or closed.
+    std::uint64_t high_water_hits = 0;   ///< Times the depth crossed the high-water mark.
+    std::chrono::nanoseconds push_wait{0};  ///< Total time producers spent waiting for space.
+    std::chrono::nanoseconds pop_wait{0};   ///< Total time consumers spent waiting for items.
+};
+
+/*! \brief
+ *   Thread-safe blocking queue with a fixed capacity.
+ *
+ *   Behaves like BlockingQueue, but producers cannot grow it without limit:
+ *   PushBack() waits for free space, TryPush() fails immediately and PushFor()
+ *   waits at most the given time. A callback can be registered that fires each
+ *   time the depth climbs to the high-water mark, so producers can start shedding
+ *   load before the queue is full.
+ *
+ *   A consumer can take everything that piled up with one DrainInto() call, like
+ *   with MPSCQueue. After Close() new items are rejected and consumers get the
+ *   remaining ones; ShutDown() closes the queue as well and discards them.
+ *
+ *   \tparam T Type of elements stored in the queue.
+ */
+template <typename T>
+class BoundedBlockingQueue {
+public:
+    using HighWaterCallback = std::function<void(std::size_t depth)>;
+
+    /*! \brief Constructs an empty queue.
+     *
+     *   \param capacity Maximum number of items the queue can hold (at least 1).
+     */
+    explicit BoundedBlockingQueue(std::size_t capacity);
+
+    /*! \brief Sets the high-water mark and the callback fired when it is reached.
+     *
+     *   The callback runs on the producer thread, outside the queue lock.
+     *
+     *   \param mark Depth that triggers the callback.
+     *   \param callback Function receiving the current depth.
+     */
+    void SetHighWaterMark(std::size_t mark, HighWaterCallback callback);
+
+    /*! \brief Adds an item, waiting while the queue is full.
+     *
+     *   \return false if the queue is closed and the item was dropped.
+     */
+    bool PushBack(T object);
+
+    /*! \brief Adds an item only if there is free space right now.
+     *
+     *   \return false if the queue is full or closed.
+     */
+    bool TryPush(T object);
+
+    /*! \brief Adds an item, waiting at most \p timeout for free space.
+     *
+     *   \return false if the timeout expired or the queue is closed.
+     */
+    template <typename Rep, typename Period>
+    bool PushFor(T object, std::chrono::duration<Rep, Period> timeout);
+
+    /*! \brief Retrieves an item, waiting while the queue is empty.
+     *
+     *   \return std::optional containing the item, or std::nullopt if closed and empty.
+     */
+    std::optional<T> Get();
+
+    /*! \brief Retrieves an item, waiting at most \p timeout.
+     *
+     *   \return std::optional containing the item, or std::nullopt on timeout or if closed and empty.
+     */
+    template <typename Rep, typename Period>
+    std::optional<T> GetFor(std::chrono::duration<Rep, Period> timeout);
+
+    /*! \brief Moves up to \p max items into \p batch, waiting until at least one is available.
+     *
+     *   \param batch Vector the items are appended to.
+     *   \param max Maximum number of items to take.
+     *   \return Number of items appended; 0 means the queue is closed and empty.
+     */
+    std::size_t DrainInto(std::vector<T>& batch, std::size_t max);
+
+    /*! \brief Closes the queue. No more items can be added; waiting threads are woken. */
+    void Close();
+
+    /*! \brief Closes the queue, discards pending items and wakes every waiting producer and consumer. */
+    void ShutDown();
+
+    /*! \brief Returns the capacity given at construction. */
+    std::size_t Capacity() const { return capacity_; }
+
+    /*! \brief Returns the number of queued items. */
+    std::size_t Size() const;
+
+    /*! \brief Returns a snapshot of the queue counters. */
+    QueueStats GetStats() const;
+
+private:
+    bool PushLocked(std::unique_lock<std::mutex>& lock, T&& object);
+    T PopLocked();
+
+    const std::size_t capacity_;              ///< Maximum number of stored items.
+    std::deque<T> queue_;                     ///< Underlying container for storing items.
+    bool isOpen_ = true;                      ///< Indicates if the queue is open for adding items.
+    mutable std::mutex mutex_;                ///< Mutex to synchronize access.
+    std::condition_variable not_empty_;       ///< Signalled when an item is added.
+    std::condition_variable not_full_;        ///< Signalled when an item is removed.
+    std::size_t high_water_mark_;             ///< Depth that triggers the callback.
+    HighWaterCallback on_high_water_;         ///< Callback fired at the high-water mark.
+    QueueStats stats_;                        ///< Collected counters.
+};
+
+template <typename T>
+BoundedBlockingQueue<T>::BoundedBlockingQueue(std::size_t capacity)
+    : capacity_(capacity == 0 ? 1 : capacity)
+    , high_water_mark_(capacity_) {}
+
+template <typename T>
+void BoundedBlockingQueue<T>::SetHighWaterMark(std::size_t mark, HighWaterCallback callback) {
+    std::lock_guard lock(mutex_);
+    high_water_mark_ = mark;
+    on_high_water_ = std::move(callback);
+}
+
+/*! \brief Stores the item and fires the high-water callback after unlocking. */
+template <typename T>
+bool BoundedBlockingQueue<T>::PushLocked(std::unique_lock<std::mutex>& lock, T&& object) {
+    queue_.push_back(std::move(object));
+    ++stats_.pushed;
+    std::size_t depth = queue_.size();
+    if (stats_.max_depth < depth) {
+        stats_.max_depth = depth;
+    }
+
+    HighWaterCallback callback;
+    if (depth == high_water_mark_ && on_high_water_) {
+        ++stats_.high_water_hits;
+        callback = on_high_water_;
+    }
+
+    lock.unlock();
+    not_empty_.notify_one();
+    if (callback) {
+        callback(depth);
+    }
+    return true;
+}
+
+template <typename T>
+T BoundedBlockingQueue<T>::PopLocked() {
+    T object = std::move(queue_.front());
+    queue_.pop_front();
+    ++stats_.popped;
+    return object;
+}
+
+/*! \brief Adds an item, blocking while the queue is full. */
+template <typename T>
+bool BoundedBlockingQueue<T>::PushBack(T object) {
+    std::unique_lock lock(mutex_);
+    if (isOpen_ && queue_.size() >= capacity_) {
+        auto start = std::chrono::steady_clock::now();
+        not_full_.wait(lock, [&]() { return queue_.size() < capacity_ || !isOpen_; });
+        stats_.push_wait += std::chrono::steady_clock::now() - start;
+    }
+    if (!isOpen_) {
+        ++stats_.rejected;
+        return false;
+    }
+    return PushLocked(lock, std::move(object));
+}
+
+/*! \brief Adds an item without waiting. */
+template <typename T>
+bool BoundedBlockingQueue<T>::TryPush(T object) {
+    std::unique_lock lock(mutex_);
+    if (!isOpen_ || queue_.size() >= capacity_) {
+        ++stats_.rejected;
+        return false;
+    }
+    return PushLocked(lock, std::move(object));
+}
+
+/*! \brief Adds an item, waiting for free space up to a timeout. */
+template <typename T>
+template <typename Rep, typename Period>
+bool BoundedBlockingQueue<T>::PushFor(T object, std::chrono::duration<Rep, Period> timeout) {
+    std::unique_lock lock(mutex_);
+    if (isOpen_ && queue_.size() >= capacity_) {
+        auto start = std::chrono::steady_clock::now();
+        not_full_.wait_for(lock, timeout, [&]() { return queue_.size() < capacity_ || !isOpen_; });
+        stats_.push_wait += std::chrono::steady_clock::now() - start;
+    }
+    if (!isOpen_ || queue_.size() >= capacity_) {
+        ++stats_.rejected;
+        return false;
+    }
+    return PushLocked(lock, std::move(object));
+}
+
+/*! \brief Retrieves an item from the queue, blocking if empty. */
+template <typename T>
+std::optional<T> BoundedBlockingQueue<T>::Get() {
+    std::unique_lock lock(mutex_);
+    if (queue_.empty() && isOpen_) {
+        auto start = std::chrono::steady_clock::now();
+        not_empty_.wait(lock, [&]() { return !queue_.empty() || !isOpen_; });
+        stats_.pop_wait += std::chrono::steady_clock::now() - start;
+    }
+    if (queue_.empty()) {
+        return std::nullopt;
+    }
+
+    T object = PopLocked();
+    lock.unlock();
+    not_full_.notify_one();
+    return object;
+}
+
+/*! \brief Retrieves an item from the queue, blocking up to a timeout. */
+template <typename T>
+template <typename Rep, typename Period>
+std::optional<T> BoundedBlockingQueue<T>::GetFor(std::chrono::duration<Rep, Period> timeout) {
+    std::unique_lock lock(mutex_);
+    if (queue_.empty() && isOpen_) {
+        auto start = std::chrono::steady_clock::now();
+        not_empty_.wait_for(lock, timeout, [&]() { return !queue_.empty() || !isOpen_; });
+        stats_.pop_wait += std::chrono::steady_clock::now() - start;
+    }
+    if (queue_.empty()) {
+        return std::nullopt;
+    }
+
+    T object = PopLocked();
+    lock.unlock();
+    not_full_.notify_one();
+    return object;
+}
+
+/*! \brief Takes a batch of items, blocking if empty. */
+template <typename T>
+std::size_t BoundedBlockingQueue<T>::DrainInto(std::vector<T>& batch, std::size_t max) {
+    std::unique_lock lock(mutex_);
+    if (queue_.empty() && isOpen_) {
+        auto start = std::chrono::steady_clock::now();
+        not_empty_.wait(lock, [&]() { return !queue_.empty() || !isOpen_; });
+        stats_.pop_wait += std::chrono::steady_clock::now() - start;
+    }
+
+    std::size_t taken = 0;
+    while (taken < max && !queue_.empty()) {
+        batch.push_back(PopLocked());
+        ++taken;
+    }
+    lock.unlock();
+    // освободилось сразу несколько мест: будим всех ждущих производителей
+    if (taken != 0) {
+        not_full_.notify_all();
+    }
+    return taken;
+}
+
+/*! \brief Closes the queue and notifies all waiting threads. */
+template <typename T>
+void BoundedBlockingQueue<T>::Close() {
+    {
+        std::lock_guard lock(mutex_);
+        isOpen_ = false;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+}
+
+/*! \brief Closes and clears the queue and notifies all waiting threads. */
+template <typename T>
+void BoundedBlockingQueue<T>::ShutDown() {
+    {
+        std::lock_guard lock(mutex_);
+        isOpen_ = false;
+        queue_.clear();
+    }
+    // без закрытия и второго оповещения потребитель в Get() или GetFor() так и остался бы ждать
+    not_empty_.notify_all();
+    not_full_.notify_all();
+}
+
+template <typename T>
+std::size_t BoundedBlockingQueue<T>::Size() const {
+    std::lock_guard lock(mutex_);
+    return queue_.size();
+}
+
+template <typename T>
+QueueStats BoundedBlockingQueue<T>::GetStats() const {
+    std::lock_guard lock(mutex_);
+    QueueStats stats = stats_;
+    stats.depth = queue_.size();
+    return stats;
+}
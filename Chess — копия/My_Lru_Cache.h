@@ -0,0 +1,107 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/*! \brief
+ *   Counters collected by LruCache.
+ */
+struct CacheStats {
+    std::size_t size = 0;          ///< Number of entries currently cached.
+    std::uint64_t hits = 0;        ///< Lookups that found an entry.
+    std::uint64_t misses = 0;      ///< Lookups that found nothing.
+    std::uint64_t evictions = 0;   ///< Entries dropped to make room for new ones.
+};
+
+/*! \brief
+ *   Thread-safe cache holding at most a fixed number of entries.
+ *
+ *   When the cache is full, inserting a new key evicts the least recently used
+ *   entry. Values are returned by copy, so they should be cheap to copy
+ *   (e.g. a std::shared_ptr to the real data).
+ *
+ *   \tparam Key Key type; must be hashable.
+ *   \tparam Value Type of cached values.
+ */
+template <typename Key, typename Value>
+class LruCache {
+public:
+    /*! \brief Constructs an empty cache.
+     *
+     *   \param capacity Maximum number of entries (at least 1).
+     */
+    explicit LruCache(std::size_t capacity);
+
+    /*! \brief Looks up a key and marks it as the most recently used.
+     *
+     *   \return The cached value, or std::nullopt if the key is not cached.
+     */
+    std::optional<Value> Find(const Key& key);
+
+    /*! \brief Inserts or replaces an entry, evicting the oldest one if the cache is full. */
+    void Insert(const Key& key, Value value);
+
+    CacheStats GetStats() const;
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    std::size_t capacity_;                                                      ///< Maximum number of entries.
+    mutable std::mutex mutex_;                                                  ///< Protects everything below.
+    std::list<Entry> entries_;                                                  ///< Most recently used first.
+    std::unordered_map<Key, typename std::list<Entry>::iterator> index_;        ///< Key → position in entries_.
+    CacheStats stats_;                                                          ///< Counters for GetStats().
+};
+
+template <typename Key, typename Value>
+LruCache<Key, Value>::LruCache(std::size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {
+    index_.reserve(capacity_);
+}
+
+template <typename Key, typename Value>
+std::optional<Value> LruCache<Key, Value>::Find(const Key& key) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+}
+
+template <typename Key, typename Value>
+void LruCache<Key, Value>::Insert(const Key& key, Value value) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = std::move(value);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    if (entries_.size() == capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+    entries_.emplace_front(key, std::move(value));
+    index_.emplace(key, entries_.begin());
+}
+
+template <typename Key, typename Value>
+CacheStats LruCache<Key, Value>::GetStats() const {
+    std::lock_guard lock(mutex_);
+    CacheStats stats = stats_;
+    stats.size = entries_.size();
+    return stats;
+}
@@ -0,0 +1,295 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/*! \brief
+ *   Lock-free multi-producer / single-consumer queue template.
+ *
+ *   Any number of threads may call PushBack() concurrently; only one thread may
+ *   consume with Get() or DrainInto(). The queue is node-based: every push allocates one
+ *   heap node that owns the item, links it with a single atomic exchange, and the consumer
+ *   frees it after the pop, which never takes a lock. When the queue is
+ *   empty the consumer spins for a short while, then yields, and finally parks on an
+ *   atomic wait until a producer wakes it up.
+ *
+ *   After Close() new items are rejected and the consumer gets std::nullopt once every
+ *   accepted item has been taken. ShutDown() closes the queue too and discards pending
+ *   items; unlike BlockingQueue::ShutDown(), it does not leave the queue open, because
+ *   only the consumer may unlink nodes.
+ *
+ *   \tparam T Type of elements stored in the queue.
+ */
+template <typename T>
+class MPSCQueue {
+public:
+    /*! \brief Constructs an empty open queue. */
+    MPSCQueue();
+
+    /*! \brief Destroys all nodes that are still in the queue. */
+    ~MPSCQueue();
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /*! \brief Adds an item to the back of the queue. Safe to call from any thread.
+     *
+     *   \param object Item to add.
+     *   \return false if the queue was already closed and the item was dropped.
+     */
+    bool PushBack(T object);
+
+    /*! \brief Retrieves one item, waiting if the queue is empty. Consumer thread only.
+     *
+     *   \return std::optional containing the item, or std::nullopt if closed and empty.
+     */
+    std::optional<T> Get();
+
+    /*! \brief Moves up to \p max items into \p batch, waiting until at least one is available.
+     *
+     *   Consumer thread only. Lets a consumer handle everything that piled up
+     *   while it was busy with a single wake-up.
+     *
+     *   \param batch Vector the items are appended to.
+     *   \param max Maximum number of items to take.
+     *   \return Number of items appended; 0 means the queue is closed and empty.
+     */
+    std::size_t DrainInto(std::vector<T>& batch, std::size_t max);
+
+    /*! \brief Moves up to \p max items into \p batch without waiting. Consumer thread only.
+     *
+     *   \param batch Vector the items are appended to.
+     *   \param max Maximum number of items to take.
+     *   \return Number of items appended.
+     */
+    std::size_t TryDrainInto(std::vector<T>& batch, std::size_t max);
+
+    /*! \brief Returns the number of queued items. Safe to call from any thread.
+     *
+     *   The value is approximate while producers and the consumer are active; it is
+     *   meant for monitoring, not for synchronisation.
+     */
+    std::size_t Size() const;
+
+    /*! \brief Returns true once Close() or ShutDown() has been called. */
+    bool IsClosed() const { return !isOpen_.load(std::memory_order_acquire); }
+
+    /*! \brief Closes the queue and wakes the consumer. */
+    void Close();
+
+    /*! \brief Closes the queue, discards pending items and wakes the consumer. */
+    void ShutDown();
+
+private:
+    /*! \brief Heap-allocated queue node owning one item; the first node is a stub without a value. */
+    struct Node {
+        std::atomic<Node*> next{nullptr};  ///< Next node in push order.
+        std::optional<T> value;            ///< Stored item.
+    };
+
+    std::optional<T> TryPop();
+    bool HasItems() const;
+    bool WaitForItems();
+    bool AwaitStragglers();
+    void DiscardAll();
+
+    static constexpr int kSpinCount = 64;    ///< Busy checks before yielding.
+    static constexpr int kYieldCount = 16;   ///< Yields before parking.
+
+    alignas(64) std::atomic<Node*> head_;      ///< Last pushed node, shared by producers.
+    std::atomic<std::size_t> pushed_{0};       ///< Items accepted or being checked; on the producers' cache line.
+    alignas(64) Node* tail_;                   ///< Stub node owned by the consumer.
+    std::atomic<std::size_t> popped_{0};       ///< Items taken or discarded; written by the consumer only.
+    alignas(64) std::atomic<bool> isOpen_{true};     ///< Indicates if the queue accepts items.
+    std::atomic<bool> discard_{false};               ///< Set by ShutDown() to drop pending items.
+    std::atomic<bool> waiting_{false};               ///< True while the consumer is parked.
+    std::atomic<std::uint32_t> epoch_{0};            ///< Wake-up counter the consumer waits on.
+};
+
+template <typename T>
+MPSCQueue<T>::MPSCQueue() : head_(new Node), tail_(head_.load(std::memory_order_relaxed)) {}
+
+template <typename T>
+MPSCQueue<T>::~MPSCQueue() {
+    Node* node = tail_;
+    while (node != nullptr) {
+        Node* next = node->next.load(std::memory_order_relaxed);
+        delete node;
+        node = next;
+    }
+}
+
+/*! \brief Links a new node behind the current head and wakes a parked consumer. */
+template <typename T>
+bool MPSCQueue<T>::PushBack(T object) {
+    // счётчик растёт до проверки: закрывшийся потребитель ждёт каждый засчитанный узел
+    pushed_.fetch_add(1, std::memory_order_seq_cst);
+    if (!isOpen_.load(std::memory_order_seq_cst)) {
+        pushed_.fetch_sub(1, std::memory_order_seq_cst);
+        return false;
+    }
+
+    Node* node = new Node;
+    node->value.emplace(std::move(object));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_seq_cst);
+
+    if (waiting_.load(std::memory_order_seq_cst)) {
+        epoch_.fetch_add(1, std::memory_order_release);
+        epoch_.notify_one();
+    }
+    return true;
+}
+
+template <typename T>
+std::size_t MPSCQueue<T>::Size() const {
+    std::size_t popped = popped_.load(std::memory_order_relaxed);
+    std::size_t pushed = pushed_.load(std::memory_order_relaxed);
+    return pushed > popped ? pushed - popped : 0;
+}
+
+/*! \brief Closes the queue and wakes the consumer. */
+template <typename T>
+void MPSCQueue<T>::Close() {
+    isOpen_.store(false, std::memory_order_seq_cst);
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_all();
+}
+
+/*! \brief Closes the queue and asks the consumer to drop pending items. */
+template <typename T>
+void MPSCQueue<T>::ShutDown() {
+    discard_.store(true, std::memory_order_release);
+    Close();
+}
+
+/*! \brief Retrieves an item from the queue, blocking if empty. */
+template <typename T>
+std::optional<T> MPSCQueue<T>::Get() {
+    if (std::optional<T> object = TryPop()) {
+        return object;
+    }
+    if (WaitForItems()) {
+        return TryPop();
+    }
+    return std::nullopt;
+}
+
+/*! \brief Takes up to max items in one wake-up. */
+template <typename T>
+std::size_t MPSCQueue<T>::DrainInto(std::vector<T>& batch, std::size_t max) {
+    if (max == 0 || (!HasItems() && !WaitForItems())) {
+        return 0;
+    }
+    return TryDrainInto(batch, max);
+}
+
+/*! \brief Takes whatever is available, up to max items. */
+template <typename T>
+std::size_t MPSCQueue<T>::TryDrainInto(std::vector<T>& batch, std::size_t max) {
+    std::size_t taken = 0;
+    while (taken < max) {
+        std::optional<T> object = TryPop();
+        if (!object) {
+            break;
+        }
+        batch.push_back(std::move(*object));
+        ++taken;
+    }
+    return taken;
+}
+
+/*! \brief Pops the node after the stub; the popped node becomes the new stub. */
+template <typename T>
+std::optional<T> MPSCQueue<T>::TryPop() {
+    if (discard_.load(std::memory_order_acquire)) {
+        DiscardAll();
+        return std::nullopt;
+    }
+
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return std::nullopt;
+    }
+
+    std::optional<T> object = std::move(next->value);
+    next->value.reset();
+    delete tail_;
+    tail_ = next;
+    popped_.store(popped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return object;
+}
+
+template <typename T>
+bool MPSCQueue<T>::HasItems() const {
+    return tail_->next.load(std::memory_order_seq_cst) != nullptr;
+}
+
+/*! \brief Spins, then yields, then parks until an item arrives or the queue closes.
+ *
+ *   \return true if an item is available, false if the queue is closed and empty.
+ */
+template <typename T>
+bool MPSCQueue<T>::WaitForItems() {
+    for (int i = 0; i < kSpinCount + kYieldCount; ++i) {
+        if (HasItems()) {
+            return true;
+        }
+        if (!isOpen_.load(std::memory_order_seq_cst)) {
+            return AwaitStragglers();
+        }
+        if (i >= kSpinCount) {
+            std::this_thread::yield();
+        }
+    }
+
+    while (true) {
+        std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        waiting_.store(true, std::memory_order_seq_cst);
+        if (HasItems()) {
+            waiting_.store(false, std::memory_order_relaxed);
+            return true;
+        }
+        if (!isOpen_.load(std::memory_order_seq_cst)) {
+            waiting_.store(false, std::memory_order_relaxed);
+            return AwaitStragglers();
+        }
+        epoch_.wait(epoch, std::memory_order_acquire);
+        waiting_.store(false, std::memory_order_relaxed);
+    }
+}
+
+/*! \brief Waits for producers that passed the open check before Close() to link their nodes.
+ *
+ *   \return true if an item is available, false once every accepted item has been taken.
+ */
+template <typename T>
+bool MPSCQueue<T>::AwaitStragglers() {
+    while (!HasItems()) {
+        if (pushed_.load(std::memory_order_seq_cst) == popped_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        // узел уже засчитан, но ещё не привязан: окно в несколько инструкций
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+template <typename T>
+void MPSCQueue<T>::DiscardAll() {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    while (next != nullptr) {
+        delete tail_;
+        tail_ = next;
+        tail_->value.reset();
+        popped_.store(popped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        next = tail_->next.load(std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,167 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Persistence_Writer.h"
+
+#include <vector>
+
+#include "Logger.h"
+
+PersistenceWriter::PersistenceWriter(Storage& storage)
+    : storage_(storage) {
+    queue_.SetHighWaterMark(kHighWaterMark, [](std::size_t depth) {
+        CHESS_LOG_WARN("persistence backlog reached the high-water mark, refusing moves", {"depth", depth});
+    });
+    thread_ = std::thread([this]() { Loop(); });
+}
+
+PersistenceWriter::~PersistenceWriter() {
+    queue_.Close();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PersistenceWriter::InsertPlayer(int player_id, const std::string& username, int game_id,
+                                     const std::string& colour) {
+    Job job;
+    job.kind = Job::Kind::InsertPlayer;
+    job.player_id = player_id;
+    job.game_id = game_id;
+    job.text = username;
+    job.colour = colour;
+    queue_.PushBack(std::move(job));
+}
+
+void PersistenceWriter::CreateGame(int game_id, const std::string& initial_board) {
+    Job job;
+    job.kind = Job::Kind::CreateGame;
+    job.game_id = game_id;
+    job.text = initial_board;
+    queue_.PushBack(std::move(job));
+}
+
+void PersistenceWriter::UpdateGame(int game_id, int ply, const std::string& board_state, TraceContext trace) {
+    Job job;
+    job.kind = Job::Kind::UpdateGame;
+    job.game_id = game_id;
+    job.ply = ply;
+    job.text = board_state;
+    if (trace.sampled) {
+        job.trace = trace;
+        job.queued = std::chrono::steady_clock::now();
+    }
+    // очередь полна: доску этой партии целиком перепишет её следующий принятый ход
+    queue_.TryPush(std::move(job));
+}
+
+void PersistenceWriter::UpdateGames(std::vector<BoardUpdate> updates) {
+    Job job;
+    job.kind = Job::Kind::UpdateGames;
+    job.updates = std::move(updates);
+    queue_.TryPush(std::move(job));
+}
+
+void PersistenceWriter::ForgetGames(std::vector<int> game_ids) {
+    if (game_ids.empty()) {
+        return;
+    }
+    Job job;
+    job.kind = Job::Kind::ForgetGames;
+    job.game_ids = std::move(game_ids);
+    queue_.PushBack(std::move(job));
+}
+
+void PersistenceWriter::Loop() {
+    Tracer::Instance().NameThread("persistence");
+    std::vector<Job> batch;
+    batch.reserve(kBatchSize);
+
+    while (queue_.DrainInto(batch, kBatchSize) != 0) {
+        // игры и игроки создаются раньше, чем пишутся доски, поэтому обновления идут последними
+        for (const auto& job : batch) {
+            try {
+                Apply(job);
+            } catch (const std::exception& e) {
+                CHESS_LOG_ERROR("persistence job failed", {"game_id", job.game_id}, {"error", e.what()});
+            }
+        }
+        WriteUpdates(batch);
+        // забываем партии после записи досок пачки, иначе запись вернула бы их ply обратно
+        for (const auto& job : batch) {
+            if (job.kind == Job::Kind::ForgetGames) {
+                for (int game_id : job.game_ids) {
+                    written_ply_.erase(game_id);
+                }
+            }
+        }
+        batch.clear();
+    }
+}
+
+void PersistenceWriter::Apply(const Job& job) {
+    switch (job.kind) {
+        case Job::Kind::InsertPlayer:
+            storage_.InsertIDToDataBase(job.player_id, job.text, job.game_id, job.colour);
+            break;
+        case Job::Kind::CreateGame:
+            storage_.CreateNewGame(job.game_id, job.text);
+            break;
+        case Job::Kind::UpdateGame:
+        case Job::Kind::UpdateGames:
+        case Job::Kind::ForgetGames:
+            break;
+    }
+}
+
+void PersistenceWriter::WriteUpdates(const std::vector<Job>& batch) {
+    // для каждой игры остаётся только самая новая доска пачки
+    std::unordered_map<int, std::pair<int, const std::string*>> newest;
+    auto consider = [&](int game_id, int ply, const std::string& board_state) {
+        auto& entry = newest[game_id];
+        if (entry.second == nullptr || entry.first < ply) {
+            entry = {ply, &board_state};
+        }
+    };
+    for (const auto& job : batch) {
+        if (job.kind == Job::Kind::UpdateGame) {
+            consider(job.game_id, job.ply, job.text);
+        } else if (job.kind == Job::Kind::UpdateGames) {
+            for (const auto& update : job.updates) {
+                consider(update.game_id, update.ply, update.board_state);
+            }
+        }
+    }
+
+    std::vector<std::pair<int, std::string>> rows;
+    std::vector<std::pair<int, int>> plies;
+    for (const auto& [game_id, entry] : newest) {
+        if (entry.first > written_ply_[game_id]) {
+            rows.emplace_back(game_id, *entry.second);
+            plies.emplace_back(game_id, entry.first);
+        }
+    }
+    if (rows.empty()) {
+        return;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        storage_.UpdateGameHistories(rows);
+        auto end = std::chrono::steady_clock::now();
+        for (const auto& [game_id, ply] : plies) {
+            written_ply_[game_id] = ply;
+        }
+
+        // запись общая для пачки, поэтому у каждого трассируемого хода свой спан с одними и теми же границами
+        for (const auto& job : batch) {
+            if (job.trace.sampled) {
+                Tracer::Instance().Record(job.trace, "persistence queue wait", "db", job.queued, start);
+                Tracer::Instance().Record(job.trace, "UpdateGameHistories", "db", start, end);
+            }
+        }
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("board updates not persisted", {"updates", rows.size()}, {"error", e.what()});
+    }
+}
@@ -0,0 +1,142 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "My_Bounded_Queue.h"
+#include "Storage.h"
+#include "Tracing.h"
+
+/*! \brief
+ *   Board of a game after an accepted move, as queued for the database.
+ */
+struct BoardUpdate {
+    int game_id = 0;          ///< Game ID.
+    int ply = 0;              ///< Number of half-moves played when the board was captured.
+    std::string board_state;  ///< Board state after the move.
+};
+
+/*!
+ * \class PersistenceWriter
+ * \brief Writes players, games and board updates to the storage in the background.
+ * \details Request handlers only enqueue a job and return; a single writer thread drains the
+ * queue in batches and performs the round-trips. Jobs are applied in the order they were
+ * queued, except that all board updates of a batch are written last, in one transaction. Several
+ * board updates of one game within a batch collapse into the newest one, and an update older than
+ * the last written ply of its game is skipped.
+ *
+ * The queue is bounded. Board updates are queued from the I/O threads and never wait for space:
+ * when the queue is full, the update is dropped and counted. Every update carries the whole board,
+ * so the next accepted move of that game writes the current position again. Callers stop accepting
+ * moves before that happens, once Backlogged() reports the high-water mark. Player and game rows
+ * cannot be dropped, so they wait for space; they are queued from the matchmaker thread only.
+ */
+class PersistenceWriter {
+public:
+    /*!
+     * \brief Starts the writer thread.
+     * \param storage Storage the jobs are written to; must outlive the writer.
+     */
+    explicit PersistenceWriter(Storage& storage);
+
+    /*!
+     * \brief Writes all queued jobs and stops the writer thread.
+     */
+    ~PersistenceWriter();
+
+    PersistenceWriter(const PersistenceWriter&) = delete;
+    PersistenceWriter& operator=(const PersistenceWriter&) = delete;
+
+    /*!
+     * \brief Queues insertion of a player row, waiting while the queue is full. Not for I/O threads.
+     * \param player_id Player ID.
+     * \param username Username of the player.
+     * \param game_id Game ID.
+     * \param colour Player colour ("White" or "Black").
+     */
+    void InsertPlayer(int player_id, const std::string& username, int game_id, const std::string& colour);
+
+    /*!
+     * \brief Queues creation of a game row, waiting while the queue is full. Not for I/O threads.
+     * \param game_id Game ID.
+     * \param initial_board Initial board state.
+     */
+    void CreateGame(int game_id, const std::string& initial_board);
+
+    /*!
+     * \brief Queues a board update, or drops it if the queue is full.
+     * \param game_id Game ID.
+     * \param ply Number of half-moves played when the board was captured.
+     * \param board_state Board state after the move.
+     * \param trace Request that made the move; if it is sampled, its queue wait and write are traced.
+     */
+    void UpdateGame(int game_id, int ply, const std::string& board_state, TraceContext trace = {});
+
+    /*!
+     * \brief Queues the board updates of a move batch as one job, so they share a transaction.
+     * \details Like UpdateGame(), drops the job if the queue is full.
+     * \param updates Board updates.
+     */
+    void UpdateGames(std::vector<BoardUpdate> updates);
+
+    /*!
+     * \brief Queues dropping the last written ply of games that left memory.
+     * \details Applied after the board updates queued before it. A later update of such a game is written
+     * whatever its ply, so a hibernated game that comes back is persisted as usual. Waits while the queue
+     * is full. Not for I/O threads.
+     * \param game_ids Hibernated or dropped games.
+     */
+    void ForgetGames(std::vector<int> game_ids);
+
+    /*!
+     * \brief Returns the number of jobs waiting to be written. Safe to call from any thread.
+     */
+    std::size_t QueueDepth() const { return queue_.Size(); }
+
+    /*!
+     * \brief Returns true while the backlog is at or above the high-water mark, so new moves should be refused.
+     */
+    bool Backlogged() const { return queue_.Size() >= kHighWaterMark; }
+
+    /*!
+     * \brief Returns the counters of the job queue: depth, waits, rejected (dropped) jobs.
+     */
+    QueueStats GetQueueStats() const { return queue_.GetStats(); }
+
+private:
+    /*! \brief One queued database operation. */
+    struct Job {
+        enum class Kind { InsertPlayer, CreateGame, UpdateGame, UpdateGames, ForgetGames };
+
+        Kind kind = Kind::UpdateGame;  ///< Operation to perform.
+        int player_id = 0;             ///< Player ID for InsertPlayer.
+        int game_id = 0;               ///< Game ID for every kind.
+        int ply = 0;                   ///< Ply of a board update.
+        std::string text;              ///< Username or board state.
+        std::string colour;            ///< Player colour for InsertPlayer.
+        std::vector<BoardUpdate> updates;  ///< Board updates for UpdateGames.
+        std::vector<int> game_ids;         ///< Games for ForgetGames.
+        TraceContext trace;                ///< Request that queued an UpdateGame.
+        std::chrono::steady_clock::time_point queued;  ///< When a traced job was queued.
+    };
+
+    void Loop();
+    void Apply(const Job& job);
+    void WriteUpdates(const std::vector<Job>& batch);
+
+    static constexpr std::size_t kBatchSize = 256;  ///< Jobs taken per wake-up.
+    static constexpr std::size_t kQueueCapacity = 65536;  ///< Jobs the queue holds at most.
+    static constexpr std::size_t kHighWaterMark = kQueueCapacity / 4 * 3;  ///< Backlog at which moves are refused.
+
+    Storage& storage_;                            ///< Target storage.
+    BoundedBlockingQueue<Job> queue_{kQueueCapacity};  ///< Jobs waiting to be written.
+    std::unordered_map<int, int> written_ply_;    ///< Last written ply per resident game; writer thread only.
+    std::thread thread_;                          ///< Writer thread.
+};
@@ -0,0 +1,128 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Rate_Limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+constexpr double kMilli = 1000.0;  ///< Tokens are stored in thousandths.
+
+std::uint64_t Pack(std::uint32_t milli_tokens, std::uint32_t time_ms) {
+    return static_cast<std::uint64_t>(milli_tokens) << 32 | time_ms;
+}
+
+/*!
+ * \brief Milliseconds from the last refill of a bucket to \p now.
+ * \details Times are compared modulo 2^32 ms; idle buckets are evicted long before that wraps.
+ * Another thread may have refilled the bucket at a slightly later \p now, which counts as zero.
+ */
+std::uint32_t Elapsed(std::uint64_t state, std::uint32_t now) {
+    auto elapsed = static_cast<std::int32_t>(now - static_cast<std::uint32_t>(state));
+    return elapsed > 0 ? static_cast<std::uint32_t>(elapsed) : 0;
+}
+
+/*!
+ * \brief Milli-tokens in a bucket after refilling it up to \p now.
+ */
+double Refilled(std::uint64_t state, const RateLimit& limit, std::uint32_t now) {
+    double tokens = static_cast<double>(state >> 32) + static_cast<double>(Elapsed(state, now)) * limit.rate;
+    return std::min(tokens, limit.burst * kMilli);
+}
+
+}
+
+RateLimiter::RateLimiter(std::chrono::seconds idle_timeout)
+    : idle_ms_(static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(idle_timeout).count())) {}
+
+void RateLimiter::SetLimit(const std::string& endpoint, RateLimit limit) {
+    auto it = std::find_if(endpoints_.begin(), endpoints_.end(),
+                           [&](const Endpoint& existing) { return existing.name == endpoint; });
+    if (it != endpoints_.end()) {
+        it->limit = limit;
+    } else {
+        endpoints_.push_back({endpoint, limit});
+    }
+}
+
+RateDecision RateLimiter::TryAcquire(int player_id, std::string_view endpoint) {
+    RateDecision decision;
+    // лимитов немного, линейный поиск дешевле хеширования строки
+    auto it = std::find_if(endpoints_.begin(), endpoints_.end(),
+                           [&](const Endpoint& existing) { return existing.name == endpoint; });
+    if (it == endpoints_.end() || it->limit.rate <= 0) {
+        return decision;
+    }
+
+    const RateLimit& limit = it->limit;
+    std::uint64_t key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(player_id)) << 32 |
+                        static_cast<std::uint32_t>(it - endpoints_.begin());
+    Stripe& stripe = stripes_[static_cast<std::uint32_t>(player_id) % kStripes];
+    std::uint32_t now = NowMs();
+
+    {
+        std::shared_lock lock(stripe.mutex);
+        auto bucket = stripe.buckets.find(key);
+        if (bucket != stripe.buckets.end()) {
+            Take(bucket->second, limit, now, decision);
+            return decision;
+        }
+    }
+
+    std::unique_lock lock(stripe.mutex);
+    if (now - stripe.last_sweep >= idle_ms_) {
+        Sweep(stripe, now);
+    }
+    // новый игрок начинает с полным ведром
+    auto [bucket, inserted] =
+        stripe.buckets.try_emplace(key, Pack(static_cast<std::uint32_t>(limit.burst * kMilli), now));
+    Take(bucket->second, limit, now, decision);
+    return decision;
+}
+
+std::size_t RateLimiter::Size() const {
+    std::size_t total = 0;
+    for (const auto& stripe : stripes_) {
+        std::shared_lock lock(stripe.mutex);
+        total += stripe.buckets.size();
+    }
+    return total;
+}
+
+std::uint32_t RateLimiter::NowMs() const {
+    auto elapsed = std::chrono::steady_clock::now() - epoch_;
+    return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+void RateLimiter::Take(Bucket& bucket, const RateLimit& limit, std::uint32_t now, RateDecision& decision) const {
+    // rate токенов в секунду — это ровно rate тысячных токена в миллисекунду
+    std::uint64_t state = bucket.state.load(std::memory_order_relaxed);
+    while (true) {
+        double tokens = Refilled(state, limit, now);
+        if (tokens < kMilli) {
+            decision.allowed = false;
+            decision.retry_after =
+                std::chrono::milliseconds(static_cast<long long>(std::ceil((kMilli - tokens) / limit.rate)));
+            return;
+        }
+        std::uint32_t stamp = static_cast<std::uint32_t>(state) + Elapsed(state, now);
+        std::uint64_t next = Pack(static_cast<std::uint32_t>(tokens - kMilli), stamp);
+        if (bucket.state.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+            decision.allowed = true;
+            return;
+        }
+    }
+}
+
+void RateLimiter::Sweep(Stripe& stripe, std::uint32_t now) {
+    stripe.last_sweep = now;
+    std::erase_if(stripe.buckets, [&](const auto& entry) {
+        std::uint64_t state = entry.second.state.load(std::memory_order_relaxed);
+        const RateLimit& limit = endpoints_[static_cast<std::uint32_t>(entry.first)].limit;
+        return Elapsed(state, now) >= idle_ms_ && Refilled(state, limit, now) >= limit.burst * kMilli;
+    });
+}
@@ -0,0 +1,101 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*! \brief
+ *   Token-bucket parameters of one endpoint.
+ */
+struct RateLimit {
+    double rate = 0;    ///< Tokens added per second.
+    double burst = 0;   ///< Bucket capacity, i.e. the largest burst of requests allowed.
+};
+
+/*! \brief
+ *   Result of RateLimiter::TryAcquire().
+ */
+struct RateDecision {
+    bool allowed = true;                         ///< The request may proceed.
+    std::chrono::milliseconds retry_after{0};    ///< When a rejected request would next be allowed.
+};
+
+/*!
+ * \class RateLimiter
+ * \brief Per-player token buckets with a separate limit for every endpoint.
+ * \details A bucket packs its token count and the time of its last refill into one 64-bit atomic
+ * and is updated with compare-and-swap, so players never wait for each other; a rejected request
+ * does not write at all. Buckets are kept in stripes like SessionStore and are looked up under a
+ * shared lock. A bucket that has been idle for the idle timeout and has refilled completely is
+ * indistinguishable from a new one, so it is dropped when its stripe next creates a bucket.
+ *
+ * Limits are configured with SetLimit() before the limiter is used; endpoints without a limit
+ * are never rejected.
+ */
+class RateLimiter {
+public:
+    /*!
+     * \brief Creates a limiter without any limits.
+     * \param idle_timeout How long a full bucket is kept after its last request.
+     */
+    explicit RateLimiter(std::chrono::seconds idle_timeout = std::chrono::minutes(5));
+
+    /*!
+     * \brief Sets the limit of an endpoint; not thread-safe, call before serving requests.
+     * \param endpoint Endpoint name, e.g. "/move".
+     * \param limit Bucket parameters; a rate of zero removes the limit.
+     */
+    void SetLimit(const std::string& endpoint, RateLimit limit);
+
+    /*!
+     * \brief Takes one token from the bucket of a player for an endpoint.
+     * \param player_id Player ID.
+     * \param endpoint Endpoint name.
+     */
+    RateDecision TryAcquire(int player_id, std::string_view endpoint);
+
+    /*!
+     * \brief Returns the number of live buckets.
+     */
+    std::size_t Size() const;
+
+private:
+    static constexpr std::size_t kStripes = 64;  ///< Number of independently locked stripes.
+
+    /*! \brief Token bucket: milli-tokens in the high half, last refill in ms in the low half. */
+    struct Bucket {
+        explicit Bucket(std::uint64_t state) : state(state) {}
+        std::atomic<std::uint64_t> state;
+    };
+
+    struct Stripe {
+        mutable std::shared_mutex mutex;                       ///< Guards buckets and last_sweep.
+        std::unordered_map<std::uint64_t, Bucket> buckets;     ///< Buckets by player and endpoint.
+        std::uint32_t last_sweep = 0;                          ///< Time of the last eviction pass, in ms.
+    };
+
+    struct Endpoint {
+        std::string name;   ///< Endpoint name.
+        RateLimit limit;    ///< Its limit.
+    };
+
+    std::uint32_t NowMs() const;
+    void Take(Bucket& bucket, const RateLimit& limit, std::uint32_t now, RateDecision& decision) const;
+    void Sweep(Stripe& stripe, std::uint32_t now);
+
+    std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();  ///< Zero of bucket timestamps.
+    std::uint32_t idle_ms_;                  ///< Idle timeout in ms.
+    std::vector<Endpoint> endpoints_;        ///< Limited endpoints; the index is part of the bucket key.
+    std::array<Stripe, kStripes> stripes_;   ///< Bucket stripes.
+};
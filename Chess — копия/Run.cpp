@@ -14,6 +14,7 @@
 #include "Manager.h"
 #include "Run.h"
 #include "Table.h"
+#include "Tracing.h"
 
 namespace {
 
@@ -59,9 +60,15 @@ const std::map<Table::TurnVerdict, std::string> kShowingText = {
 
 /*!
  * \brief Constructor for RunningGame class.
- * \details Initializes chess table, game, and manager.
+ * \details Initializes the arena, then chess table, game, and manager inside it.
  */
-RunningGame::RunningGame() : chessTable_(), game_(chessTable_), manager_() {}
+RunningGame::RunningGame(GameLocking locking)
+    : arena_()
+    , chessTable_(&arena_)
+    , game_(chessTable_)
+    , manager_()
+    , moves_(&arena_)
+    , locking_(locking) {}
 
 /*!
  * \brief Main game loop.
@@ -91,15 +98,22 @@ int RunningGame::Run() {
 
 /*! \brief Displays the current board state to the console. */
 void RunningGame::DisplayBoardState() const {
-    std::string boardState = chessTable_.GenerateBoardState();
+    std::string boardState = GetBoardState();
     std::cout << "Current board state:\n" << boardState << std::endl;
 }
 
 /*! \brief Returns the current board state as a string. */
 std::string RunningGame::GetBoardState() const {
+    auto lock = Lock();
     return chessTable_.GenerateBoardState();
 }
 
+/*! \brief Returns the number of half-moves played. */
+int RunningGame::Ply() const {
+    auto lock = Lock();
+    return ply_;
+}
+
 /*! \brief Reads player input from console. */
 std::string RunningGame::GetPlayerInput() const {
     std::string input;
@@ -119,6 +133,7 @@ bool RunningGame::HandlePlayerInput(const std::string& input) {
         return false;
     }
 
+    auto lock = Lock();
     auto coords = manager_.WordToCoord(chessTable_.getBoard(), input);
     std::cout << "From: (" << coords.first.col << ", " << coords.first.row
               << "), To: (" << coords.second.col << ", " << coords.second.row << ")" << std::endl;
@@ -131,6 +146,7 @@ bool RunningGame::HandlePlayerInput(const std::string& input) {
     auto turnVerdict = chessTable_.CheckTurn(coords.first, coords.second);
     if (turnVerdict == Table::TurnVerdict::correct) {
         chessTable_.DoTurn(coords.first, coords.second);
+        ++ply_;
     } else {
         std::cout << kShowingText.at(turnVerdict) << std::endl;
         if (turnVerdict == Table::TurnVerdict::white_mate || turnVerdict == Table::TurnVerdict::black_mate ||
@@ -144,6 +160,7 @@ bool RunningGame::HandlePlayerInput(const std::string& input) {
 
 /*! \brief Checks draw conditions for the game. */
 void RunningGame::CheckDrawConditions() {
+    auto lock = Lock();
     game_.CheckForRepetition();
     game_.CheckFor50MovesWithoutCapture();
 }
@@ -152,10 +169,18 @@ void RunningGame::CheckDrawConditions() {
  * \brief Handles a move given a string and player color.
  * \param move Move as a string.
  * \param color Player color ("White" or "Black").
+ * \param board_state Optional output for the board state after a successful move.
+ * \param ply Optional output for the half-move count after a successful move.
  * \return true if the move is valid and executed, false otherwise.
  */
-bool RunningGame::HandleMove(const std::string& move, const std::string& color) {
+bool RunningGame::HandleMove(const std::string& move, const std::string& color, std::string* board_state, int* ply) {
+    TraceSpan lock_wait("game lock wait");
+    auto lock = Lock();
+    lock_wait.End();
+
+    TraceSpan parse("WordToCoord");
     auto coords = manager_.WordToCoord(chessTable_.getBoard(), move);
+    parse.End();
     if (coords.first.row == 8 || coords.second.row == 8) {
         return false;
     }
@@ -167,12 +192,72 @@ bool RunningGame::HandleMove(const std::string& move, const std::string& color)
         return false;
     }
 
+    TraceSpan validate("CheckTurn");
     auto turnVerdict = chessTable_.CheckTurn(coords.first, coords.second);
+    validate.End();
     if (turnVerdict == Table::TurnVerdict::correct) {
+        TraceSpan apply("DoTurn");
         chessTable_.DoTurn(coords.first, coords.second);
+        apply.End();
+        ++ply_;
+        moves_.push_back(static_cast<std::uint16_t>((coords.first.row * 8 + coords.first.col) |
+                                                    (coords.second.row * 8 + coords.second.col) << 6));
+        Touch();
+        if (board_state != nullptr) {
+            TraceSpan capture("GenerateBoardState");
+            *board_state = chessTable_.GenerateBoardState();
+        }
+        if (ply != nullptr) {
+            *ply = ply_;
+        }
         return true;
     }
 
-    std::cerr << "Invalid move!" << std::endl;
     return false;
 }
+
+/*! \brief Captures the move log and the board under the game lock. */
+GameSnapshot RunningGame::Snapshot() const {
+    auto lock = Lock();
+    return {ply_, chessTable_.GenerateBoardState(), {moves_.begin(), moves_.end()}};
+}
+
+/*!
+ * \brief Replays the moves of a snapshot.
+ * \details Moves were validated when they were first played, so they are applied through the same
+ * CheckTurn/DoTurn path without the colour check of HandleMove.
+ */
+bool RunningGame::Restore(const GameSnapshot& snapshot) {
+    auto lock = Lock();
+    for (std::uint16_t code : snapshot.moves) {
+        Coord from{(code & 0x3F) / 8, (code & 0x3F) % 8};
+        Coord to{((code >> 6) & 0x3F) / 8, ((code >> 6) & 0x3F) % 8};
+        if (chessTable_.CheckTurn(from, to) != Table::TurnVerdict::correct) {
+            return false;
+        }
+        chessTable_.DoTurn(from, to);
+        moves_.push_back(code);
+    }
+    ply_ = snapshot.ply;
+    Touch();
+    return chessTable_.GenerateBoardState() == snapshot.board_state;
+}
+
+/*! \brief Locks the game unless its owner is the only thread using it. */
+std::unique_lock<std::mutex> RunningGame::Lock() const {
+    if (locking_ == GameLocking::SingleOwner) {
+        return {};
+    }
+    return std::unique_lock<std::mutex>(mutex_);
+}
+
+/*! \brief Stores the current time as the last activity. */
+void RunningGame::Touch() {
+    last_active_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+/*! \brief Returns the time of the last activity. */
+std::chrono::steady_clock::time_point RunningGame::LastActive() const {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(last_active_.load(std::memory_order_relaxed)));
+}
@@ -7,16 +7,37 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "Game.h"
+#include "Game_Arena.h"
 #include "Manager.h"
 
+/*! \brief
+ *   Who may use a RunningGame, and so whether it takes its lock.
+ */
+enum class GameLocking {
+    PerGame,      ///< Any thread; every access takes the game lock.
+    SingleOwner,  ///< Only the thread that owns the game, e.g. its shard; the lock is never taken.
+};
+
 /*!
  * \class RunningGame
  * \brief Manages the execution of a chess game.
  * \details The `RunningGame` class encapsulates the main game loop, board display,
  * player input handling, and game termination conditions. It integrates `Table`,
  * `Game`, and `Manager` components to manage the chess game.
+ *
+ * The board, its cells and the move log are allocated from the GameArena of the game, which lives
+ * inside the object: creating a game is a single heap allocation and destroying it frees the whole
+ * state at once. Like the board, the arena is only used under the game lock, or by the owning thread of a
+GameLocking::SingleOwner game.
  */
 
 class RunningGame {
@@ -25,9 +46,10 @@ public:
     /*!
      * \brief Constructs a `RunningGame` object.
      * \details Initializes the chess table, game logic, and move manager.
+     * \param locking Whether the game is shared between threads or used by its owner only.
      */
 
-    RunningGame();
+    explicit RunningGame(GameLocking locking = GameLocking::PerGame);
 
     /*!
      * \brief Default destructor for the `RunningGame` class.
@@ -42,9 +64,52 @@ public:
      */
 
     int Run();
-    bool HandleMove(const std::string& move, const std::string& color);
+
+    /*!
+     * \brief Validates and applies a move sent by a player.
+     * \details Takes only this game's lock, so moves in different games never wait for each other;
+     *          a GameLocking::SingleOwner game takes no lock at all.
+     * \param move Move as a string (e.g., "e2 e4").
+     * \param color Player color ("White" or "Black").
+     * \param board_state If not null, receives the board state right after a successful move, taken under the same lock.
+     * \param ply If not null, receives the number of half-moves played after a successful move.
+     * \return true if the move is valid and executed, false otherwise.
+     */
+    bool HandleMove(const std::string& move, const std::string& color, std::string* board_state = nullptr,
+                    int* ply = nullptr);
+
+    /*!
+     * \brief Returns the current board state as a string.
+     */
     std::string GetBoardState() const;
 
+    /*!
+     * \brief Returns the number of half-moves played in this game.
+     */
+    int Ply() const;
+
+    /*!
+     * \brief Captures the game in compact form.
+     */
+    GameSnapshot Snapshot() const;
+
+    /*!
+     * \brief Rebuilds a game from a snapshot; call on a freshly constructed game.
+     * \param snapshot Snapshot taken with Snapshot().
+     * \return false if a move could not be replayed or the board differs from the snapshot.
+     */
+    bool Restore(const GameSnapshot& snapshot);
+
+    /*!
+     * \brief Records activity in the game; safe to call without the game lock.
+     */
+    void Touch();
+
+    /*!
+     * \brief Returns the time of the last Touch() or accepted move.
+     */
+    std::chrono::steady_clock::time_point LastActive() const;
+
 
 private:
 
@@ -79,7 +144,18 @@ private:
 
     void CheckDrawConditions();
 
+    /*!
+     * \brief Takes the game lock, or returns an empty lock for a GameLocking::SingleOwner game.
+     */
+    std::unique_lock<std::mutex> Lock() const;
+
+    GameArena arena_;  ///< Memory of the game state; declared first so that it outlives everything allocated from it.
     Table chessTable_; ///< Represents the chessboard and its state.
     Game game_;        ///< Manages game logic, including turn management and endgame checks.
     Manager manager_;  ///< Handles move parsing and coordinate translation.
+    int ply_ = 0;      ///< Number of half-moves played.
+    std::pmr::vector<std::uint16_t> moves_;  ///< Applied moves, in the encoding of GameSnapshot.
+    std::atomic<std::chrono::steady_clock::rep> last_active_{std::chrono::steady_clock::now().time_since_epoch().count()};  ///< Time of the last activity.
+    GameLocking locking_;       ///< Whether mutex_ is used.
+    mutable std::mutex mutex_;  ///< Per-game lock protecting the board of this game only.
 };
\ No newline at end of file
@@ -4,106 +4,605 @@
 
 #include "Server_Interface.h"
 
-void ChessServer::runServer() {
-    httplib::Server svr;
+#include <charconv>
+#include <iostream>
+#include <sstream>
+
+#include "Logger.h"
+
+std::optional<Session> ChessServer::FindSession(const HttpRequest &req) {
+    return Authenticate(std::stoi(req.GetParam("id_player")), req.GetParam("token"));
+}
+
+bool ChessServer::AdmitRequest(const HttpRequest &req, HttpResponse &res) {
+    // база не успевает за ходами: отказываем до того, как ход изменит партию, а не теряем его доску
+    if ((req.path == "/move" || req.path == "/moves/batch") && writer_.Backlogged()) {
+        res.status = 503;
+        res.SetHeader("Retry-After", "1");
+        res.SetContent("Server overloaded", "text/plain");
+        return false;
+    }
+
+    std::string id = req.GetParam("id_player");
+    int player_id = 0;
+    if (std::from_chars(id.data(), id.data() + id.size(), player_id).ec != std::errc()) {
+        return true;
+    }
+    // ведро списывается только с настоящего игрока: иначе чужой id без токена выбивал бы его лимит;
+    // запрос без токена отклонит сам обработчик, поиск сессии в памяти дешевле игры и базы
+    if (!Authenticate(player_id, req.GetParam("token"))) {
+        return true;
+    }
+
+    RateDecision decision = limiter_.TryAcquire(player_id, req.path);
+    if (decision.allowed) {
+        return true;
+    }
+    // Retry-After в целых секундах, с округлением вверх
+    res.status = 429;
+    res.SetHeader("Retry-After", std::to_string((decision.retry_after.count() + 999) / 1000));
+    res.SetContent("Too many requests", "text/plain");
+    return false;
+}
+
+std::optional<Session> ChessServer::Authenticate(int player_id, std::string_view token) {
+    std::optional<Session> session = sessions_.Find(player_id);
+    if (!session || !TokensEqual(session->token, token)) {
+        return std::nullopt;
+    }
+    return session;
+}
+
+std::optional<int> ChessServer::PairedGame(int player_id, std::string_view token) {
+    std::optional<Session> session = Authenticate(player_id, token);
+    if (!session || session->game_id == 0) {
+        return std::nullopt;
+    }
+    return session->game_id;
+}
+
+Task<std::optional<Pairing>> ChessServer::AwaitPairing(int player_id, std::string username, int rating,
+                                                       std::string time_control) {
+    std::shared_ptr<TicketClaim> claim;
+    auto pairing = co_await AwaitCallback<Pairing>(kPairingWait, [&](std::function<void(Pairing)> deliver) {
+        claim = matchmaker_.Submit(player_id, username, rating, time_control,
+                                   [deliver](const Pairing& paired) { deliver(paired); });
+    });
+    if (pairing) {
+        co_return pairing;
+    }
+
+    // без отзыва билета матчмейкер свёл бы с соперником игрока, который уже ушёл
+    if (matchmaker_.Withdraw(claim)) {
+        sessions_.Erase(player_id);
+        co_return std::nullopt;
+    }
+    // пару создали одновременно с таймаутом: сессия уже знает игру и цвет
+    std::optional<Session> session = sessions_.Find(player_id);
+    if (!session || session->game_id == 0) {
+        co_return std::nullopt;
+    }
+    co_return Pairing{session->game_id, session->colour};
+}
+
+Task<MoveResult> ChessServer::PlayMove(const Session& session, std::string move, TraceContext trace) {
+    // ход и снимок доски берутся под блокировкой (или на шарде) только этой игры;
+    // ход короткий и копируется без аллокации, оригинал остаётся для журнала
+    MoveResult result = co_await manager_.MakeMoveAsync(session.game_id, move, session.colour, trace);
+
+    // сохраняем актуальное состояние доски конкретной игры
+    if (result.accepted) {
+        writer_.UpdateGame(session.game_id, result.ply, result.board_state, trace);
+    } else {
+        CHESS_LOG_DEBUG("move rejected", {"game_id", session.game_id}, {"player_id", session.player_id},
+                        {"move", move}, {"found", result.found});
+    }
+    co_return result;
+}
+
+Task<std::string> ChessServer::HandleBinary(const BinaryHeader& header, BinaryPayloadView payload) {
+    auto status = [](BinaryStatus value) { return static_cast<std::uint8_t>(value); };
+
+    // те же классы, что и у HTTP: ход важнее запроса состояния, Auth только ждёт соперника
+    RequestPriority priority = header.type == BinaryFrameType::Move     ? RequestPriority::Critical
+                               : header.type == BinaryFrameType::Status ? RequestPriority::Normal
+                                                                        : RequestPriority::Unlimited;
+    std::optional<ConcurrencyLimiter::Permit> permit = concurrency_.TryAcquire(priority);
+    if (!permit || (header.type == BinaryFrameType::Move && writer_.Backlogged())) {
+        bool move = header.type == BinaryFrameType::Move;
+        co_return BinaryFrameWriter(move ? BinaryFrameType::MoveReply : BinaryFrameType::StatusReply, header.tag,
+                                    move ? kBinaryMoveReplySize : kBinaryStatusReplySize)
+            .U8(0, status(BinaryStatus::Overloaded))
+            .Release();
+    }
+
+    switch (header.type) {
+        case BinaryFrameType::Auth: {
+            if (payload.Size() != kBinaryAuthSize) {
+                break;
+            }
+            int player_id = id_generator.NextID();
+            Session session = sessions_.Create(player_id, 0, "");
+            auto pairing = co_await AwaitPairing(player_id, std::string(payload.Text(4, 32)), payload.I32(0),
+                                                 std::string(payload.Text(36, 16)));
+
+            BinaryFrameWriter reply(BinaryFrameType::AuthReply, header.tag, kBinaryAuthReplySize);
+            if (!pairing) {
+                // билет отозван, сессии больше нет: клиент отправляет Auth заново
+                co_return reply.U8(0, status(BinaryStatus::NoOpponent)).Release();
+            }
+            BinaryColour colour = pairing->colour == "White" ? BinaryColour::White : BinaryColour::Black;
+            co_return reply.U8(0, status(BinaryStatus::Ok))
+                .U8(1, static_cast<std::uint8_t>(colour))
+                .I32(4, player_id)
+                .I32(8, pairing->game_id)
+                .Text(12, kBinaryTokenSize, session.token)
+                .Release();
+        }
+        case BinaryFrameType::Move: {
+            if (payload.Size() != kBinaryMoveSize) {
+                break;
+            }
+            BinaryFrameWriter reply(BinaryFrameType::MoveReply, header.tag, kBinaryMoveReplySize);
+            std::optional<Session> session = Authenticate(payload.I32(0), payload.Text(8, kBinaryTokenSize));
+            if (!session) {
+                co_return reply.U8(0, status(BinaryStatus::NotAuthenticated)).Release();
+            }
+            if (!limiter_.TryAcquire(session->player_id, "/move").allowed) {
+                co_return reply.U8(0, status(BinaryStatus::RateLimited)).Release();
+            }
+            std::optional<std::string> move = DecodeBinaryMove(payload.U16(4));
+            if (session->game_id == 0) {
+                co_return reply.U8(0, status(BinaryStatus::WaitingForOpponent)).Release();
+            }
+            if (!move) {
+                co_return reply.U8(0, status(BinaryStatus::InvalidMove)).Release();
+            }
+
+            MoveResult result = co_await PlayMove(*session, *move, Tracer::Instance().BeginRequest());
+            if (!result.found) {
+                co_return reply.U8(0, status(BinaryStatus::GameNotFound)).Release();
+            }
+            if (!result.accepted) {
+                co_return reply.U8(0, status(BinaryStatus::InvalidMove)).Release();
+            }
+            co_return reply.U8(0, status(BinaryStatus::Ok))
+                .I32(4, result.ply)
+                .Position(8, EncodeBinaryPosition(result.board_state))
+                .Release();
+        }
+        case BinaryFrameType::Status: {
+            if (payload.Size() != kBinaryStatusSize) {
+                break;
+            }
+            BinaryFrameWriter reply(BinaryFrameType::StatusReply, header.tag, kBinaryStatusReplySize);
+            std::optional<Session> session = Authenticate(payload.I32(0), payload.Text(4, kBinaryTokenSize));
+            if (!session) {
+                co_return reply.U8(0, status(BinaryStatus::NotAuthenticated)).Release();
+            }
+            if (!limiter_.TryAcquire(session->player_id, "/status").allowed) {
+                co_return reply.U8(0, status(BinaryStatus::RateLimited)).Release();
+            }
+            if (session->game_id == 0) {
+                co_return reply.U8(0, status(BinaryStatus::WaitingForOpponent)).Release();
+            }
+
+            // последний опубликованный ход уже содержит доску, база не нужна
+            auto latest = co_await manager_.LatestAsync(session->game_id);
+            co_return reply.U8(0, status(BinaryStatus::Ok))
+                .I32(4, session->game_id)
+                .I32(8, latest ? latest->ply : 0)
+                .Position(12, EncodeBinaryPosition(latest ? latest->board_state : table.GenerateBoardState()))
+                .Release();
+        }
+        default:
+            break;
+    }
+
+    co_return BinaryFrameWriter(BinaryFrameType::Error, header.tag, 0).Release();
+}
+
+int ChessServer::CreateMatch(const MatchTicket& white, const MatchTicket& black) {
+    int game_id = manager_.CreateGame();
+
+    // игра попадает в очередь записи раньше своих игроков
+    writer_.CreateGame(game_id, table.GenerateBoardState());
+    for (const auto& [ticket, colour] : {std::pair{&white, "White"}, std::pair{&black, "Black"}}) {
+        sessions_.Assign(ticket->player_id, game_id, colour);
+        writer_.InsertPlayer(ticket->player_id, ticket->username, game_id, colour);
+    }
+    CHESS_LOG_INFO("match created", {"game_id", game_id}, {"white_player_id", white.player_id},
+                   {"black_player_id", black.player_id});
+    return game_id;
+}
+
+std::string ChessServer::CollectMetrics(const HttpServer& http) {
+    MetricsWriter metrics;
+
+    for (const RouteStats& route : http.GetRouteStats()) {
+        MetricsWriter::Labels labels = {{"method", route.method}, {"path", route.path}};
+        metrics.Counter("chess_http_requests_total", "HTTP requests by route.", labels,
+                        static_cast<double>(route.requests));
+        metrics.Counter("chess_http_errors_total", "HTTP responses with status 400 or above, by route.", labels,
+                        static_cast<double>(route.errors));
+        metrics.Histogram("chess_http_request_duration_seconds", "Time from dispatch to response, by route.", labels,
+                          route.latency);
+    }
+    metrics.Counter("chess_http_unrouted_requests_total", "HTTP requests for unknown paths.", {},
+                    static_cast<double>(http.UnroutedRequests()));
+
+    ConcurrencyStats concurrency = concurrency_.GetStats();
+    metrics.Gauge("chess_concurrency_limit", "Current adaptive limit of requests in flight.", {},
+                  static_cast<double>(concurrency.limit));
+    metrics.Gauge("chess_requests_in_flight", "Requests holding a concurrency permit.", {},
+                  static_cast<double>(concurrency.in_flight));
+    metrics.Counter("chess_requests_admitted_total", "Requests admitted by the concurrency limiter.", {},
+                    static_cast<double>(concurrency.admitted));
+    const char* priorities[] = {"critical", "normal", "background"};
+    for (std::size_t i = 0; i < concurrency.shed.size(); ++i) {
+        metrics.Counter("chess_requests_shed_total", "Requests shed under overload, by priority.",
+                        {{"priority", priorities[i]}}, static_cast<double>(concurrency.shed[i]));
+    }
+
+    GameCounts games = manager_.CountGames();
+    metrics.Gauge("chess_games", "Games by state.", {{"state", "resident"}}, static_cast<double>(games.resident));
+    metrics.Gauge("chess_games", "Games by state.", {{"state", "hibernated"}}, static_cast<double>(games.hibernated));
+    metrics.Gauge("chess_sessions", "Player sessions.", {}, static_cast<double>(sessions_.Size()));
+    metrics.Gauge("chess_matchmaker_waiting_players", "Players left unpaired by the last matchmaking batch.", {},
+                  static_cast<double>(matchmaker_.Waiting()));
+
+    QueueStats persistence = writer_.GetQueueStats();
+    metrics.Gauge("chess_queue_depth", "Items waiting in internal queues.", {{"queue", "persistence"}},
+                  static_cast<double>(persistence.depth));
+    metrics.Gauge("chess_queue_max_depth", "Largest depth of internal queues so far.", {{"queue", "persistence"}},
+                  static_cast<double>(persistence.max_depth));
+    metrics.Counter("chess_queue_rejected_total", "Items dropped because the queue was full.",
+                    {{"queue", "persistence"}}, static_cast<double>(persistence.rejected));
+    metrics.Counter("chess_queue_high_water_total", "Times the depth reached the high-water mark.",
+                    {{"queue", "persistence"}}, static_cast<double>(persistence.high_water_hits));
+    metrics.Counter("chess_queue_push_wait_seconds_total", "Time producers waited for free space.",
+                    {{"queue", "persistence"}}, std::chrono::duration<double>(persistence.push_wait).count());
+    metrics.Counter("chess_queue_pop_wait_seconds_total", "Time the consumer waited for items.",
+                    {{"queue", "persistence"}}, std::chrono::duration<double>(persistence.pop_wait).count());
+    metrics.Gauge("chess_queue_depth", "Items waiting in internal queues.", {{"queue", "matchmaker"}},
+                  static_cast<double>(matchmaker_.QueueDepth()));
+    std::vector<std::size_t> shard_depths = manager_.ShardQueueDepths();
+    for (std::size_t i = 0; i < shard_depths.size(); ++i) {
+        metrics.Gauge("chess_queue_depth", "Items waiting in internal queues.",
+                      {{"queue", "game_shard"}, {"shard", std::to_string(i)}}, static_cast<double>(shard_depths[i]));
+    }
+
+    metrics.Histogram("chess_db_transaction_duration_seconds", "Duration of database transactions.", {},
+                      storage_->RoundTrips().Snapshot());
+    storage_->ReportMetrics(metrics);
+    metrics.Histogram("chess_move_validation_duration_seconds", "Time to parse, validate and apply a move.", {},
+                      manager_.MoveValidation().Snapshot());
+
+    CacheStats cache = renderer_.GetCacheStats();
+    metrics.Gauge("chess_board_cache_entries", "Rendered board images in the cache.", {},
+                  static_cast<double>(cache.size));
+    metrics.Counter("chess_board_cache_hits_total", "Board image cache hits.", {}, static_cast<double>(cache.hits));
+    metrics.Counter("chess_board_cache_misses_total", "Board image cache misses.", {},
+                    static_cast<double>(cache.misses));
+    metrics.Counter("chess_board_cache_evictions_total", "Board images evicted from the cache.", {},
+                    static_cast<double>(cache.evictions));
+    metrics.Gauge("chess_rate_limit_buckets", "Per-player rate limit buckets in memory.", {},
+                  static_cast<double>(limiter_.Size()));
+
+    return metrics.Render();
+}
+
+Task<> ChessServer::SweepSessions(boost::asio::thread_pool& pool) {
+    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+    auto sweep = [this]() {
+        // выгруженные партии больше не пишутся, их ply писателю не нужен
+        std::vector<int> hibernated = manager_.TakeHibernated();
+        std::vector<int> orphaned = sessions_.ExpireIdle(hibernated, manager_.HibernateAfter());
+        writer_.ForgetGames(std::move(hibernated));
+
+        std::vector<int> expired = sessions_.ExpireIdle(kSessionIdleTimeout);
+        orphaned.insert(orphaned.end(), expired.begin(), expired.end());
+        if (orphaned.empty()) {
+            return;
+        }
+        // без сессий до партии не дойдёт ни один запрос: удаляем её отовсюду
+        CHESS_LOG_INFO("abandoned games dropped", {"games", orphaned.size()});
+        manager_.DropGames(orphaned);
+        writer_.ForgetGames(std::move(orphaned));
+    };
+    while (true) {
+        timer.expires_after(kSessionSweepPeriod);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        try {
+            co_await RunBlocking(pool, sweep);
+        } catch (const std::exception& e) {
+            CHESS_LOG_ERROR("session sweep failed", {"error", e.what()});
+        }
+    }
+}
+
+void ChessServer::runServer(std::size_t io_threads) {
+    HttpServer svr(io_threads);
 
     std::cout << "✅ Server started at http://localhost:9090\n";
 
-    svr.Post("/auth", [&](const httplib::Request &req, httplib::Response &res) {
-        std::string username = req.get_param_value("username");
-        std::string email = req.get_param_value("email");
+    // лимит игрока проверяется до разбора хода и до обращения к игре или базе
+    svr.AddFilter([this](const HttpRequest &req, HttpResponse &res) { return AdmitRequest(req, res); });
 
-        std::lock_guard<std::mutex> lock(game_mutex);
+    // при перегрузке первыми отбрасываются картинки, затем запросы состояния; ходы — последними
+    svr.SetConcurrencyLimiter(&concurrency_);
+    svr.SetPriority("/move", RequestPriority::Critical);
+    svr.SetPriority("/moves/batch", RequestPriority::Normal);
+    svr.SetPriority("/status", RequestPriority::Normal);
+    svr.SetPriority("/board", RequestPriority::Background);
+    svr.SetPriority("/auth", RequestPriority::Unlimited);
+    svr.SetPriority("/wait", RequestPriority::Unlimited);
+    // мониторинг нужен как раз под перегрузкой, поэтому его не отбрасываем
+    svr.SetPriority("/metrics", RequestPriority::Unlimited);
+
+    // обработчики — корутины: ожидание матчмейкера, шарда, базы и таймера не занимает поток
+    svr.PostCoroutine("/auth", [&](const HttpRequest &req, HttpResponse &res) -> Task<> {
+    try {
+        std::string username = req.GetParam("username");
+        std::string email = req.GetParam("email");
+        int rating = req.HasParam("rating") ? std::stoi(req.GetParam("rating")) : 1500;
+        std::string time_control = req.HasParam("time_control") ? req.GetParam("time_control") : "none";
 
         int player_id = id_generator.NextID();
-        std::string color = (player_id % 2 == 0) ? "Black" : "White";
 
-        // Найдём или создадим ожидающую игру
-        if (!pending_game_id.has_value()) {
-            // создаём игру и сохраняем id
-            pending_game_id = manager_.GenerateGames();
+        // сессия без игры; игру и цвет назначит матчмейкер, когда найдёт соперника
+        Session session = sessions_.Create(player_id, 0, "");
+        auto pairing = co_await AwaitPairing(player_id, username, rating, time_control);
+        if (!pairing) {
+            res.SetContent("No opponent found, authenticate again", "text/plain");
+            co_return;
         }
 
-        int game_id = *pending_game_id;
-        database_.InsertIDToDataBase(player_id, username, game_id);
-        player_map[player_id] = color;
+        res.SetHeader("X-Session-Token", session.token);
+        res.SetContent("Authenticated: ID = " + std::to_string(player_id) + ", Color = " + pairing->colour,
+                       "text/plain");
+    } catch (const std::exception &e) {
+        res.SetContent(std::string("Error: ") + e.what(), "text/plain");
+    }
+    });
+
+    svr.PostCoroutine("/move", [&](const HttpRequest &req, HttpResponse &res) -> Task<> {
+    try {
+        std::string move = req.GetParam("move");
 
-        if (!game_players.count(game_id)) {
-            game_players[game_id] = {};
+        std::optional<Session> session = FindSession(req);
+        if (!session) {
+            res.SetContent("You are not authenticated!", "text/plain");
+            co_return;
         }
-        game_players[game_id].push_back(player_id);
+        if (session->game_id == 0) {
+            res.SetContent("Waiting for an opponent", "text/plain");
+            co_return;
+        }
+
+        MoveResult result = co_await PlayMove(*session, move, req.trace);
 
-        // Когда 2 игрока в игре — запускаем её
-        if (game_players[game_id].size() == 2) {
-            pending_game_id = std::nullopt;  // освобождаем слот под новую игру
+        if (!result.found) {
+            res.SetContent("Game not found", "text/plain");
+            co_return;
         }
 
-        res.set_content("Authenticated: ID = " + std::to_string(player_id) + ", Color = " + color, "text/plain");
-    });
+        res.SetContent(result.accepted ? "Move accepted" : "Invalid move", "text/plain");
+    } catch (const std::exception &e) {
+        res.SetContent(std::string("Error: ") + e.what(), "text/plain");
+    }
+});
 
-    svr.Post("/move", [&](const httplib::Request &req, httplib::Response &res) {
+    svr.PostCoroutine("/moves/batch", [&](const HttpRequest &req, HttpResponse &res) -> Task<> {
     try {
-        int player_id = std::stoi(req.get_param_value("id_player"));
-        std::string move = req.get_param_value("move");
+        // тело: по строке на ход, "<id_player> <token> <move>"; ответ: "<id_player> <вердикт>"
+        std::vector<int> players;
+        std::vector<std::string> verdicts;
+        std::vector<std::size_t> pending;  // индексы ходов, отправленных в менеджер
+        std::vector<MoveRequest> moves;
+        std::vector<int> games;
 
-        std::lock_guard<std::mutex> lock(game_mutex);
+        std::istringstream body(req.body);
+        std::string line;
+        while (std::getline(body, line)) {
+            std::istringstream item(line);
+            int player_id = 0;
+            std::string token;
+            std::string move;
+            if (!(item >> player_id >> token)) {
+                continue;
+            }
+            std::getline(item >> std::ws, move);
+            if (players.size() == kMaxBatchMoves) {
+                res.status = 413;
+                res.SetContent("Too many moves in a batch", "text/plain");
+                co_return;
+            }
 
-        if (!player_map.count(player_id)) {
-            res.set_content("You are not authenticated!", "text/plain");
-            return;
+            std::optional<Session> session = Authenticate(player_id, token);
+            players.push_back(player_id);
+            if (!session) {
+                verdicts.emplace_back("You are not authenticated!");
+            } else if (!limiter_.TryAcquire(player_id, "/move").allowed) {
+                verdicts.emplace_back("Too many requests");
+            } else if (session->game_id == 0) {
+                verdicts.emplace_back("Waiting for an opponent");
+            } else {
+                verdicts.emplace_back();
+                pending.push_back(players.size() - 1);
+                games.push_back(session->game_id);
+                moves.push_back({session->game_id, std::move(move), session->colour});
+            }
         }
 
-        int game_id = database_.GetGameIDByPlayerID(player_id);
-        auto game = manager_.GetGame(game_id);
+        // партии проверяются параллельно вне I/O потока (по шардам или в пуле), доски сохраняются одной транзакцией
+        std::vector<MoveResult> results = co_await manager_.MakeMovesAsync(std::move(moves));
+        std::vector<BoardUpdate> updates;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const MoveResult& result = results[i];
+            if (!result.found) {
+                verdicts[pending[i]] = "Game not found";
+                continue;
+            }
+            verdicts[pending[i]] = result.accepted ? "Move accepted" : "Invalid move";
+            if (result.accepted) {
+                updates.push_back({games[i], result.ply, result.board_state});
+            }
+        }
+        if (!updates.empty()) {
+            writer_.UpdateGames(std::move(updates));
+        }
 
-        if (!game) {
-            res.set_content("Game not found", "text/plain");
-            return;
+        std::string answer;
+        for (std::size_t i = 0; i < players.size(); ++i) {
+            answer += std::to_string(players[i]) + " " + verdicts[i] + "\n";
         }
+        res.SetContent(std::move(answer), "text/plain");
+    } catch (const std::exception &e) {
+        res.SetContent(std::string("Error: ") + e.what(), "text/plain");
+    }
+});
 
-        bool success = game->HandleMove(move, database_.DetermineUserColor(player_id));
+    svr.GetCoroutine("/status", [&](const HttpRequest &req, HttpResponse &res) -> Task<> {
+    try {
+        std::optional<Session> session = FindSession(req);
+        if (!session) {
+            res.SetContent("You are not authenticated!", "text/plain");
+            co_return;
+        }
+        if (session->game_id == 0) {
+            res.SetContent("Waiting for an opponent", "text/plain");
+            co_return;
+        }
 
-        // сохраняем актуальное состояние доски конкретной игры
-        std::string new_state = manager_.GetBoardState(game_id);
-        database_.UpdateGameHistory(game_id, new_state);
+        // запрос к базе выполняется в пуле, I/O поток тем временем обслуживает других
+        int game_id = session->game_id;
+        std::string board_array = co_await RunBlocking(svr.BlockingPool(), [&, game_id, trace = req.trace]() {
+            TraceScope scope(trace);
+            return storage_->GetBoardHistory(game_id);
+        });
 
-        res.set_content(success ? "Move accepted" : "Invalid move", "text/plain");
+        CHESS_LOG_DEBUG("board history sent", {"game_id", game_id}, {"bytes", board_array.size()});
+        res.SetContent("Board history:\n" + board_array, "text/plain");
     } catch (const std::exception &e) {
-        res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        res.SetContent(std::string("Error: ") + e.what(), "text/plain");
     }
 });
 
-    svr.Get("/status", [&](const httplib::Request &req, httplib::Response &res) {
+    svr.GetCoroutine("/board", [&](const HttpRequest &req, HttpResponse &res) -> Task<> {
     try {
-        int player_id = std::stoi(req.get_param_value("id_player"));
+        std::string format = req.HasParam("format") ? req.GetParam("format") : "png";
 
-        std::lock_guard<std::mutex> lock(game_mutex);
+        // без id_player показывается начальная позиция
+        std::string board_state = table.GenerateBoardState();
+        if (req.HasParam("id_player")) {
+            std::optional<Session> session = FindSession(req);
+            if (!session) {
+                res.SetContent("You are not authenticated!", "text/plain");
+                co_return;
+            }
+            if (session->game_id != 0) {
+                if (auto latest = co_await manager_.LatestAsync(session->game_id)) {
+                    board_state = latest->board_state;
+                }
+            }
+        }
 
-        if (!player_map.count(player_id)) {
-            res.set_content("You are not authenticated!", "text/plain");
-            return;
+        if (format == "text") {
+            res.SetContent(board_state, "text/plain");
+            co_return;
+        }
+        if (format != "png" && format != "svg") {
+            res.status = 400;
+            res.SetContent("Unknown format: " + format, "text/plain");
+            co_return;
+        }
+
+        // популярные позиции отдаются из кэша прямо на I/O потоке, новые рисуются в пуле
+        BoardFormat board_format = format == "png" ? BoardFormat::Png : BoardFormat::Svg;
+        std::shared_ptr<const std::string> image = renderer_.FindCached(board_state, board_format);
+        if (!image) {
+            image = co_await RunBlocking(svr.BlockingPool(), [&]() {
+                return renderer_.RenderAfterMiss(board_state, board_format);
+            });
+        }
+        res.SetContent(*image, BoardRenderer::ContentType(board_format));
+    } catch (const std::exception &e) {
+        res.SetContent(std::string("Error: ") + e.what(), "text/plain");
+    }
+});
+
+    svr.GetCoroutine("/wait", [&](const HttpRequest &req, HttpResponse &res) -> Task<> {
+    try {
+        int since_ply = req.HasParam("since_ply") ? std::stoi(req.GetParam("since_ply")) : 0;
+
+        std::optional<Session> session = FindSession(req);
+        if (!session) {
+            res.SetContent("You are not authenticated!", "text/plain");
+            co_return;
+        }
+        if (session->game_id == 0) {
+            res.SetContent("Waiting for an opponent", "text/plain");
+            co_return;
         }
 
-        int game_id = database_.GetGameIDByPlayerID(player_id);
+        // партия могла быть выгружена вместе с каналом: её текущий ход берём у неё самой
+        int game_id = session->game_id;
+        std::optional<GameUpdate> update = co_await manager_.LatestAsync(game_id);
+        if (update && update->ply <= since_ply) {
+            update.reset();
+        }
 
-        pqxx::work txn(*database_.conn_);
-        pqxx::result r = txn.exec(
-            "SELECT board_states "
-            "FROM GameHistory "
-            "WHERE game_id = " + txn.esc(std::to_string(game_id))
-        );
+        // запрос паркуется без потока, пока игра не продвинется дальше since_ply или не истечёт таймаут
+        GameEvents& events = manager_.Events();
+        int subscription = 0;
+        if (!update) {
+            update = co_await AwaitCallback<GameUpdate>(kLongPollTimeout, [&](std::function<void(GameUpdate)> deliver) {
+                subscription = events.Subscribe(game_id, [deliver, since_ply](const GameUpdate& update) {
+                    if (update.ply > since_ply) {
+                        deliver(update);
+                    }
+                });
+                // ход мог быть сделан до подписки
+                if (auto latest = events.Latest(game_id); latest && latest->ply > since_ply) {
+                    deliver(*latest);
+                }
+            });
+            events.Unsubscribe(game_id, subscription);
+        }
 
-        std::string board_array;
-        if (!r.empty() && !r[0][0].is_null()) {
-            board_array = r[0][0].as<std::string>(); // преобразует массив PostgreSQL в строку
+        if (!update) {
+            res.SetContent("No new moves: Ply = " + std::to_string(since_ply), "text/plain");
+            co_return;
         }
 
-        std::cout << board_array << std::endl;
-        res.set_content("Board history:\n" + board_array, "text/plain");
+        res.SetContent("Ply = " + std::to_string(update->ply) + ", Move = " + update->move + "\n" +
+                        update->board_state, "text/plain");
     } catch (const std::exception &e) {
-        res.set_content(std::string("Error: ") + e.what(), "text/plain");
+        res.SetContent(std::string("Error: ") + e.what(), "text/plain");
     }
 });
 
-    svr.listen("0.0.0.0", 9090);
-}
\ No newline at end of file
+    svr.Get("/metrics", [&](const HttpRequest &, HttpResponse &res) {
+        res.SetContent(CollectMetrics(svr), "text/plain; version=0.0.4");
+    });
+
+    // push-канал: клиент подписывается на ходы своей партии вместо опроса /wait
+    events_server_ = std::make_unique<WebSocketServer>(
+        manager_.Events(),
+        [this](int player_id, const std::string& token) { return PairedGame(player_id, token); },
+        kEventsPort);
+    events_server_->Start();
+
+    // бинарный протокол для ботов работает на тех же I/O потоках, что и HTTP
+    BinaryServer binary(
+        svr.Context(), kBinaryPort,
+        [this](const BinaryHeader& header, BinaryPayloadView payload) { return HandleBinary(header, payload); },
+        manager_.Events(),
+        [this](int player_id, std::string_view token) { return PairedGame(player_id, token); });
+
+    // сессии ушедших игроков и их партии освобождаются в фоне, пока работает сервер
+    boost::asio::co_spawn(svr.Context(), SweepSessions(svr.BlockingPool()), boost::asio::detached);
+
+    svr.Listen("0.0.0.0", 9090);
+}
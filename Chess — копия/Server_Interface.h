@@ -4,27 +4,54 @@
 
 #pragma once
 
-#include <httplib.h>
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "Binary_Server.h"
+#include "Board_Renderer.h"
+#include "Concurrency_Limiter.h"
+#include "Http_Server.h"
+#include "Matchmaker.h"
+#include "Persistence_Writer.h"
+#include "Rate_Limiter.h"
+#include "Session_Store.h"
+#include "Storage.h"
 #include "Table.h"
+#include "WebSocket_Server.h"
 #include "/Users/wenderlender/Desktop/Chess/Server_Manager.h"
 
 /*!
  * \class ChessServer
  * \brief Represents a chess server that handles game logic and communication.
- * \details This class sets up a server using the `httplib` library to manage requests related to chess gameplay.
+ * \details This class sets up an asynchronous `HttpServer` (Boost.Asio, keep-alive, fixed I/O threads) to manage
+ * requests related to chess gameplay.
  * It supports the following operations:
  *    - Player authentication (`/auth` endpoint)
  *    - Player moves (`/move` endpoint)
+ *    - Moves of many players submitted at once (`/moves/batch` endpoint)
  *    - Game status (`/status` endpoint)
- *    - Board state (`/board` endpoint)
+ *    - Waiting for the opponent's move (`/wait` long-poll endpoint)
+ *    - Move events pushed over WebSocket (`/events` on port 9091)
+ *    - The same operations in a compact binary protocol for bots (TCP port 9092, see Binary_Protocol.h)
+ *    - Board image (`/board` endpoint; PNG, SVG or text, rendered images are cached by position)
+ *    - Counters, queue depths and latency histograms in the Prometheus text format (`/metrics` endpoint)
  *
  * The server uses a `Table` object to manage the chessboard and a `Manager` object to handle moves and validate actions.
- * It ensures thread safety using a `std::mutex` to protect shared resources.
+ * Route handlers are coroutines (`Task<>`): waiting for the matchmaker, a game shard, the database or a timer
+ * suspends the handler instead of blocking an I/O thread.
+ * When overloaded, the server sheds requests with a fast 503 before reading their bodies; the number of requests
+ * in flight is capped by a `ConcurrencyLimiter` that adapts to the latency of moves and keeps them ahead of
+ * status queries and board images.
+ * There is no server-wide lock: players are looked up in the in-memory `SessionStore`, pairing is done in
+ * batches by the `Matchmaker` and each game is protected by its own lock. Validating a move needs no database round-trip;
+ * players, games and board updates are written to the `Storage` (PostgreSQL, in-memory or a SQLite file) in the
+ * background by a `PersistenceWriter`.
  */
 class ChessServer {
 public:
@@ -32,42 +59,166 @@ public:
      * \brief Default constructor for the ChessServer class.
      * \details Initializes the chess server, setting up necessary objects for handling the game logic,
      *          but does not start the server until the `runServer` method is called.
+     * \param mode Game runtime mode: shared map with per-game locks or per-core shards.
+     * \param hibernate_after Inactivity after which a game is hibernated; 0 keeps every game in memory.
+     * \param storage Storage of players, games and board history; null selects PostgreSQL at the default address.
      */
-    ChessServer()
-        : game_mutex()
-        , id_generator(1)
-        , manager_("host=localhost port=5433 dbname=mydb user=myuser password=mypassword")
+    explicit ChessServer(RuntimeMode mode = RuntimeMode::Shared,
+                         std::chrono::seconds hibernate_after = Games_Manager::kDefaultHibernateAfter,
+                         std::shared_ptr<Storage> storage = nullptr)
+        : id_generator(1)
+        , storage_(storage ? std::move(storage) : OpenStorage("postgres"))
+        , manager_(storage_, mode, hibernate_after)
         , running_game_()
-        , database_("host=localhost port=5433 dbname=mydb user=myuser password=mypassword")
+        , writer_(*storage_)
         , table()
-        , player_map()
-        , game_players()
-        , pending_game_id(std::nullopt)
-    {}
+        , sessions_()
+        , renderer_()
+        , matchmaker_([this](const MatchTicket& white, const MatchTicket& black) { return CreateMatch(white, black); })
+    {
+        for (const auto& [endpoint, limit] : kDefaultRateLimits) {
+            limiter_.SetLimit(endpoint, limit);
+        }
+    }
 
     /*!
      * \brief Handles player authentication requests.
      * \param req Incoming HTTP request.
      * \param res HTTP response to be sent back to the client.
      */
-    void doAuth(const httplib::Request &req, httplib::Response &res);
+    void doAuth(const HttpRequest &req, HttpResponse &res);
+
+    /*!
+     * \brief Overrides the per-player rate limit of an endpoint; call before runServer().
+     * \param endpoint Endpoint path, e.g. "/move". Moves of /moves/batch and binary Move and Status frames
+     *        count against "/move" and "/status".
+     * \param limit Requests per second and burst size; a rate of zero disables the limit.
+     */
+    void SetRateLimit(const std::string& endpoint, RateLimit limit) { limiter_.SetLimit(endpoint, limit); }
 
     /*!
      * \brief Starts the chess server and begins listening for requests.
      * \details This method sets up the server to handle incoming HTTP requests related to the chess game.
      *          It includes routes for player authentication, moves, game status, and board state.
+     *          The calling thread becomes one of the I/O threads and the method returns when the server stops.
+     * \param io_threads Number of I/O threads serving all connections.
      */
-    void runServer();
+    void runServer(std::size_t io_threads = kDefaultIoThreads);
 
 private:
-    std::mutex game_mutex;  ///< Mutex for thread-safe access to shared resources.
+    /*!
+     * \brief Looks up the session of the player making a request.
+     * \details The `token` parameter must match the session token; a request without it is rejected.
+     * \param req Incoming HTTP request with `id_player` and `token` parameters.
+     * \return The session, or std::nullopt if the player is not authenticated.
+     */
+    std::optional<Session> FindSession(const HttpRequest &req);
+
+    /*!
+     * \brief Rejects a request with 429 if its player exceeds the rate limit of the endpoint.
+     * \details Runs on the I/O thread before the handler, so a limited request costs no game or database work.
+     *          Only authenticated requests are charged: requests without a numeric `id_player` or a matching
+     *          `token` pass through and are rejected by the handler, so nobody can drain another player's bucket.
+     *          Moves are refused with 503 while the persistence writer is past its high-water mark.
+     * \return false if the request was rejected.
+     */
+    bool AdmitRequest(const HttpRequest &req, HttpResponse &res);
+
+    /*!
+     * \brief Looks up a session whose token matches exactly.
+     * \details Every channel goes through it: HTTP via FindSession(), WebSocket, binary and batch moves.
+     * \param player_id Player ID.
+     * \param token Session token.
+     * \return The session, or std::nullopt if the player is not authenticated.
+     */
+    std::optional<Session> Authenticate(int player_id, std::string_view token);
+
+    /*!
+     * \brief Returns the game of an authenticated, already paired player.
+     * \details Authorization check of the event subscriptions.
+     * \return Game ID, or std::nullopt if the token does not match or the player is still waiting.
+     */
+    std::optional<int> PairedGame(int player_id, std::string_view token);
+
+    /*!
+     * \brief Puts a new player into the matchmaker and waits up to kPairingWait for an opponent.
+     * \details If the wait runs out, the ticket is withdrawn and the player's session erased, so nobody
+     *          is later paired with a player who has left; the client has to authenticate again.
+     * \return The pairing, or std::nullopt if no opponent was found.
+     */
+    Task<std::optional<Pairing>> AwaitPairing(int player_id, std::string username, int rating,
+                                              std::string time_control);
+
+    /*!
+     * \brief Applies a move of an authenticated player and queues the new board for the database.
+     * \param session Session of a player who is already paired.
+     * \param move Move in text notation.
+     * \param trace Request the move belongs to.
+     */
+    Task<MoveResult> PlayMove(const Session& session, std::string move, TraceContext trace);
+
+    /*!
+     * \brief Handles an Auth, Move or Status frame of the binary protocol.
+     * \param header Frame header.
+     * \param payload Frame payload.
+     * \return The reply frame.
+     */
+    Task<std::string> HandleBinary(const BinaryHeader& header, BinaryPayloadView payload);
+
+    /*!
+     * \brief Creates the game for a pair formed by the matchmaker.
+     * \details Runs on the matchmaker thread: creates the game, assigns both sessions and queues the rows.
+     * \param white Ticket of the player with the white pieces.
+     * \param black Ticket of the player with the black pieces.
+     * \return ID of the new game.
+     */
+    int CreateMatch(const MatchTicket& white, const MatchTicket& black);
+
+    /*!
+     * \brief Releases sessions and games of players who left; runs every kSessionSweepPeriod until the server stops.
+     * \details A game lives as long as one of its players holds a session: sessions are only reachable by their
+     *          player, so a game without sessions can never be played or watched again. Every sweep expires the
+     *          sessions idle for kSessionIdleTimeout and, of games hibernated since the previous sweep, the sessions
+     *          idle for the hibernation period; a player still polling keeps the session and rehydrates the game
+     *          with the next move. Games left without sessions are dropped, and the persistence writer forgets
+     *          hibernated and dropped games. The scan itself runs on \p pool.
+     * \param pool Pool for blocking work of the HTTP server.
+     */
+    Task<> SweepSessions(boost::asio::thread_pool& pool);
+
+    /*!
+     * \brief Renders the `/metrics` scrape.
+     * \details Only sums sharded counters and reads queue sizes, so a scrape does not slow down requests.
+     * \param http Server whose per-route counters are included.
+     */
+    std::string CollectMetrics(const HttpServer& http);
+
+    static constexpr std::chrono::seconds kPairingWait{2};  ///< How long /auth waits for an opponent before answering.
+    static constexpr std::chrono::milliseconds kLongPollTimeout{25000};  ///< How long /wait parks a request.
+    static constexpr std::chrono::minutes kSessionIdleTimeout{30};  ///< Inactivity after which a session expires.
+    static constexpr std::chrono::seconds kSessionSweepPeriod{60};  ///< How often SweepSessions() runs.
+    /// Per-player limits applied unless overridden with SetRateLimit().
+    static constexpr std::pair<const char*, RateLimit> kDefaultRateLimits[] = {
+        {"/move", {5, 10}},
+        {"/status", {1, 5}},
+        {"/wait", {2, 5}},
+        {"/board", {2, 5}},
+    };
+    static constexpr std::size_t kMaxBatchMoves = 256;  ///< Moves accepted in one /moves/batch request.
+    static constexpr std::size_t kDefaultIoThreads = 4;  ///< I/O threads of the HTTP server by default.
+    static constexpr unsigned short kEventsPort = 9091;  ///< Port of the WebSocket event channel.
+    static constexpr unsigned short kBinaryPort = 9092;  ///< Port of the binary protocol.
 
     idGenerator id_generator{1};  ///< Unique ID generator (starts at 1).
-    Games_Manager manager_{"host=localhost port=5433 dbname=mydb user=myuser password=mypassword"};  ///< Manager for all active games.
+    std::shared_ptr<Storage> storage_;  ///< Players, games and board history; shared with manager_.
+    Games_Manager manager_;  ///< Manager for all active games.
     RunningGame running_game_;  ///< Object managing a running chess game.
-    DataBase database_{"host=localhost port=5433 dbname=mydb user=myuser password=mypassword"};  ///< Connection to the database.
+    PersistenceWriter writer_{*storage_};  ///< Background writer for players, games and board updates.
     Table table;  ///< Chessboard and game logic handler.
-    std::unordered_map<int, std::string> player_map;  ///< Mapping: player_id → color ("White" / "Black").
-    std::unordered_map<int, std::vector<int>> game_players;  ///< Mapping: game_id → list of player IDs.
-    std::optional<int> pending_game_id;  ///< ID of the game waiting for players to join.
+    SessionStore sessions_;  ///< Mapping: player_id → game, colour and token.
+    RateLimiter limiter_;  ///< Per-player token buckets checked before every handler.
+    ConcurrencyLimiter concurrency_;  ///< Server-wide cap on requests in flight, adapted to /move latency.
+    BoardRenderer renderer_;  ///< Board images for /board, cached by position.
+    Matchmaker matchmaker_;  ///< Pairs waiting players; stops before everything it uses.
+    std::unique_ptr<WebSocketServer> events_server_;  ///< WebSocket push channel; created by runServer().
 };
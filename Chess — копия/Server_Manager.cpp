@@ -4,6 +4,18 @@
 
 #include "Server_Manager.h"
 
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <optional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "Logger.h"
+
 idGenerator::idGenerator(int id) : id_(id) {}
 
 int idGenerator::NextID() {
@@ -11,43 +23,481 @@ int idGenerator::NextID() {
 }
 
 int Games_Manager::GenerateGames() {
-    std::lock_guard<std::mutex> lock(game_mutex_);
+    int id_game = CreateGame();
+    PersistGame(id_game);
+    return id_game;
+}
 
-    auto game = std::make_shared<RunningGame>();
+int Games_Manager::CreateGame() {
     int id_game = id_generator_.NextID();
 
-    games_[id_game] = game;
+    if (shards_) {
+        shards_->ShardOf(id_game).Post([id_game](GameShard& shard) { shard.AddGame(id_game); });
+        return id_game;
+    }
 
-    std::string initial_board = table_.GenerateBoardState();
-    database_.CreateNewGame(id_game, initial_board);
+    auto game = std::make_shared<RunningGame>();
 
-    boost::thread([this, game]() {
-        start_game_.StartGame();
-        game->Run();
-    }).detach();
+    // партия живёт только в games_: поток с консольным циклом держал бы её в памяти навсегда
+    {
+        std::unique_lock<std::shared_mutex> lock(game_mutex_);
+        games_[id_game] = game;
+    }
 
     return id_game;
 }
 
+void Games_Manager::PersistGame(int id_game) {
+    storage_->CreateNewGame(id_game, GetBoardState(id_game));
+}
+
+Games_Manager::~Games_Manager() {
+    {
+        std::lock_guard<std::mutex> lock(hibernator_mutex_);
+        stopping_ = true;
+    }
+    hibernator_cv_.notify_all();
+    if (hibernator_.joinable()) {
+        hibernator_.join();
+    }
+    // задачи пула обращаются к картам партий, которые уничтожаются раньше него
+    if (move_pool_) {
+        move_pool_->join();
+    }
+}
 
 std::shared_ptr<RunningGame> Games_Manager::GetGame(int id_game) {
-    std::lock_guard<std::mutex> lock(game_mutex_);
-    auto it = games_.find(id_game);
-    if (it != games_.end())
+    {
+        std::shared_lock<std::shared_mutex> lock(game_mutex_);
+        auto it = games_.find(id_game);
+        if (it != games_.end()) {
+            it->second->Touch();
+            return it->second;
+        }
+    }
+    return Rehydrate(id_game);
+}
+
+std::shared_ptr<RunningGame> Games_Manager::Rehydrate(int id_game) {
+    {
+        std::unique_lock<std::shared_mutex> lock(game_mutex_);
+        // другой запрос мог восстановить партию, пока мы ждали блокировку
+        if (auto it = games_.find(id_game); it != games_.end()) {
+            return it->second;
+        }
+        // снимок ещё не записан: партия возвращается прямо из памяти
+        if (auto pending = hibernating_.find(id_game); pending != hibernating_.end()) {
+            GameSnapshot snapshot = std::move(pending->second);
+            hibernating_.erase(pending);
+            return Revive(id_game, snapshot);
+        }
+        if (hibernated_.count(id_game) == 0) {
+            return nullptr;
+        }
+    }
+
+    // снимок читается без блокировки карты: запрос к хранилищу не задерживает другие партии
+    std::optional<GameSnapshot> snapshot = storage_->LoadSnapshot(id_game);
+
+    std::unique_lock<std::shared_mutex> lock(game_mutex_);
+    if (auto it = games_.find(id_game); it != games_.end()) {
         return it->second;
-    return nullptr;
+    }
+    // партию удалили, пока читали снимок
+    if (hibernated_.erase(id_game) == 0) {
+        return nullptr;
+    }
+    if (!snapshot) {
+        CHESS_LOG_ERROR("snapshot of a hibernated game is missing", {"game_id", id_game});
+        return nullptr;
+    }
+    return Revive(id_game, *snapshot);
+}
+
+std::shared_ptr<RunningGame> Games_Manager::Revive(int id_game, const GameSnapshot& snapshot) {
+    auto game = std::make_shared<RunningGame>();
+    if (!game->Restore(snapshot)) {
+        CHESS_LOG_WARN("game restored with a different board", {"game_id", id_game});
+    }
+    games_[id_game] = game;
+    return game;
+}
+
+Task<std::shared_ptr<RunningGame>> Games_Manager::GetGameAsync(int id_game) {
+    {
+        std::shared_lock<std::shared_mutex> lock(game_mutex_);
+        auto it = games_.find(id_game);
+        if (it != games_.end()) {
+            it->second->Touch();
+            co_return it->second;
+        }
+    }
+    // выгруженная партия читается из хранилища в пуле, а не на I/O потоке
+    auto rehydrate = [this, id_game]() { return Rehydrate(id_game); };
+    co_return co_await RunBlocking(*move_pool_, std::move(rehydrate));
+}
+
+void Games_Manager::HibernateIdle(std::chrono::steady_clock::duration idle_timeout) {
+    if (shards_) {
+        // снимки пишет вызывающий поток, а не шард: запись в хранилище не задерживает ходы
+        for (std::size_t i = 0; i < shards_->Size(); ++i) {
+            auto snapshots = shards_->SubmitAt(i, [idle_timeout](GameShard& shard) {
+                return shard.HibernateIdle(idle_timeout);
+            }).get();
+            std::vector<int> stored = StoreSnapshots(snapshots);
+            if (stored.empty()) {
+                continue;
+            }
+            std::vector<int> hibernated = shards_->SubmitAt(i, [&stored](GameShard& shard) {
+                return shard.CompleteHibernation(stored);
+            }).get();
+            FinishHibernation(stored, hibernated);
+        }
+        return;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() - idle_timeout;
+    std::vector<std::pair<int, GameSnapshot>> snapshots;
+    {
+        std::unique_lock<std::shared_mutex> lock(game_mutex_);
+        for (auto it = games_.begin(); it != games_.end();) {
+            // под эксклюзивной блокировкой новых ссылок не появится; use_count() > 1 — партию держит запрос
+            if (it->second.use_count() == 1 && it->second->LastActive() <= deadline) {
+                hibernating_[it->first] = it->second->Snapshot();
+                it = games_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        // неудачная прошлая запись повторяется вместе с новыми снимками
+        snapshots.assign(hibernating_.begin(), hibernating_.end());
+    }
+    std::vector<int> stored = StoreSnapshots(snapshots);
+    if (stored.empty()) {
+        return;
+    }
+
+    std::vector<int> hibernated;
+    {
+        std::unique_lock<std::shared_mutex> lock(game_mutex_);
+        for (int id_game : stored) {
+            if (hibernating_.erase(id_game) != 0) {
+                hibernated_.insert(id_game);
+                hibernated.push_back(id_game);
+            }
+        }
+    }
+    FinishHibernation(stored, hibernated);
+}
+
+std::vector<int> Games_Manager::StoreSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) {
+    if (snapshots.empty()) {
+        return {};
+    }
+    try {
+        storage_->SaveSnapshots(snapshots);
+    } catch (const std::exception& e) {
+        // снимки остаются в памяти, следующий проход запишет их снова
+        CHESS_LOG_ERROR("snapshots not stored, retrying later", {"games", snapshots.size()}, {"error", e.what()});
+        return {};
+    }
+    std::vector<int> stored;
+    stored.reserve(snapshots.size());
+    for (const auto& [id_game, snapshot] : snapshots) {
+        stored.push_back(id_game);
+    }
+    return stored;
+}
+
+void Games_Manager::FinishHibernation(const std::vector<int>& stored, const std::vector<int>& hibernated) {
+    // остальные партии восстановили или удалили во время записи: их снимок в хранилище уже не нужен
+    if (hibernated.size() != stored.size()) {
+        std::unordered_set<int> kept(hibernated.begin(), hibernated.end());
+        std::vector<int> stale;
+        for (int id_game : stored) {
+            if (kept.count(id_game) == 0) {
+                stale.push_back(id_game);
+            }
+        }
+        DeleteSnapshots(stale);
+    }
+    OnHibernated(hibernated);
+}
+
+void Games_Manager::DeleteSnapshots(const std::vector<int>& ids) {
+    try {
+        storage_->DeleteSnapshots(ids);
+    } catch (const std::exception& e) {
+        CHESS_LOG_ERROR("snapshots not deleted", {"games", ids.size()}, {"error", e.what()});
+    }
+}
+
+void Games_Manager::OnHibernated(const std::vector<int>& ids) {
+    if (ids.empty()) {
+        return;
+    }
+    // вместе с партией из памяти уходит и её канал событий с последней доской
+    for (int id_game : ids) {
+        events_.Remove(id_game);
+    }
+    std::lock_guard<std::mutex> lock(recently_hibernated_mutex_);
+    recently_hibernated_.insert(recently_hibernated_.end(), ids.begin(), ids.end());
+}
+
+std::vector<int> Games_Manager::TakeHibernated() {
+    std::lock_guard<std::mutex> lock(recently_hibernated_mutex_);
+    return std::exchange(recently_hibernated_, {});
+}
+
+void Games_Manager::DropGames(const std::vector<int>& ids) {
+    if (ids.empty()) {
+        return;
+    }
+    if (shards_) {
+        std::vector<std::future<void>> removed;
+        removed.reserve(ids.size());
+        for (int id_game : ids) {
+            removed.push_back(shards_->Submit(id_game, [this, id_game](GameShard& shard) {
+                shard.RemoveGame(id_game);
+                events_.Remove(id_game);
+            }));
+        }
+        for (auto& done : removed) {
+            done.get();
+        }
+    } else {
+        {
+            std::unique_lock<std::shared_mutex> lock(game_mutex_);
+            for (int id_game : ids) {
+                // запрос, ещё держащий партию, доиграет с ней: его shared_ptr продлит ей жизнь
+                games_.erase(id_game);
+                hibernating_.erase(id_game);
+                hibernated_.erase(id_game);
+            }
+        }
+        for (int id_game : ids) {
+            events_.Remove(id_game);
+        }
+    }
+    // снимок, который допишется после этого, удалит сама выгрузка: партии в ней уже нет
+    DeleteSnapshots(ids);
+}
+
+GameCounts Games_Manager::CountGames() {
+    GameCounts counts;
+    if (shards_) {
+        for (std::size_t i = 0; i < shards_->Size(); ++i) {
+            counts.resident += shards_->ShardAt(i).ResidentGames();
+            counts.hibernated += shards_->ShardAt(i).HibernatedGames();
+        }
+        return counts;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(game_mutex_);
+    counts.resident = games_.size();
+    counts.hibernated = hibernating_.size() + hibernated_.size();
+    return counts;
+}
+
+std::vector<std::size_t> Games_Manager::ShardQueueDepths() const {
+    std::vector<std::size_t> depths;
+    if (shards_) {
+        for (std::size_t i = 0; i < shards_->Size(); ++i) {
+            depths.push_back(shards_->ShardAt(i).InboxDepth());
+        }
+    }
+    return depths;
+}
+
+void Games_Manager::HibernateLoop() {
+    auto interval = std::clamp<std::chrono::seconds>(hibernate_after_ / 4, std::chrono::seconds(1), std::chrono::seconds(60));
+    std::unique_lock<std::mutex> lock(hibernator_mutex_);
+    while (!hibernator_cv_.wait_for(lock, interval, [this]() { return stopping_; })) {
+        lock.unlock();
+        try {
+            HibernateIdle(hibernate_after_);
+        } catch (const std::exception& e) {
+            CHESS_LOG_ERROR("hibernation failed", {"error", e.what()});
+        }
+        lock.lock();
+    }
 }
 
 std::string Games_Manager::GetBoardState(int id_game) {
-    std::lock_guard<std::mutex> lock(game_mutex_);
+    if (shards_) {
+        return shards_->Submit(id_game, [id_game](GameShard& shard) {
+            RunningGame* game = shard.FindGame(id_game);
+            if (game == nullptr) {
+                throw std::runtime_error("Game not found with id: " + std::to_string(id_game));
+            }
+            return game->GetBoardState();
+        }).get();
+    }
 
-    auto it = games_.find(id_game);
-    if (it != games_.end() && it->second) {
-        return it->second->GetBoardState();
+    auto game = GetGame(id_game);
+    if (game) {
+        return game->GetBoardState();
     }
 
     throw std::runtime_error("Game not found with id: " + std::to_string(id_game));
 }
 
+Task<std::optional<GameUpdate>> Games_Manager::LatestAsync(int id_game) {
+    if (auto latest = events_.Latest(id_game)) {
+        co_return latest;
+    }
+
+    // канала нет у выгруженной партии: доску и номер хода отдаёт сама партия, восстановившись
+    auto read = [id_game](RunningGame* game) -> std::optional<GameUpdate> {
+        if (game == nullptr) {
+            return std::nullopt;
+        }
+        GameSnapshot snapshot = game->Snapshot();
+        if (snapshot.ply == 0) {
+            return std::nullopt;
+        }
+        return GameUpdate{id_game, snapshot.ply, "", std::move(snapshot.board_state)};
+    };
+    if (shards_) {
+        co_return co_await shards_->SubmitAsync(id_game, [id_game, read](GameShard& shard) {
+            return read(shard.FindGame(id_game));
+        });
+    }
+    std::shared_ptr<RunningGame> game = co_await GetGameAsync(id_game);
+    co_return read(game.get());
+}
+
+MoveResult Games_Manager::ApplyMove(RunningGame* game, int id_game, const std::string& move, const std::string& color) {
+    MoveResult result;
+    if (game != nullptr) {
+        result.found = true;
+        ScopedLatency timer(move_validation_);
+        result.accepted = game->HandleMove(move, color, &result.board_state, &result.ply);
+    }
+    if (result.accepted) {
+        TraceSpan span("publish event");
+        events_.Publish({id_game, result.ply, move, result.board_state});
+    }
+    return result;
+}
+
+MoveResult Games_Manager::MakeMove(int id_game, const std::string& move, const std::string& color) {
+    if (shards_) {
+        return shards_->Submit(id_game, [this, id_game, move, color](GameShard& shard) {
+            return ApplyMove(shard.FindGame(id_game), id_game, move, color);
+        }).get();
+    }
 
+    return ApplyMove(GetGame(id_game).get(), id_game, move, color);
+}
+
+Task<MoveResult> Games_Manager::MakeMoveAsync(int id_game, std::string move, std::string color, TraceContext trace) {
+    if (shards_) {
+        auto queued = trace.sampled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        // лямбда с захваченными строками - именованная: GCC 12 копирует временный объект
+        // внутри выражения co_await побитово, и строки освобождаются дважды
+        auto apply = [this, id_game, move, color, trace, queued](GameShard& shard) {
+            Tracer::Instance().Record(trace, "shard queue wait", "game", queued, std::chrono::steady_clock::now());
+            TraceScope scope(trace);
+            return ApplyMove(shard.FindGame(id_game), id_game, move, color);
+        };
+        co_return co_await shards_->SubmitAsync(id_game, std::move(apply));
+    }
+
+    // в общем режиме ход берёт только короткую блокировку своей партии; ждать приходится лишь чтения снимка
+    std::shared_ptr<RunningGame> game = co_await GetGameAsync(id_game);
+    MoveResult result;
+    {
+        TraceScope scope(trace);
+        result = ApplyMove(game.get(), id_game, move, color);
+    }
+    co_return result;
+}
 
+Task<std::vector<MoveResult>> Games_Manager::MakeMovesAsync(std::vector<MoveRequest> requests) {
+    if (requests.empty()) {
+        co_return std::vector<MoveResult>();
+    }
+    if (!shards_) {
+        co_return co_await MakeMovesOnPool(std::move(requests));
+    }
+
+    // одна задача на шард: шарды проверяют свои ходы параллельно, порядок внутри партии сохраняется
+    std::unordered_map<GameShard*, std::vector<std::size_t>> groups;
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        groups[&shards_->ShardOf(requests[i].game_id)].push_back(i);
+    }
+
+    auto shared_requests = std::make_shared<std::vector<MoveRequest>>(std::move(requests));
+    auto results = std::make_shared<std::vector<MoveResult>>(shared_requests->size());
+
+    // обе лямбды именованные, как в MakeMoveAsync: захваты не должны копироваться внутри co_await
+    auto schedule = [this, groups = std::move(groups), shared_requests, results](std::function<void()> done) {
+        auto remaining = std::make_shared<std::atomic<std::size_t>>(groups.size());
+        for (const auto& [shard, indices] : groups) {
+            shard->Post([this, indices, shared_requests, results, remaining, done](GameShard& owner) {
+                for (std::size_t i : indices) {
+                    const MoveRequest& request = (*shared_requests)[i];
+                    (*results)[i] = ApplyMove(owner.FindGame(request.game_id), request.game_id, request.move,
+                                              request.color);
+                }
+                if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    done();
+                }
+            });
+        }
+    };
+    auto collect = [results]() { return std::move(*results); };
+    co_return co_await AwaitOn<std::vector<MoveResult>>(std::move(schedule), std::move(collect));
+}
+
+Task<std::vector<MoveResult>> Games_Manager::MakeMovesOnPool(std::vector<MoveRequest> requests) {
+    /*! \brief Batch shared by the pool tasks; results are read after the last task is done. */
+    struct Batch {
+        std::vector<MoveRequest> requests;        ///< Moves to apply.
+        std::vector<MoveResult> results;          ///< One result per move.
+        std::atomic<std::size_t> remaining{0};    ///< Groups still being validated.
+        std::mutex error_mutex;                   ///< Guards error.
+        std::exception_ptr error;                 ///< First exception thrown by a group.
+    };
+
+    // одна задача на партию: партии проверяются параллельно, ходы одной партии идут по порядку
+    std::unordered_map<int, std::vector<std::size_t>> groups;
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        groups[requests[i].game_id].push_back(i);
+    }
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(requests.size());
+    batch->requests = std::move(requests);
+    batch->remaining.store(groups.size(), std::memory_order_relaxed);
+
+    // лямбды именованные, как в ветке шардов: захваты не должны копироваться внутри co_await
+    auto schedule = [this, groups = std::move(groups), batch](std::function<void()> done) {
+        for (const auto& [id_game, indices] : groups) {
+            boost::asio::post(*move_pool_, [this, id_game = id_game, indices = indices, batch, done]() {
+                try {
+                    std::shared_ptr<RunningGame> game = GetGame(id_game);
+                    for (std::size_t i : indices) {
+                        const MoveRequest& request = batch->requests[i];
+                        batch->results[i] = ApplyMove(game.get(), id_game, request.move, request.color);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(batch->error_mutex);
+                    if (!batch->error) {
+                        batch->error = std::current_exception();
+                    }
+                }
+                if (batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    done();
+                }
+            });
+        }
+    };
+    auto collect = [batch]() {
+        if (batch->error) {
+            std::rethrow_exception(batch->error);
+        }
+        return std::move(batch->results);
+    };
+    co_return co_await AwaitOn<std::vector<MoveResult>>(std::move(schedule), std::move(collect));
+}
@@ -2,19 +2,66 @@
 // Created by Кирилл Грибанов  on 05/04/2025.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <boost/algorithm/string.hpp>
 #include <boost/asio.hpp>
 #include <boost/chrono.hpp>
 #include <boost/thread.hpp>
+#include <chrono>
 #include <condition_variable>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
-#include "DataBase.h"
 #include "Game.h"
+#include "Game_Events.h"
+#include "Game_Shard.h"
+#include "Metrics.h"
 #include "Run.h"
+#include "Storage.h"
+#include "Tracing.h"
+
+/*!
+ * \brief Selects how Games_Manager keeps its games.
+ */
+enum class RuntimeMode {
+    Shared,   ///< All games in one map, each protected by its own lock.
+    Sharded   ///< Games partitioned between per-core event loops by game ID.
+};
+
+/*!
+ * \brief Result of a move routed through Games_Manager.
+ */
+struct MoveResult {
+    bool found = false;        ///< The game exists.
+    bool accepted = false;     ///< The move was valid and applied.
+    std::string board_state;   ///< Board after an accepted move.
+    int ply = 0;               ///< Half-moves played after an accepted move.
+};
+
+/*!
+ * \brief One move of a batch submitted through Games_Manager::MakeMovesAsync().
+ */
+struct MoveRequest {
+    int game_id = 0;           ///< Game the move is made in.
+    std::string move;          ///< Move as a string.
+    std::string color;         ///< Player color ("White" or "Black").
+};
+
+/*!
+ * \brief Number of games held by Games_Manager, for monitoring.
+ */
+struct GameCounts {
+    std::size_t resident = 0;     ///< Games kept in memory.
+    std::size_t hibernated = 0;   ///< Games replaced by their snapshots.
+};
 
 /*!
  * \class idGenerator
@@ -41,28 +88,65 @@ private:
 /*!
  * \class Games_Manager
  * \brief Manages active chess games and handles interaction with the database.
+ * \details Games without activity for the hibernation period are replaced by a GameSnapshot (position
+ * and move log) written to the Storage; only their IDs stay in memory, and the snapshot is read back on
+ * their next move, so memory follows the number of active games rather than of all games ever started.
  */
 class Games_Manager {
 public:
     /*!
-     * \brief Constructor with database connection string.
-     * \param db_conn_str PostgreSQL connection string.
+     * \brief Constructor with the storage games are persisted to.
+     * \param storage Storage shared with the server; must not be null.
+     * \param mode Runtime mode; in `RuntimeMode::Sharded` games live on per-core event loops.
      */
-    explicit Games_Manager(const std::string& db_conn_str)
+    explicit Games_Manager(std::shared_ptr<Storage> storage, RuntimeMode mode = RuntimeMode::Shared,
+                           std::chrono::seconds hibernate_after = kDefaultHibernateAfter)
         : id_generator_(1),                 // Start ID generator from 1
-          database_(db_conn_str),           // Connect to the database
+          storage_(std::move(storage)),     // Storage shared with the server
           game_started_(false),             // Game initially not started
           table_(),                         // Initialize chess board
           start_game_(table_),              // Game depends on table
-          running_game_()                   // Default running game
-    {}
+          running_game_(),                  // Default running game
+          events_(mode == RuntimeMode::Sharded ? ShardedGames::DefaultShardCount() : 1),
+          shards_(mode == RuntimeMode::Sharded ? std::make_unique<ShardedGames>(*storage_, events_.Partitions())
+                                               : nullptr),
+          move_pool_(mode == RuntimeMode::Shared
+                         ? std::make_unique<boost::asio::thread_pool>(std::max(1u, std::thread::hardware_concurrency()))
+                         : nullptr),
+          hibernate_after_(hibernate_after)
+    {
+        if (hibernate_after_.count() > 0) {
+            hibernator_ = std::thread([this]() { HibernateLoop(); });
+        }
+    }
+
+    /*!
+     * \brief Stops the hibernation thread and waits for the move batches being validated.
+     */
+    ~Games_Manager();
+
+    static constexpr std::chrono::seconds kDefaultHibernateAfter{600};  ///< Default inactivity before a game is hibernated.
 
     /*!
      * \brief Generates a new game and returns its unique ID.
+     * \details Equivalent to CreateGame() followed by PersistGame().
      * \return New unique game ID.
      */
     int GenerateGames();
 
+    /*!
+     * \brief Creates a new game in memory only and returns its unique ID.
+     * \details Does not touch the database, so it is cheap enough to call inside a critical section.
+     * \return New unique game ID.
+     */
+    int CreateGame();
+
+    /*!
+     * \brief Writes the initial board of an already created game to the database.
+     * \param id_game Game ID returned by CreateGame().
+     */
+    void PersistGame(int id_game);
+
     /*!
      * \brief Returns a reference to the main chess table.
      * \return Reference to the Table object.
@@ -76,7 +160,8 @@ public:
     const Table& GetTable() const { return table_; }
 
     /*!
-     * \brief Retrieves a running game by its ID.
+     * \brief Retrieves a running game by its ID, rehydrating it if it was hibernated.
+     * \details Always returns nullptr in sharded mode, where games never leave their shard.
      * \param id_game Game ID.
      * \return Shared pointer to the RunningGame object, or nullptr if not found.
      */
@@ -89,9 +174,146 @@ public:
      */
     std::string GetBoardState(int id_game);
 
+    /*!
+     * \brief Applies a player's move to a game, on the owning shard in sharded mode.
+     * \param id_game Game ID.
+     * \param move Move as a string.
+     * \param color Player color ("White" or "Black").
+     * \return Whether the game was found, whether the move was accepted and the resulting board.
+     */
+    MoveResult MakeMove(int id_game, const std::string& move, const std::string& color);
+
+    /*!
+     * \brief Coroutine version of MakeMove(); in sharded mode the caller is resumed when the shard replies.
+     * \param id_game Game ID.
+     * \param move Move as a string.
+     * \param color Player color ("White" or "Black").
+     * \param trace Request the move belongs to; its stages are traced if it is sampled.
+     * \return Whether the game was found, whether the move was accepted and the resulting board.
+     */
+    Task<MoveResult> MakeMoveAsync(int id_game, std::string move, std::string color, TraceContext trace = {});
+
+    /*!
+     * \brief Applies a batch of moves, possibly for many games.
+     * \details The moves are validated off the calling thread and the caller is resumed once all of them
+     * are done. In sharded mode the moves are grouped by shard and every shard validates its group in
+     * parallel with the others; in shared mode they are grouped by game and the groups run in parallel
+     * on a pool of one thread per core. Moves of the same game are applied in batch order.
+     * \param requests Moves to apply.
+     * \return One result per request, in the same order.
+     */
+    Task<std::vector<MoveResult>> MakeMovesAsync(std::vector<MoveRequest> requests);
+
+    /*!
+     * \brief Returns the notification point where every accepted move is published.
+     */
+    GameEvents& Events() { return events_; }
+
+    /*!
+     * \brief Returns the latest state of a game, reading the game itself if its event channel was dropped.
+     * \details A hibernated game is rehydrated by the read, like by any other access.
+     * \param id_game Game ID.
+     * \return The state without a move, or std::nullopt if the game is unknown or has no moves yet.
+     */
+    Task<std::optional<GameUpdate>> LatestAsync(int id_game);
+
+    /*!
+     * \brief Hibernates every game that has been idle for at least \p idle_timeout.
+     * \details Called periodically by the hibernation thread. A game that a request is still using is skipped.
+     *          Snapshots are written to the storage without holding the games; until the write succeeds
+     *          they stay in memory and are written again on the next call.
+     * \param idle_timeout Inactivity after which a game is hibernated.
+     */
+    void HibernateIdle(std::chrono::steady_clock::duration idle_timeout);
+
+    /*!
+     * \brief Returns the games hibernated since the previous call and forgets them.
+     * \details Lets the server release what it keeps per game, e.g. idle sessions and persistence state.
+     */
+    std::vector<int> TakeHibernated();
+
+    /*!
+     * \brief Removes games for good, whether resident or hibernated, together with their event channels.
+     * \details For games nobody can reach anymore, e.g. after the last session of their players expired.
+     *          Blocks until the games are removed and their snapshots deleted from the storage.
+     * \param ids Game IDs.
+     */
+    void DropGames(const std::vector<int>& ids);
+
+    /*!
+     * \brief Returns the inactivity after which a game is hibernated; 0 if hibernation is disabled.
+     */
+    std::chrono::seconds HibernateAfter() const { return hibernate_after_; }
+
+    /*!
+     * \brief Counts resident and hibernated games; in sharded mode the counts are taken after each shard batch.
+     */
+    GameCounts CountGames();
+
+    /*!
+     * \brief Returns the number of tasks waiting in the inbox of every shard; empty in shared mode.
+     */
+    std::vector<std::size_t> ShardQueueDepths() const;
+
+    /*!
+     * \brief Returns the time spent parsing, validating and applying moves, including the wait for the game lock.
+     */
+    const LatencyHistogram& MoveValidation() const { return move_validation_; }
+
 private:
+    /*!
+     * \brief Applies a move to a game that is already locked or owned by the current shard and publishes it.
+     */
+    MoveResult ApplyMove(RunningGame* game, int id_game, const std::string& move, const std::string& color);
+
+    /*!
+     * \brief Rebuilds a hibernated game and makes it resident again (shared mode).
+     * \return The game, or nullptr if there is no such game.
+     */
+    std::shared_ptr<RunningGame> Rehydrate(int id_game);
+
+    /*!
+     * \brief Makes a game resident from its snapshot; game_mutex_ must be held exclusively.
+     */
+    std::shared_ptr<RunningGame> Revive(int id_game, const GameSnapshot& snapshot);
+
+    /*!
+     * \brief Shared-mode GetGame() that reads a hibernated game's snapshot on move_pool_, off the I/O thread.
+     */
+    Task<std::shared_ptr<RunningGame>> GetGameAsync(int id_game);
+
+    /*!
+     * \brief Writes snapshots to the storage.
+     * \return IDs of the stored games; empty if the write failed.
+     */
+    std::vector<int> StoreSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots);
+
+    /*!
+     * \brief Deletes the stored snapshots of games that were revived or dropped meanwhile, then calls OnHibernated().
+     * \param stored Games whose snapshots were written.
+     * \param hibernated Those of them that are still hibernated.
+     */
+    void FinishHibernation(const std::vector<int>& stored, const std::vector<int>& hibernated);
+
+    /*!
+     * \brief Deletes stored snapshots, logging a failure instead of throwing.
+     */
+    void DeleteSnapshots(const std::vector<int>& ids);
+
+    /*!
+     * \brief Shared-mode MakeMovesAsync(): validates the moves of every game as one task of move_pool_.
+     */
+    Task<std::vector<MoveResult>> MakeMovesOnPool(std::vector<MoveRequest> requests);
+
+    void HibernateLoop();
+
+    /*!
+     * \brief Records hibernated games for TakeHibernated() and drops their event channels.
+     */
+    void OnHibernated(const std::vector<int>& ids);
+
     idGenerator id_generator_;                             ///< Unique ID generator.
-    DataBase database_;                                    ///< Database interface.
+    std::shared_ptr<Storage> storage_;                     ///< Storage of players, games and board history.
 
     std::atomic<bool> game_started_;                       ///< Flag indicating if a game has started.
     Table table_;                                          ///< Shared chess table.
@@ -99,6 +321,20 @@ private:
     RunningGame running_game_;                              ///< RunningGame interface.
 
     std::map<int, std::shared_ptr<RunningGame>> games_;    ///< Map of active games.
-    std::mutex game_mutex_;                                ///< Mutex for thread-safe access to games.
+    std::shared_mutex game_mutex_;                         ///< Guards the games_ map only; each game has its own lock.
     std::condition_variable game_condition_;              ///< Condition variable to wait for game start.
+    GameEvents events_;                                    ///< Accepted moves, for long-polling readers; one channel map per shard.
+    std::unique_ptr<ShardedGames> shards_;                 ///< Per-core runtime, set only in sharded mode.
+    std::unique_ptr<boost::asio::thread_pool> move_pool_;  ///< Validates move batches, set only in shared mode.
+    std::map<int, GameSnapshot> hibernating_;              ///< Snapshots not yet written to the storage; guarded by game_mutex_.
+    std::unordered_set<int> hibernated_;                   ///< Games whose snapshot is in the storage; guarded by game_mutex_.
+    LatencyHistogram move_validation_;                     ///< Duration of RunningGame::HandleMove.
+
+    std::chrono::seconds hibernate_after_;                 ///< Inactivity before hibernation; 0 disables it.
+    std::thread hibernator_;                               ///< Periodically hibernates idle games.
+    std::mutex hibernator_mutex_;                          ///< Guards stopping_.
+    std::condition_variable hibernator_cv_;                ///< Wakes the hibernator on shutdown.
+    bool stopping_ = false;                                ///< Set by the destructor.
+    std::mutex recently_hibernated_mutex_;                 ///< Guards recently_hibernated_.
+    std::vector<int> recently_hibernated_;                 ///< Hibernated games not yet taken by TakeHibernated().
 };
\ No newline at end of file
@@ -0,0 +1,205 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Session_Store.h"
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+#if defined(__APPLE__)
+#include <stdlib.h>
+#else
+#include <sys/random.h>
+#endif
+
+namespace {
+
+/*!
+ * \brief Fills \p bytes from the operating system's cryptographic random generator.
+ * \throws std::runtime_error if the generator is unavailable.
+ */
+void FillRandom(std::array<std::uint8_t, 16>& bytes) {
+#if defined(__APPLE__)
+    arc4random_buf(bytes.data(), bytes.size());
+#else
+    std::size_t filled = 0;
+    while (filled < bytes.size()) {
+        ssize_t got = getrandom(bytes.data() + filled, bytes.size() - filled, 0);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("getrandom failed");
+        }
+        filled += static_cast<std::size_t>(got);
+    }
+#endif
+}
+
+/*!
+ * \brief Generates a random 128-bit token as 32 hex characters.
+ * \details Tokens are secrets, so every one is drawn from the OS generator: a seeded PRNG would
+ * let a client predict other players' tokens from a few of its own.
+ */
+std::string GenerateToken() {
+    static constexpr char kHex[] = "0123456789abcdef";
+
+    std::array<std::uint8_t, 16> bytes{};
+    FillRandom(bytes);
+
+    std::string token;
+    token.reserve(2 * bytes.size());
+    for (std::uint8_t byte : bytes) {
+        token += kHex[byte >> 4];
+        token += kHex[byte & 0xF];
+    }
+    return token;
+}
+
+std::chrono::steady_clock::rep Now() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+}
+
+bool TokensEqual(std::string_view expected, std::string_view given) {
+    // длина токена не секрет; содержимое сравниваем целиком, без выхода на первом несовпадении
+    if (expected.size() != given.size()) {
+        return false;
+    }
+    unsigned char difference = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        difference |= static_cast<unsigned char>(expected[i] ^ given[i]);
+    }
+    return difference == 0;
+}
+
+Session SessionStore::Create(int player_id, int game_id, const std::string& colour) {
+    Session session{player_id, game_id, colour, GenerateToken()};
+
+    Stripe& stripe = StripeOf(player_id);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    Entry& entry = stripe.sessions[player_id];
+    Leave(entry.session.game_id);
+    Join(game_id);
+    entry.session = session;
+    entry.last_active.store(Now(), std::memory_order_relaxed);
+    return session;
+}
+
+bool SessionStore::Assign(int player_id, int game_id, const std::string& colour) {
+    Stripe& stripe = StripeOf(player_id);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.sessions.find(player_id);
+    if (it == stripe.sessions.end()) {
+        return false;
+    }
+    Leave(it->second.session.game_id);
+    Join(game_id);
+    it->second.session.game_id = game_id;
+    it->second.session.colour = colour;
+    it->second.last_active.store(Now(), std::memory_order_relaxed);
+    return true;
+}
+
+std::optional<Session> SessionStore::Find(int player_id) const {
+    const Stripe& stripe = StripeOf(player_id);
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.sessions.find(player_id);
+    if (it == stripe.sessions.end()) {
+        return std::nullopt;
+    }
+    it->second.last_active.store(Now(), std::memory_order_relaxed);
+    return it->second.session;
+}
+
+void SessionStore::Erase(int player_id) {
+    Stripe& stripe = StripeOf(player_id);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+    auto it = stripe.sessions.find(player_id);
+    if (it == stripe.sessions.end()) {
+        return;
+    }
+    Leave(it->second.session.game_id);
+    stripe.sessions.erase(it);
+}
+
+std::vector<int> SessionStore::ExpireIdle(std::chrono::steady_clock::duration idle_timeout) {
+    return Expire(nullptr, idle_timeout);
+}
+
+std::vector<int> SessionStore::ExpireIdle(const std::vector<int>& game_ids,
+                                          std::chrono::steady_clock::duration idle_timeout) {
+    if (game_ids.empty()) {
+        return {};
+    }
+    std::unordered_set<int> games(game_ids.begin(), game_ids.end());
+    return Expire(&games, idle_timeout);
+}
+
+std::vector<int> SessionStore::Expire(const std::unordered_set<int>* game_ids,
+                                      std::chrono::steady_clock::duration idle_timeout) {
+    auto deadline = Now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(idle_timeout).count();
+    std::vector<int> orphaned;
+    // полосы обходятся по одной: остальные игроки в это время не ждут
+    for (auto& stripe : stripes_) {
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        for (auto it = stripe.sessions.begin(); it != stripe.sessions.end();) {
+            const Session& session = it->second.session;
+            bool selected = game_ids == nullptr || game_ids->count(session.game_id) != 0;
+            if (selected && it->second.last_active.load(std::memory_order_relaxed) <= deadline) {
+                if (Leave(session.game_id)) {
+                    orphaned.push_back(session.game_id);
+                }
+                it = stripe.sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return orphaned;
+}
+
+std::size_t SessionStore::Size() const {
+    std::size_t size = 0;
+    for (const auto& stripe : stripes_) {
+        std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+        size += stripe.sessions.size();
+    }
+    return size;
+}
+
+SessionStore::Stripe& SessionStore::StripeOf(int player_id) {
+    return stripes_[static_cast<unsigned>(player_id) % kStripes];
+}
+
+const SessionStore::Stripe& SessionStore::StripeOf(int player_id) const {
+    return stripes_[static_cast<unsigned>(player_id) % kStripes];
+}
+
+void SessionStore::Join(int game_id) {
+    // игрок без соперника ещё не держит никакой партии
+    if (game_id == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(players_mutex_);
+    ++players_[game_id];
+}
+
+bool SessionStore::Leave(int game_id) {
+    if (game_id == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(players_mutex_);
+    auto it = players_.find(game_id);
+    if (it == players_.end() || --it->second > 0) {
+        return false;
+    }
+    players_.erase(it);
+    return true;
+}
@@ -0,0 +1,134 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*! \brief
+ *   Everything the server needs to validate a player's request.
+ */
+struct Session {
+    int player_id = 0;   ///< Unique identifier of the player.
+    int game_id = 0;     ///< Game the player takes part in; 0 while waiting for an opponent.
+    std::string colour;  ///< "White" or "Black", as expected by RunningGame::HandleMove; empty while waiting.
+    std::string token;   ///< Secret handed out at /auth.
+};
+
+/*!
+ * \brief Compares a session token with the one sent by a client.
+ * \details Takes the same time wherever the first mismatching character is, so response times do not
+ * let a client guess a token character by character.
+ * \return true if the tokens are equal.
+ */
+bool TokensEqual(std::string_view expected, std::string_view given);
+
+/*!
+ * \class SessionStore
+ * \brief Authoritative in-memory table of player sessions.
+ * \details Sessions are created at `/auth` and looked up on every request, so the store is split
+ * into stripes, each behind its own `std::shared_mutex`. Lookups of different players never
+ * contend, and lookups of the same player only share a reader lock.
+ *
+ * Every lookup marks the session as active. Sessions without activity are removed by ExpireIdle(),
+ * and the store counts the sessions of every game, so the caller learns which games nobody can reach anymore.
+ */
+class SessionStore {
+public:
+    /*!
+     * \brief Creates a session with a fresh random token.
+     * \param player_id Player ID.
+     * \param game_id Game ID.
+     * \param colour Player colour ("White" or "Black").
+     * \return The stored session.
+     */
+    Session Create(int player_id, int game_id, const std::string& colour);
+
+    /*!
+     * \brief Assigns a game and colour to an existing session, e.g. once matchmaking pairs the player.
+     * \param player_id Player ID.
+     * \param game_id Game ID.
+     * \param colour Player colour ("White" or "Black").
+     * \return false if the player has no session.
+     */
+    bool Assign(int player_id, int game_id, const std::string& colour);
+
+    /*!
+     * \brief Finds the session of a player and marks it as active.
+     * \param player_id Player ID.
+     * \return The session, or std::nullopt if the player is not authenticated.
+     */
+    std::optional<Session> Find(int player_id) const;
+
+    /*!
+     * \brief Removes the session of a player.
+     * \param player_id Player ID.
+     */
+    void Erase(int player_id);
+
+    /*!
+     * \brief Removes every session that has not been looked up for at least \p idle_timeout.
+     * \param idle_timeout Inactivity after which a session is removed.
+     * \return Games that lost their last session.
+     */
+    std::vector<int> ExpireIdle(std::chrono::steady_clock::duration idle_timeout);
+
+    /*!
+     * \brief Removes the idle sessions of the given games only, e.g. of games that were just hibernated.
+     * \param game_ids Games whose sessions are checked.
+     * \param idle_timeout Inactivity after which a session is removed.
+     * \return Games that lost their last session.
+     */
+    std::vector<int> ExpireIdle(const std::vector<int>& game_ids, std::chrono::steady_clock::duration idle_timeout);
+
+    /*!
+     * \brief Returns the total number of sessions.
+     */
+    std::size_t Size() const;
+
+private:
+    static constexpr std::size_t kStripes = 64;  ///< Number of independently locked stripes.
+
+    /*! \brief A session and the time of its last lookup. */
+    struct Entry {
+        Session session;                                                   ///< The session itself.
+        mutable std::atomic<std::chrono::steady_clock::rep> last_active{0};  ///< Updated under a reader lock.
+    };
+
+    struct Stripe {
+        mutable std::shared_mutex mutex;               ///< Guards this stripe.
+        std::unordered_map<int, Entry> sessions;       ///< Sessions hashed to this stripe.
+    };
+
+    Stripe& StripeOf(int player_id);
+    const Stripe& StripeOf(int player_id) const;
+
+    std::vector<int> Expire(const std::unordered_set<int>* game_ids, std::chrono::steady_clock::duration idle_timeout);
+
+    /*!
+     * \brief Counts a session into a game; called with the session's stripe locked.
+     */
+    void Join(int game_id);
+
+    /*!
+     * \brief Counts a session out of a game; called with the session's stripe locked.
+     * \return true if the game has no sessions left.
+     */
+    bool Leave(int game_id);
+
+    std::array<Stripe, kStripes> stripes_;           ///< Session stripes.
+    std::mutex players_mutex_;                       ///< Guards players_; taken after a stripe lock.
+    std::unordered_map<int, int> players_;           ///< Number of sessions per game; games without sessions are absent.
+};
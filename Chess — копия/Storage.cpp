@@ -0,0 +1,84 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Storage.h"
+
+#include <stdexcept>
+
+#include "DataBase.h"
+#include "File_Storage.h"
+#include "Memory_Storage.h"
+
+std::string Storage::StoredColour(int user_id, const std::string& user_colour) {
+    if (user_colour.empty()) {
+        return user_id % 2 == 0 ? "black" : "white";
+    }
+    return user_colour == "Black" ? "black" : "white";
+}
+
+std::string BoardHistoryText(const std::vector<std::string>& states) {
+    // PostgreSQL берёт в кавычки элементы с пробелами, а в доске они есть всегда
+    std::string text = "{";
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        text += i > 0 ? ",\"" : "\"";
+        for (char c : states[i]) {
+            if (c == '"' || c == '\\') {
+                text.push_back('\\');
+            }
+            text.push_back(c);
+        }
+        text.push_back('"');
+    }
+    text.push_back('}');
+    return text;
+}
+
+std::string EncodeMoves(const std::vector<std::uint16_t>& moves) {
+    static constexpr char kHex[] = "0123456789abcdef";
+
+    std::string text;
+    text.reserve(4 * moves.size());
+    for (std::uint16_t move : moves) {
+        for (int shift = 12; shift >= 0; shift -= 4) {
+            text.push_back(kHex[(move >> shift) & 0xF]);
+        }
+    }
+    return text;
+}
+
+std::vector<std::uint16_t> DecodeMoves(std::string_view text) {
+    if (text.size() % 4 != 0) {
+        throw std::runtime_error("Malformed move log");
+    }
+    std::vector<std::uint16_t> moves;
+    moves.reserve(text.size() / 4);
+    for (std::size_t i = 0; i < text.size(); i += 4) {
+        std::uint16_t move = 0;
+        for (char c : text.substr(i, 4)) {
+            int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (digit < 0) {
+                throw std::runtime_error("Malformed move log");
+            }
+            move = static_cast<std::uint16_t>(move << 4 | digit);
+        }
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+std::shared_ptr<Storage> OpenStorage(const std::string& spec, std::size_t connections) {
+    if (spec == "postgres") {
+        return std::make_shared<DataBase>(DataBase::kDefaultConnection, connections);
+    }
+    if (spec.starts_with("postgres:")) {
+        return std::make_shared<DataBase>(spec.substr(std::string("postgres:").size()), connections);
+    }
+    if (spec == "memory") {
+        return std::make_shared<MemoryStorage>();
+    }
+    if (spec.starts_with("file:") && spec.size() > std::string("file:").size()) {
+        return std::make_shared<FileStorage>(spec.substr(std::string("file:").size()));
+    }
+    throw std::invalid_argument("Unknown storage " + spec + "; expected postgres[:CONNECTION], memory or file:PATH");
+}
@@ -0,0 +1,153 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Metrics.h"
+#include "Types/Game_types.h"
+
+/*!
+ * \class Storage
+ * \brief Durable state of the server: players, games, the board history of every game and the
+ * snapshots of hibernated games.
+ * \details Implemented by DataBase (PostgreSQL), MemoryStorage (lock-striped maps in this process) and
+ * FileStorage (an embedded SQLite file). Every implementation may be called from any thread. The
+ * method names and return codes are those of the original PostgreSQL class, so callers do not depend
+ * on the backend.
+ */
+class Storage {
+public:
+    virtual ~Storage() = default;
+
+    /*!
+     * \brief Stores a player.
+     * \param user_id Player ID.
+     * \param username Username of the player.
+     * \param game_id Game the player takes part in.
+     * \param user_colour Colour of the player ("White" or "Black"); if empty it is derived from the ID.
+     * \return 0 on success, 1 on error.
+     */
+    virtual int InsertIDToDataBase(int user_id, const std::string& username, int game_id,
+                                   const std::string& user_colour = "") = 0;
+
+    /*!
+     * \brief Deletes the players with the given username.
+     * \return 0 on success, 1 on error.
+     */
+    virtual int DeleteIDFromDataBase(const std::string& username) = 0;
+
+    /*!
+     * \brief Returns the game of a player, or -1 if the player is unknown.
+     */
+    virtual int GetGameIDByPlayerID(int user_id) = 0;
+
+    /*!
+     * \brief Creates a game whose history holds the initial board.
+     * \throws std::exception if the game cannot be stored.
+     */
+    virtual void CreateNewGame(int game_id, const std::string& initial_board) = 0;
+
+    /*!
+     * \brief Replaces the stored board of a game; unknown games are ignored.
+     * \throws std::exception if the board cannot be stored.
+     */
+    virtual void UpdateGameHistory(int game_id, const std::string& new_board_state) = 0;
+
+    /*!
+     * \brief Replaces the stored boards of several games at once.
+     * \param updates Pairs of game ID and new board state.
+     * \throws std::exception if the boards cannot be stored.
+     */
+    virtual void UpdateGameHistories(const std::vector<std::pair<int, std::string>>& updates) = 0;
+
+    /*!
+     * \brief Returns the board history of a game as a PostgreSQL text array, empty if the game is unknown.
+     * \throws std::exception if the storage cannot be read.
+     */
+    virtual std::string GetBoardHistory(int game_id) = 0;
+
+    /*!
+     * \brief Deletes a game together with its players and its snapshot.
+     * \return 0 on success, 1 on error.
+     */
+    virtual int DeleteGame(int game_id) = 0;
+
+    /*!
+     * \brief Stores the snapshots of hibernated games at once, replacing earlier snapshots of the same games.
+     * \param snapshots Pairs of game ID and snapshot.
+     * \throws std::exception if the snapshots cannot be stored.
+     */
+    virtual void SaveSnapshots(const std::vector<std::pair<int, GameSnapshot>>& snapshots) = 0;
+
+    /*!
+     * \brief Returns the snapshot of a hibernated game, or std::nullopt if none is stored.
+     * \throws std::exception if the storage cannot be read.
+     */
+    virtual std::optional<GameSnapshot> LoadSnapshot(int game_id) = 0;
+
+    /*!
+     * \brief Deletes the snapshots of games; games without a snapshot are ignored.
+     * \throws std::exception if the snapshots cannot be deleted.
+     */
+    virtual void DeleteSnapshots(const std::vector<int>& game_ids) = 0;
+
+    /*!
+     * \brief Returns the durations of storage operations; time spent waiting for a lock or a connection
+     * is not included.
+     */
+    const LatencyHistogram& RoundTrips() const { return round_trips_; }
+
+    /*!
+     * \brief Adds metrics specific to the backend to a scrape; the default adds none.
+     */
+    virtual void ReportMetrics(MetricsWriter& /*metrics*/) const {}
+
+protected:
+    /*!
+     * \brief Returns the stored colour of a player: "white" or "black".
+     * \param user_colour "White", "Black" or empty, in which case odd IDs play White, as in DataBase.
+     */
+    static std::string StoredColour(int user_id, const std::string& user_colour);
+
+    LatencyHistogram round_trips_;   ///< Durations of storage operations.
+};
+
+/*!
+ * \brief Formats board states the way PostgreSQL prints a text array.
+ * \details Used by the backends other than PostgreSQL, so `/status` answers the same on all of them.
+ */
+std::string BoardHistoryText(const std::vector<std::string>& states);
+
+/*!
+ * \brief Encodes the move log of a snapshot as text: four hex digits per move.
+ * \details Used by the backends that store snapshots in a table.
+ */
+std::string EncodeMoves(const std::vector<std::uint16_t>& moves);
+
+/*!
+ * \brief Decodes a move log written by EncodeMoves().
+ * \throws std::runtime_error if \p text is not such a log.
+ */
+std::vector<std::uint16_t> DecodeMoves(std::string_view text);
+
+constexpr std::size_t kDefaultDatabaseConnections = 8;  ///< Enough for the blocking pool and the persistence writer.
+
+/*!
+ * \brief Opens the storage described by \p spec.
+ * \param spec `postgres` (the default connection string of DataBase), `postgres:CONNECTION`, `memory`
+ *        or `file:PATH`.
+ * \param connections Size of the PostgreSQL connection pool; other backends ignore it.
+ * \throws std::invalid_argument for an unknown spec; std::runtime_error if the file cannot be opened.
+ */
+std::shared_ptr<Storage> OpenStorage(const std::string& spec,
+                                     std::size_t connections = kDefaultDatabaseConnections);
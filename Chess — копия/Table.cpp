@@ -7,9 +7,10 @@
 
 #include "Table.h"
 
-#include <iostream>
+#include <string_view>
 
 #include "Empty_Cell.h"
+#include "Logger.h"
 #include "Rook_Cell.h"
 
 auto& Table::operator[](size_t i) {
@@ -20,8 +21,8 @@ const auto& Table::operator[](size_t i) const {
   return body_[i];
 }
 
-Table::Table()
-    : body_(8, std::vector<std::shared_ptr<Cell>>(8))
+Table::Table(std::pmr::memory_resource* resource)
+    : body_(8, resource)
     , w_king_moves_(false)
     , b_king_moves_(false)
     , wl_rook_moves_(false)
@@ -34,33 +35,37 @@ Table::Table()
     ,
 
     currentTurn(Colour::WHITE) {
+  // строки получают ресурс доски через uses-allocator конструирование
+  for (auto& line : body_) {
+    line.resize(8);
+  }
 
-  body_[0][4].reset(new KingCell({0, 4}, Colour::WHITE));
-  body_[0][3].reset(new QueenCell({0, 3}, Colour::WHITE));
-  body_[0][2].reset(new BishopCell({0, 2}, Colour::WHITE));
-  body_[0][1].reset(new KnightCell({0, 1}, Colour::WHITE));
-  body_[0][0].reset(new RookCell({0, 0}, Colour::WHITE));
-  body_[0][7].reset(new RookCell({0, 7}, Colour::WHITE));
-  body_[0][6].reset(new KnightCell({0, 6}, Colour::WHITE));
-  body_[0][5].reset(new BishopCell({0, 5}, Colour::WHITE));
+  body_[0][4] = MakeCell<KingCell>({0, 4}, Colour::WHITE);
+  body_[0][3] = MakeCell<QueenCell>({0, 3}, Colour::WHITE);
+  body_[0][2] = MakeCell<BishopCell>({0, 2}, Colour::WHITE);
+  body_[0][1] = MakeCell<KnightCell>({0, 1}, Colour::WHITE);
+  body_[0][0] = MakeCell<RookCell>({0, 0}, Colour::WHITE);
+  body_[0][7] = MakeCell<RookCell>({0, 7}, Colour::WHITE);
+  body_[0][6] = MakeCell<KnightCell>({0, 6}, Colour::WHITE);
+  body_[0][5] = MakeCell<BishopCell>({0, 5}, Colour::WHITE);
   for (int i = 0; i < 8; ++i) {
-    body_[1][i].reset(new PawnCell({1, i}, Colour::WHITE));
+    body_[1][i] = MakeCell<PawnCell>({1, i}, Colour::WHITE);
   }
 
-  body_[7][4].reset(new KingCell({7, 4}, Colour::BLACK));
-  body_[7][3].reset(new QueenCell({7, 3}, Colour::BLACK));
-  body_[7][2].reset(new BishopCell({7, 2}, Colour::BLACK));
-  body_[7][1].reset(new KnightCell({7, 1}, Colour::BLACK));
-  body_[7][0].reset(new RookCell({7, 0}, Colour::BLACK));
-  body_[7][7].reset(new RookCell({7, 7}, Colour::BLACK));
-  body_[7][6].reset(new KnightCell({7, 6}, Colour::BLACK));
-  body_[7][5].reset(new BishopCell({7, 5}, Colour::BLACK));
+  body_[7][4] = MakeCell<KingCell>({7, 4}, Colour::BLACK);
+  body_[7][3] = MakeCell<QueenCell>({7, 3}, Colour::BLACK);
+  body_[7][2] = MakeCell<BishopCell>({7, 2}, Colour::BLACK);
+  body_[7][1] = MakeCell<KnightCell>({7, 1}, Colour::BLACK);
+  body_[7][0] = MakeCell<RookCell>({7, 0}, Colour::BLACK);
+  body_[7][7] = MakeCell<RookCell>({7, 7}, Colour::BLACK);
+  body_[7][6] = MakeCell<KnightCell>({7, 6}, Colour::BLACK);
+  body_[7][5] = MakeCell<BishopCell>({7, 5}, Colour::BLACK);
   for (int i = 0; i < 8; ++i) {
-    body_[6][i].reset(new PawnCell({6, i}, Colour::BLACK));
+    body_[6][i] = MakeCell<PawnCell>({6, i}, Colour::BLACK);
   }
   for (int i = 2; i < 6; ++i) {
     for (int j = 0; j < 8; ++j) {
-      body_[i][j].reset(new EmptyCell({i, j}));
+      body_[i][j] = MakeEmptyCell({i, j});
     }
   }
 }
@@ -76,7 +81,7 @@ bool Table::CheckColourToAtack(Coord from, Coord to, bool parametr) const {
 void Table::DoTurn(Coord from, Coord to) {
   if (CheckTurn(from, to) == TurnVerdict::correct) {
     body_[to.row][to.col] = body_[from.row][from.col];
-    body_[from.row][from.col].reset(new EmptyCell({from.row, from.col}));
+    body_[from.row][from.col] = MakeEmptyCell({from.row, from.col});
 
     auto& movedPiece = body_[to.row][to.col];
     if (movedPiece && movedPiece->Name() == PawnName) {
@@ -316,7 +321,7 @@ void Table::DoAttack(Coord from, Coord to) {
       }
     }
     std::swap(body_[from.row][from.col], body_[to.row][to.col]);
-    body_[from.row][from.col].reset(new EmptyCell({from.row, from.col}));
+    body_[from.row][from.col] = MakeEmptyCell({from.row, from.col});
   }
 }
 
@@ -336,7 +341,8 @@ Table::TurnVerdict Table::CheckTurn(Coord from, Coord to) const {
     return TurnVerdict::unnatural_move;
   }
 
-  std::cout << "done1\n";
+  CHESS_LOG_TRACE("move passed colour checks", {"from_row", from.row}, {"from_col", from.col}, {"to_row", to.row},
+                  {"to_col", to.col});
 
   if (toCell->Name() != EmptyName && !CheckAttack(from, to)) {
     return TurnVerdict::unnatural_move;
@@ -378,25 +384,30 @@ void Table::PromotePawn(Coord position, char promotionType)  // переписа
   switch (promotionType) {
     case 'Q':
     case 'q':
-      cell.reset(new QueenCell(position, colour));
+      cell = MakeCell<QueenCell>(position, colour);
       break;
     case 'R':
     case 'r':
-      cell.reset(new RookCell(position, colour));
+      cell = MakeCell<RookCell>(position, colour);
       break;
     case 'B':
     case 'b':
-      cell.reset(new BishopCell(position, colour));
+      cell = MakeCell<BishopCell>(position, colour);
       break;
     case 'N':
     case 'n':
-      cell.reset(new KnightCell(position, colour));
+      cell = MakeCell<KnightCell>(position, colour);
       break;
     default:
       throw std::invalid_argument("Invalid promotion type.");
   }
 
-  std::cout << "Pawn at (" << position.row << ", " << position.col << ") promoted to " << promotionType << ".\n";
+  CHESS_LOG_DEBUG("pawn promoted", {"row", position.row}, {"col", position.col},
+                  {"piece", std::string_view(&promotionType, 1)});
+}
+
+std::shared_ptr<Cell> Table::MakeEmptyCell(Coord coord) const {
+  return std::allocate_shared<EmptyCell>(body_.get_allocator(), coord);
 }
 
 std::shared_ptr<Cell>& Table::GetCell(int row, int col) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <deque>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -23,11 +24,14 @@
  * It tracks the positions of chess pieces, handles game logic, and evaluates game states
  * such as check, checkmate, stalemate, and valid moves. It provides methods to interact
  * with the board and manage player turns.
+ *
+ * The rows and all cells of the board are allocated from the memory resource given to the constructor,
+ * so a game can keep its whole board in its own arena. Copies keep the resource of the target board.
  */
 class Table {
 public:
-    using Line = std::vector<std::shared_ptr<Cell>>;
-    using Body = std::vector<Line>;
+    using Body = Board;
+    using Line = Body::value_type;
 
     /*!
      * \enum TurnVerdict
@@ -156,14 +160,15 @@ public:
      * \brief Returns a constant reference to the internal board representation.
      * \return The 2D vector representing the board.
      */
-    const std::vector<std::vector<std::shared_ptr<Cell>>>& getBoard() const {
+    const Body& getBoard() const {
         return body_;
     }
 
     /*!
-     * \brief Constructs an empty chessboard with initial settings.
+     * \brief Constructs a chessboard in the initial position.
+     * \param resource Memory resource for the rows and the cells of the board.
      */
-    Table();
+    explicit Table(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /*!
  * \brief Retrieves the color of the player whose turn it is.
@@ -172,6 +177,15 @@ public:
     Colour GetCurrentTurn() const;
 
 private:
+    /*!
+     * \brief Creates a cell in the memory resource of the board; the object and its control block share one block.
+     */
+    template <typename CellType>
+    std::shared_ptr<Cell> MakeCell(Coord coord, Colour colour) const {
+        return std::allocate_shared<CellType>(body_.get_allocator(), coord, colour);
+    }
+    std::shared_ptr<Cell> MakeEmptyCell(Coord coord) const;
+
     Coord WhiteKing() const;
     Coord BlackKing() const;
 
@@ -0,0 +1,126 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "My_Bounded_Queue.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+/*! \brief A full queue refuses TryPush() and PushFor(), and the high-water callback fires once per crossing. */
+void CapacityAndHighWater() {
+    BoundedBlockingQueue<int> queue(4);
+    std::size_t hits = 0;
+    queue.SetHighWaterMark(3, [&hits](std::size_t depth) {
+        Check(depth == 3, "callback receives the depth at the mark");
+        ++hits;
+    });
+
+    for (int i = 0; i < 4; ++i) {
+        Check(queue.TryPush(i), "TryPush() succeeds below capacity");
+    }
+    Check(!queue.TryPush(4), "TryPush() fails on a full queue");
+    Check(!queue.PushFor(4, std::chrono::milliseconds(10)), "PushFor() times out on a full queue");
+    Check(hits == 1, "high-water callback fires when the depth reaches the mark");
+
+    Check(queue.GetFor(std::chrono::milliseconds(10)) == 0, "GetFor() returns the oldest item");
+    Check(queue.Get() == 1, "Get() returns items in order");
+    Check(queue.TryPush(5), "TryPush() succeeds once there is space again");
+    Check(hits == 2, "high-water callback fires on the next crossing");
+
+    QueueStats stats = queue.GetStats();
+    Check(stats.depth == 3 && stats.max_depth == 4, "depth and max depth are counted");
+    Check(stats.pushed == 5 && stats.popped == 2 && stats.rejected == 2, "pushes, pops and rejections are counted");
+}
+
+/*! \brief Blocked producers make progress as the consumer drains; every item arrives exactly once. */
+void BackpressureDrain() {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+
+    BoundedBlockingQueue<int> queue(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.PushBack(p * kPerProducer + i);
+            }
+        });
+    }
+
+    std::vector<char> seen(kProducers * kPerProducer, 0);
+    std::vector<int> batch;
+    std::size_t received = 0;
+    while (received < seen.size()) {
+        batch.clear();
+        std::size_t taken = queue.DrainInto(batch, 32);
+        Check(taken != 0 && taken <= 32, "DrainInto() takes between one and max items");
+        Check(queue.Size() <= queue.Capacity(), "depth never exceeds the capacity");
+        for (int item : batch) {
+            Check(seen[item] == 0, "no item is delivered twice");
+            seen[item] = 1;
+        }
+        received += taken;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    Check(queue.GetStats().max_depth <= 64, "max depth stays within the capacity");
+}
+
+/*! \brief ShutDown() closes the queue, drops pending items and releases waiting consumers and producers. */
+void ShutDownWakesEveryone() {
+    BoundedBlockingQueue<int> full(1);
+    full.PushBack(0);
+    std::thread producer([&]() { Check(!full.PushBack(1), "blocked producer is refused"); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    full.ShutDown();
+    producer.join();
+    Check(full.Size() == 0, "pending items are discarded");
+    Check(!full.TryPush(2), "TryPush() fails after ShutDown()");
+
+    BoundedBlockingQueue<int> idle(4);
+    std::thread getter([&]() { Check(!idle.Get().has_value(), "consumer in Get() gets nullopt"); });
+    std::thread timed([&]() {
+        auto start = std::chrono::steady_clock::now();
+        Check(!idle.GetFor(std::chrono::seconds(10)).has_value(), "consumer in GetFor() gets nullopt");
+        Check(std::chrono::steady_clock::now() - start < std::chrono::seconds(5), "GetFor() returns without timing out");
+    });
+    std::thread drainer([&]() {
+        std::vector<int> batch;
+        Check(idle.DrainInto(batch, 8) == 0, "consumer in DrainInto() gets nothing");
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    idle.ShutDown();
+    getter.join();
+    timed.join();
+    drainer.join();
+}
+
+}
+
+int main() {
+    CapacityAndHighWater();
+    BackpressureDrain();
+    ShutDownWakesEveryone();
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "BoundedBlockingQueue: all checks passed\n";
+    return 0;
+}
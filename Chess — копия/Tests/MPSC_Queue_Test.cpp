@@ -0,0 +1,147 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "My_MPSC_Queue.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << '\n';
+        ++failures;
+    }
+}
+
+/*! \brief Item tagged with its producer, so per-producer order can be checked. */
+struct Item {
+    std::uint32_t producer = 0;   ///< Index of the pushing thread.
+    std::uint64_t sequence = 0;   ///< Position in that thread's pushes.
+};
+
+/*! \brief Several producers push concurrently; the consumer must see every item once, in push order per producer. */
+void MultiProducerDrain() {
+    constexpr std::uint32_t kProducers = 8;
+    constexpr std::uint64_t kPerProducer = 100000;
+
+    MPSCQueue<Item> queue;
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (std::uint64_t i = 0; i < kPerProducer; ++i) {
+                queue.PushBack({p, i});
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> next(kProducers, 0);
+    bool ordered = true;
+    std::uint64_t received = 0;
+    std::thread consumer([&]() {
+        std::vector<Item> batch;
+        while (queue.DrainInto(batch, 64) != 0) {
+            for (const Item& item : batch) {
+                ordered = ordered && item.sequence == next[item.producer];
+                next[item.producer] = item.sequence + 1;
+                ++received;
+            }
+            batch.clear();
+        }
+    });
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue.Close();
+    consumer.join();
+
+    Check(ordered, "items of one producer arrive in push order");
+    Check(received == kProducers * kPerProducer, "every pushed item is drained before the consumer stops");
+    Check(queue.Size() == 0, "queue is empty after the drain");
+}
+
+/*! \brief Close() races with producers; every push that returned true must reach the consumer. */
+void CloseWhilePushing() {
+    constexpr int kRounds = 200;
+    constexpr int kProducers = 4;
+
+    for (int round = 0; round < kRounds; ++round) {
+        MPSCQueue<int> queue;
+        std::atomic<std::uint64_t> accepted{0};
+        std::atomic<bool> started{false};
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&, p]() {
+                started.store(true);
+                while (queue.PushBack(p)) {
+                    accepted.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        std::uint64_t received = 0;
+        std::thread consumer([&]() {
+            while (queue.Get()) {
+                ++received;
+            }
+        });
+
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50 * (round % 10)));
+        queue.Close();
+
+        consumer.join();
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        if (received != accepted.load()) {
+            std::cerr << "round " << round << ": accepted " << accepted.load() << ", received " << received << '\n';
+            Check(false, "no accepted item is lost when Close() races with PushBack()");
+            return;
+        }
+    }
+}
+
+/*! \brief ShutDown() closes the queue, drops pending items and releases a parked consumer. */
+void ShutDownDiscards() {
+    MPSCQueue<int> queue;
+    for (int i = 0; i < 100; ++i) {
+        queue.PushBack(i);
+    }
+    queue.ShutDown();
+    Check(queue.IsClosed(), "ShutDown() closes the queue");
+    Check(!queue.PushBack(1), "PushBack() fails after ShutDown()");
+    Check(!queue.Get().has_value(), "pending items are discarded");
+
+    MPSCQueue<int> idle;
+    std::thread consumer([&]() { Check(!idle.Get().has_value(), "parked consumer gets nullopt"); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    idle.ShutDown();
+    consumer.join();
+}
+
+}
+
+int main() {
+    MultiProducerDrain();
+    CloseWhilePushing();
+    ShutDownDiscards();
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "MPSCQueue: all checks passed\n";
+    return 0;
+}
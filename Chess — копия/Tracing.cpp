@@ -0,0 +1,189 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "Tracing.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+constexpr auto kWritePeriod = std::chrono::milliseconds(500);   ///< How often buffered spans are written.
+constexpr int kRequestIdBits = 40;                              ///< Low bits of an ID: per-thread counter.
+
+/*! \brief Appends a JSON string literal with the necessary escapes. */
+void AppendJsonString(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+}
+
+Tracer& Tracer::Instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::~Tracer() {
+    Stop();
+}
+
+void Tracer::Start(const std::string& path, std::uint32_t sample_every) {
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    if (file_ != nullptr) {
+        throw std::runtime_error("Tracing is already started");
+    }
+    file_ = std::fopen(path.c_str(), "w");
+    if (file_ == nullptr) {
+        throw std::runtime_error("Cannot open trace file " + path);
+    }
+    std::fputs("[\n", file_);
+    first_event_ = true;
+    names_written_ = 0;
+    stopping_ = false;
+    writer_ = std::thread([this]() { Loop(); });
+    sample_every_.store(std::max<std::uint32_t>(sample_every, 1), std::memory_order_relaxed);
+}
+
+void Tracer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        if (file_ == nullptr) {
+            return;
+        }
+        sample_every_.store(0, std::memory_order_relaxed);
+        stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    writer_.join();
+
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    // спаны запросов, начатых до остановки, ещё могли прийти
+    WriteBuffered();
+    std::fputs("\n]\n", file_);
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+TraceContext Tracer::BeginRequest() {
+    thread_local std::uint64_t counter = 0;
+    TraceContext trace;
+    trace.request_id = static_cast<std::uint64_t>(ThreadNumber()) << kRequestIdBits | ++counter;
+    std::uint32_t sample_every = sample_every_.load(std::memory_order_relaxed);
+    trace.sampled = sample_every != 0 && counter % sample_every == 0;
+    return trace;
+}
+
+void Tracer::Record(const TraceContext& trace, const char* name, const char* category,
+                    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    if (!trace.sampled) {
+        return;
+    }
+    Shard& shard = shards_[MetricShard()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.events.size() >= kMaxBuffered) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    shard.events.push_back({trace.request_id, name, category, start, end, ThreadNumber()});
+}
+
+void Tracer::NameThread(std::string name) {
+    std::lock_guard<std::mutex> lock(names_mutex_);
+    thread_names_.emplace_back(ThreadNumber(), std::move(name));
+}
+
+const TraceContext& Tracer::Current() {
+    return CurrentMutable();
+}
+
+TraceContext& Tracer::CurrentMutable() {
+    thread_local TraceContext current;
+    return current;
+}
+
+std::uint32_t Tracer::ThreadNumber() {
+    static std::atomic<std::uint32_t> next{1};
+    thread_local std::uint32_t number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+void Tracer::Loop() {
+    std::unique_lock<std::mutex> lock(file_mutex_);
+    while (!stop_cv_.wait_for(lock, kWritePeriod, [this]() { return stopping_; })) {
+        WriteBuffered();
+    }
+}
+
+void Tracer::WriteBuffered() {
+    std::string out;
+    auto separate = [&]() {
+        out += first_event_ ? "" : ",\n";
+        first_event_ = false;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(names_mutex_);
+        for (; names_written_ < thread_names_.size(); ++names_written_) {
+            const auto& [thread, name] = thread_names_[names_written_];
+            separate();
+            out += R"({"name":"thread_name","ph":"M","pid":1,"tid":)" + std::to_string(thread) + R"(,"args":{"name":)";
+            AppendJsonString(out, name);
+            out += "}}";
+        }
+    }
+
+    std::vector<Event> events;
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            events.swap(shard.events);
+        }
+        for (const Event& event : events) {
+            // chrome://tracing ждёт микросекунды; дробная часть сохраняет наносекунды
+            auto ts = std::chrono::duration<double, std::micro>(event.start - epoch_).count();
+            auto dur = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+            char numbers[96];
+            std::snprintf(numbers, sizeof(numbers), R"(,"ph":"X","ts":%.3f,"dur":%.3f,"pid":1,"tid":%u)", ts, dur,
+                          event.thread);
+            separate();
+            out += R"({"name":)";
+            AppendJsonString(out, event.name);
+            out += R"(,"cat":)";
+            AppendJsonString(out, event.category);
+            out += numbers;
+            out += R"(,"args":{"request_id":)" + std::to_string(event.request_id) + "}}";
+        }
+        events.clear();
+    }
+
+    std::uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0) {
+        auto ts = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch_).count();
+        char instant[160];
+        std::snprintf(instant, sizeof(instant),
+                      R"({"name":"spans dropped","ph":"i","s":"g","ts":%.3f,"pid":1,"tid":0,"args":{"count":%llu}})",
+                      ts, static_cast<unsigned long long>(dropped));
+        separate();
+        out += instant;
+    }
+
+    if (!out.empty()) {
+        std::fwrite(out.data(), 1, out.size(), file_);
+        std::fflush(file_);
+    }
+}
@@ -0,0 +1,197 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Metrics.h"
+
+/*! \brief
+ *   Identity of the request a piece of work belongs to.
+ */
+struct TraceContext {
+    std::uint64_t request_id = 0;   ///< Unique ID of the request; 0 outside of requests.
+    bool sampled = false;           ///< Spans of the request are recorded.
+};
+
+/*!
+ * \class Tracer
+ * \brief Records timed spans of sampled requests and exports them in the Chrome trace-event format.
+ * \details Every request gets an ID from BeginRequest(); one request in `sample_every` is sampled.
+ * Spans of sampled requests are stored as complete events ("ph":"X") with steady-clock timestamps
+ * and appended to the output file by a background thread twice a second. The file is a JSON array
+ * that can be opened in chrome://tracing or Perfetto; the `request_id` argument of an event ties
+ * together the spans a request left on different threads.
+ *
+ * Spans are buffered in the shards used by the metrics, each under its own mutex, so recording
+ * contends only with threads sharing the shard. While tracing is off, or for requests that are
+ * not sampled, a span costs a branch and no clock read.
+ */
+class Tracer {
+public:
+    /*! \brief Returns the process-wide tracer. */
+    static Tracer& Instance();
+
+    /*! \brief Stops tracing and closes the output file. */
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /*!
+     * \brief Opens the output file and starts sampling; call before serving requests.
+     * \param path Output file; it is overwritten.
+     * \param sample_every Trace one request in this many; 1 traces every request.
+     * \throws std::runtime_error if the file cannot be opened or tracing is already on.
+     */
+    void Start(const std::string& path, std::uint32_t sample_every);
+
+    /*! \brief Writes the buffered spans, terminates the JSON array and closes the file. */
+    void Stop();
+
+    /*!
+     * \brief Assigns an ID to a new request and decides whether it is sampled.
+     * \details IDs are unique within the process and are generated without shared state.
+     */
+    TraceContext BeginRequest();
+
+    /*!
+     * \brief Records a span of a sampled request; does nothing for other requests.
+     * \param trace Request the span belongs to.
+     * \param name Span name; must stay valid until the tracer is stopped, e.g. a string literal.
+     * \param category Span category, e.g. "http", "game" or "db"; same lifetime as \p name.
+     * \param start Start of the span.
+     * \param end End of the span.
+     */
+    void Record(const TraceContext& trace, const char* name, const char* category,
+                std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    /*!
+     * \brief Names the calling thread in the trace viewer.
+     */
+    void NameThread(std::string name);
+
+    /*!
+     * \brief Returns the request the calling thread is working on, as set by TraceScope.
+     */
+    static const TraceContext& Current();
+
+private:
+    friend class TraceScope;
+
+    struct Event {
+        std::uint64_t request_id;                       ///< Request of the span.
+        const char* name;                               ///< Span name.
+        const char* category;                           ///< Span category.
+        std::chrono::steady_clock::time_point start;    ///< Start.
+        std::chrono::steady_clock::time_point end;      ///< End.
+        std::uint32_t thread;                           ///< Number of the recording thread.
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;              ///< Guards events.
+        std::vector<Event> events;     ///< Spans not written yet.
+    };
+
+    static constexpr std::size_t kMaxBuffered = 1 << 16;   ///< Spans kept per shard between writes.
+
+    Tracer() = default;
+
+    static TraceContext& CurrentMutable();
+    static std::uint32_t ThreadNumber();
+    void Loop();
+    void WriteBuffered();
+
+    std::atomic<std::uint32_t> sample_every_{0};    ///< 0 while tracing is off.
+    std::array<Shard, kMetricShards> shards_;       ///< Buffered spans.
+    std::atomic<std::uint64_t> dropped_{0};         ///< Spans lost to full buffers.
+    const std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();  ///< Zero of timestamps.
+
+    std::mutex names_mutex_;                                        ///< Guards thread_names_.
+    std::vector<std::pair<std::uint32_t, std::string>> thread_names_;  ///< Named threads.
+
+    std::mutex file_mutex_;                  ///< Guards the fields below.
+    std::condition_variable stop_cv_;        ///< Wakes the writer thread on Stop().
+    std::FILE* file_ = nullptr;              ///< Output file while tracing is on.
+    bool first_event_ = true;                ///< No event has been written to the file yet.
+    std::size_t names_written_ = 0;          ///< Thread names already written.
+    bool stopping_ = false;                  ///< Set by Stop().
+    std::thread writer_;                     ///< Writer thread.
+};
+
+/*!
+ * \class TraceScope
+ * \brief Makes a request current on this thread for a synchronous section of work.
+ * \details Used where a request hops threads: a shard task or a blocking-pool job opens a scope with
+ * the context captured by the caller. Must not be held across a co_await, since other coroutines
+ * run on the same thread in between.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const TraceContext& trace) : previous_(Tracer::CurrentMutable()) {
+        Tracer::CurrentMutable() = trace;
+    }
+    ~TraceScope() { Tracer::CurrentMutable() = previous_; }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceContext previous_;   ///< Context restored on destruction.
+};
+
+/*!
+ * \class TraceSpan
+ * \brief Times a stage of a request from construction until End() or destruction.
+ */
+class TraceSpan {
+public:
+    /*!
+     * \brief Starts a span of the request current on this thread.
+     * \param name Span name; a string literal.
+     * \param category Span category; a string literal.
+     */
+    explicit TraceSpan(const char* name, const char* category = "game")
+        : TraceSpan(Tracer::Current(), name, category) {}
+
+    /*!
+     * \brief Starts a span of the given request; use in coroutines instead of TraceScope.
+     */
+    TraceSpan(const TraceContext& trace, const char* name, const char* category)
+        : trace_(trace), name_(name), category_(category) {
+        if (trace_.sampled) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceSpan() { End(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /*! \brief Ends the span early; later calls do nothing. */
+    void End() {
+        if (trace_.sampled) {
+            Tracer::Instance().Record(trace_, name_, category_, start_, std::chrono::steady_clock::now());
+            trace_.sampled = false;
+        }
+    }
+
+private:
+    TraceContext trace_;                             ///< Request of the span.
+    const char* name_;                               ///< Span name.
+    const char* category_;                           ///< Span category.
+    std::chrono::steady_clock::time_point start_;    ///< Start, if sampled.
+};
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -53,4 +54,16 @@ namespace std {
          */
         size_t operator()(Coord coord) const;
     };
-}
\ No newline at end of file
+}
+
+/*!
+ * \brief Compact form of a hibernated game: its position and the moves that led to it.
+ * \details A game is rebuilt by replaying the moves on a fresh board, which also restores castling
+ * rights and the side to move. Each move takes two bytes: `from | to << 6`, with squares numbered
+ * `row * 8 + col` as on the board.
+ */
+struct GameSnapshot {
+    int ply = 0;                        ///< Number of half-moves played.
+    std::string board_state;            ///< Board when the game was hibernated; checked after the replay.
+    std::vector<std::uint16_t> moves;   ///< Applied moves in order.
+};
@@ -0,0 +1,238 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#include "WebSocket_Server.h"
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+constexpr std::size_t kMaxPendingFrames = 256;  ///< A client this far behind is disconnected.
+constexpr auto kHandshakeTimeout = std::chrono::seconds(10);  ///< Time for the upgrade request and a rejection.
+
+/*!
+ * \brief Returns the value of a query parameter of a request target, or an empty string.
+ */
+std::string QueryParam(std::string_view target, std::string_view name) {
+    auto query_start = target.find('?');
+    if (query_start == std::string_view::npos) {
+        return {};
+    }
+
+    std::string_view query = target.substr(query_start + 1);
+    while (!query.empty()) {
+        auto end = query.find('&');
+        std::string_view pair = query.substr(0, end);
+        auto eq = pair.find('=');
+        if (eq != std::string_view::npos && pair.substr(0, eq) == name) {
+            return std::string(pair.substr(eq + 1));
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        query.remove_prefix(end + 1);
+    }
+    return {};
+}
+
+/*!
+ * \brief Serializes an update into a compact JSON frame.
+ */
+std::string ToJson(const GameUpdate& update) {
+    std::string move;
+    move.reserve(update.move.size());
+    for (char c : update.move) {
+        if (c == '"' || c == '\\') {
+            move += '\\';
+        }
+        if (static_cast<unsigned char>(c) >= 0x20) {
+            move += c;
+        }
+    }
+
+    return "{\"game\":" + std::to_string(update.game_id) +
+           ",\"ply\":" + std::to_string(update.ply) +
+           ",\"move\":\"" + move + "\"" +
+           ",\"clock_ms\":" + std::to_string(update.think_time.count()) + "}";
+}
+
+/*!
+ * \class EventSession
+ * \brief One WebSocket connection subscribed to one game.
+ * \details All handlers of a session run on its strand; updates published from other threads are
+ * posted onto it and written one frame at a time.
+ */
+class EventSession : public std::enable_shared_from_this<EventSession> {
+public:
+    EventSession(tcp::socket&& socket, WebSocketServer& server)
+        : ws_(std::move(socket)), server_(server) {}
+
+    ~EventSession() {
+        if (subscription_ != 0) {
+            server_.Events().Unsubscribe(game_id_, subscription_);
+        }
+    }
+
+    void Start() {
+        net::dispatch(ws_.get_executor(), [self = shared_from_this()]() {
+            // до авторизации клиент не должен держать сокет сколько угодно
+            beast::get_lowest_layer(self->ws_).expires_after(kHandshakeTimeout);
+            http::async_read(beast::get_lowest_layer(self->ws_), self->buffer_, self->upgrade_,
+                             [self](beast::error_code ec, std::size_t) { self->OnUpgradeRequest(ec); });
+        });
+    }
+
+private:
+    void OnUpgradeRequest(beast::error_code ec) {
+        if (ec || !websocket::is_upgrade(upgrade_)) {
+            return;
+        }
+
+        std::string target(upgrade_.target());
+        std::string player = QueryParam(target, "id_player");
+        std::optional<int> game_id;
+        try {
+            game_id = server_.AuthorizePlayer(std::stoi(player), QueryParam(target, "token"));
+        } catch (const std::exception&) {
+            game_id = std::nullopt;
+        }
+        if (!game_id) {
+            auto res = std::make_shared<http::response<http::string_body>>(http::status::forbidden, upgrade_.version());
+            res->set(http::field::content_type, "text/plain");
+            res->body() = "You are not authenticated!";
+            res->prepare_payload();
+            http::async_write(beast::get_lowest_layer(ws_), *res,
+                              [self = shared_from_this(), res](beast::error_code, std::size_t) {
+                                  beast::error_code ignored;
+                                  beast::get_lowest_layer(self->ws_).socket().shutdown(tcp::socket::shutdown_send, ignored);
+                              });
+            return;
+        }
+
+        game_id_ = *game_id;
+        // дальше тайм-ауты и пинги ведёт сам WebSocket-поток
+        beast::get_lowest_layer(ws_).expires_never();
+        ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+        ws_.async_accept(upgrade_, [self = shared_from_this()](beast::error_code ec) { self->OnAccept(ec); });
+    }
+
+    void OnAccept(beast::error_code ec) {
+        if (ec) {
+            return;
+        }
+
+        std::weak_ptr<EventSession> weak = shared_from_this();
+        subscription_ = server_.Events().Subscribe(game_id_, [weak](const GameUpdate& update) {
+            if (auto self = weak.lock()) {
+                self->Push(ToJson(update));
+            }
+        });
+
+        if (auto latest = server_.Events().Latest(game_id_)) {
+            Push(ToJson(*latest));
+        }
+        DoRead();
+    }
+
+    /*! \brief Queues a frame; safe to call from any thread. */
+    void Push(std::string frame) {
+        net::post(ws_.get_executor(), [self = shared_from_this(), frame = std::move(frame)]() mutable {
+            if (self->outbox_.size() >= kMaxPendingFrames) {
+                beast::get_lowest_layer(self->ws_).close();
+                return;
+            }
+            self->outbox_.push_back(std::move(frame));
+            if (self->outbox_.size() == 1) {
+                self->DoWrite();
+            }
+        });
+    }
+
+    void DoWrite() {
+        ws_.text(true);
+        ws_.async_write(net::buffer(outbox_.front()),
+                        [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                            if (ec) {
+                                return;
+                            }
+                            self->outbox_.pop_front();
+                            if (!self->outbox_.empty()) {
+                                self->DoWrite();
+                            }
+                        });
+    }
+
+    /*! \brief Reads and discards client frames so pings, pongs and close frames are handled. */
+    void DoRead() {
+        ws_.async_read(buffer_, [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            if (ec) {
+                return;
+            }
+            self->buffer_.consume(self->buffer_.size());
+            self->DoRead();
+        });
+    }
+
+    websocket::stream<beast::tcp_stream> ws_;         ///< WebSocket stream on a strand.
+    WebSocketServer& server_;                         ///< Owning server.
+    beast::flat_buffer buffer_;                       ///< Read buffer.
+    http::request<http::string_body> upgrade_;        ///< HTTP upgrade request.
+    std::deque<std::string> outbox_;                  ///< Frames waiting to be written.
+    int game_id_ = 0;                                 ///< Subscribed game.
+    int subscription_ = 0;                            ///< Subscription ID in GameEvents.
+};
+
+}
+
+WebSocketServer::WebSocketServer(GameEvents& events, Authorize authorize, unsigned short port, std::size_t threads)
+    : events_(events)
+    , authorize_(std::move(authorize))
+    , thread_count_(threads == 0 ? 1 : threads)
+    , ioc_(static_cast<int>(thread_count_))
+    , acceptor_(net::make_strand(ioc_), tcp::endpoint(tcp::v4(), port)) {}
+
+WebSocketServer::~WebSocketServer() {
+    Stop();
+}
+
+void WebSocketServer::Start() {
+    DoAccept();
+    for (std::size_t i = 0; i < thread_count_; ++i) {
+        threads_.emplace_back([this]() { ioc_.run(); });
+    }
+    std::cout << "✅ WebSocket events at ws://localhost:" << acceptor_.local_endpoint().port() << "/events\n";
+}
+
+void WebSocketServer::Stop() {
+    ioc_.stop();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+void WebSocketServer::DoAccept() {
+    acceptor_.async_accept(net::make_strand(ioc_), [this](beast::error_code ec, tcp::socket socket) {
+        if (!ec) {
+            std::make_shared<EventSession>(std::move(socket), *this)->Start();
+        }
+        if (acceptor_.is_open()) {
+            DoAccept();
+        }
+    });
+}
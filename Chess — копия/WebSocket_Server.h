@@ -0,0 +1,82 @@
+//
+// Created by Кирилл Грибанов  on 19/10/2026.
+//
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Game_Events.h"
+
+/*!
+ * \class WebSocketServer
+ * \brief Pushes move events of a game to subscribed players over WebSocket.
+ * \details A client connects to `ws://host:port/events?id_player=<id>&token=<token>`. Once the
+ * player is authorized, every accepted move of the player's game is sent as a compact JSON text
+ * frame: `{"game":1,"ply":3,"move":"e7 e5","clock_ms":1200}`, where `clock_ms` is the time the
+ * move took. All connections are served by a fixed number of Boost.Asio I/O threads.
+ */
+class WebSocketServer {
+public:
+    /*!
+     * \brief Checks a player's credentials.
+     * \details Receives the player ID and token from the connection URL and returns the player's
+     * game ID, or std::nullopt to refuse the connection.
+     */
+    using Authorize = std::function<std::optional<int>(int player_id, const std::string& token)>;
+
+    /*!
+     * \brief Creates the server without starting it.
+     * \param events Source of move events; must outlive the server.
+     * \param authorize Credential check for new connections.
+     * \param port TCP port to listen on.
+     * \param threads Number of I/O threads.
+     */
+    WebSocketServer(GameEvents& events, Authorize authorize, unsigned short port, std::size_t threads = 2);
+
+    /*!
+     * \brief Stops the server and joins the I/O threads.
+     */
+    ~WebSocketServer();
+
+    WebSocketServer(const WebSocketServer&) = delete;
+    WebSocketServer& operator=(const WebSocketServer&) = delete;
+
+    /*!
+     * \brief Starts accepting connections on background I/O threads.
+     */
+    void Start();
+
+    /*!
+     * \brief Stops accepting connections and closes all sessions.
+     */
+    void Stop();
+
+    /*!
+     * \brief Returns the source of move events.
+     */
+    GameEvents& Events() { return events_; }
+
+    /*!
+     * \brief Checks a player's credentials with the callback given at construction.
+     */
+    std::optional<int> AuthorizePlayer(int player_id, const std::string& token) const {
+        return authorize_(player_id, token);
+    }
+
+private:
+    void DoAccept();
+
+    GameEvents& events_;                          ///< Source of move events.
+    Authorize authorize_;                         ///< Credential check.
+    std::size_t thread_count_;                    ///< Number of I/O threads.
+    boost::asio::io_context ioc_;                 ///< I/O context shared by all connections.
+    boost::asio::ip::tcp::acceptor acceptor_;     ///< Listening socket.
+    std::vector<std::thread> threads_;            ///< I/O threads.
+};
@@ -1,3 +1,5 @@
+import asyncio
+
 import requests
 from telegram import Update
 from telegram.ext import ApplicationBuilder, CommandHandler, ContextTypes, MessageHandler, filters
@@ -18,6 +20,7 @@ async def start(update: Update, context: ContextTypes.DEFAULT_TYPE):
         "После этого можешь делать ходы, просто отправляя их в формате e2e4.\n"
         "Команды:\n"
         "/status — показать текущий ход\n"
+        "/board — показать доску\n"
     )
 
 async def auth(update: Update, context: ContextTypes.DEFAULT_TYPE):
@@ -26,7 +29,8 @@ async def auth(update: Update, context: ContextTypes.DEFAULT_TYPE):
     @param update Telegram update object containing user message.
     @param context Context containing command arguments.
     @details Expects /auth <username> <email>. Retrieves player ID and color from the server
-             and stores them in a local dictionary for future moves.
+             and stores them in a local dictionary for future moves. If no opponent is found
+             in time, the user is asked to authenticate again.
     """
     if len(context.args) < 2:
         await update.message.reply_text("Используй команду так: /auth <username> <email>")
@@ -37,19 +41,53 @@ async def auth(update: Update, context: ContextTypes.DEFAULT_TYPE):
 
     try:
         r = requests.post(f"{SERVER_URL}/auth", data={"username": username, "email": email})
-        if r.status_code == 200:
+        if r.status_code == 200 and "ID = " not in r.text:
+            # The server found no opponent in time and withdrew the request
+            await update.message.reply_text("Соперник не найден, повторите /auth")
+        elif r.status_code == 200:
             content = r.text
             # Extract player ID and color from server response
             player_id = int(content.split("ID = ")[1].split(",")[0])
             color = content.split("Color = ")[1].strip()
             # Store player data for future moves
-            player_data[update.effective_user.id] = {"player_id": player_id, "color": color}
+            token = r.headers.get("X-Session-Token", "")
+            player_data[update.effective_user.id] = {"player_id": player_id, "color": color, "token": token}
+            context.application.create_task(watch_moves(context, update.effective_chat.id, player_id, token))
             await update.message.reply_text(f"✅ {content}")
         else:
             await update.message.reply_text(f"Server error: {r.text}")
     except Exception as e:
         await update.message.reply_text(f"Connection error: {e}")
 
+async def watch_moves(context: ContextTypes.DEFAULT_TYPE, chat_id: int, player_id: int, token: str):
+    """
+    @brief Forwards moves made in the player's game to the chat.
+    @param context Context used to send messages.
+    @param chat_id Chat the notifications are sent to.
+    @param player_id Player ID returned by /auth.
+    @param token Session token returned by /auth.
+    @details Long-polls the /wait endpoint: each request is parked by the server until the game
+             advances past the last seen ply, so the bot does not have to poll /status.
+    """
+    since_ply = 0
+    while True:
+        try:
+            r = await asyncio.to_thread(
+                requests.get, f"{SERVER_URL}/wait",
+                params={"id_player": player_id, "since_ply": since_ply, "token": token}, timeout=35)
+        except Exception:
+            await asyncio.sleep(5)
+            continue
+
+        content = r.text
+        if content.startswith("Ply = "):
+            since_ply = int(content.split("Ply = ")[1].split(",")[0])
+            await context.bot.send_message(chat_id=chat_id, text=content)
+        elif content.startswith("Waiting for an opponent"):
+            await asyncio.sleep(2)
+        elif not content.startswith("No new moves"):
+            return
+
 async def move(update: Update, context: ContextTypes.DEFAULT_TYPE):
     """
     @brief Sends a player's move to the server.
@@ -67,7 +105,8 @@ async def move(update: Update, context: ContextTypes.DEFAULT_TYPE):
     move_text = update.message.text.strip()
 
     try:
-        r = requests.post(f"{SERVER_URL}/move", data={"id_player": player_id, "move": move_text})
+        r = requests.post(f"{SERVER_URL}/move",
+                          data={"id_player": player_id, "move": move_text, "token": player_info.get("token", "")})
         await update.message.reply_text(r.text)
     except Exception as e:
         await update.message.reply_text(f"Connection error: {e}")
@@ -88,7 +127,7 @@ async def status(update: Update, context: ContextTypes.DEFAULT_TYPE):
     player_id = player_info["player_id"]
 
     try:
-        r = requests.get(f"{SERVER_URL}/status", params={"id_player": player_id})
+        r = requests.get(f"{SERVER_URL}/status", params={"id_player": player_id, "token": player_info.get("token", "")})
         await update.message.reply_text(r.text)
     except Exception as e:
         await update.message.reply_text(f"Connection error: {e}")
@@ -98,11 +137,20 @@ async def board(update: Update, context: ContextTypes.DEFAULT_TYPE):
     @brief Retrieves the full chessboard state from the server.
     @param update Telegram update object.
     @param context Context (not used directly).
-    @details Queries the /board endpoint to display the current board for all users.
+    @details Queries the /board endpoint and sends the board of the user's game as a PNG image.
+             Users who are not authenticated get the starting position.
     """
+    params = {}
+    if update.effective_user.id in player_data:
+        player_info = player_data[update.effective_user.id]
+        params = {"id_player": player_info["player_id"], "token": player_info.get("token", "")}
+
     try:
-        r = requests.get(f"{SERVER_URL}/board")
-        await update.message.reply_text(r.text)
+        r = requests.get(f"{SERVER_URL}/board", params=params)
+        if r.headers.get("Content-Type", "").startswith("image/"):
+            await update.message.reply_photo(r.content)
+        else:
+            await update.message.reply_text(r.text)
     except Exception as e:
         await update.message.reply_text(f"Connection error: {e}")
 
@@ -115,6 +163,7 @@ app = ApplicationBuilder().token(TOKEN).build()
 app.add_handler(CommandHandler("start", start))
 app.add_handler(CommandHandler("auth", auth))
 app.add_handler(CommandHandler("status", status))
+app.add_handler(CommandHandler("board", board))
 
 # Register handler for normal text moves
 app.add_handler(MessageHandler(filters.TEXT & ~filters.COMMAND, move))